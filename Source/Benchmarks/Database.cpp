@@ -0,0 +1,274 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <celero/Celero.h>
+#include <vector>
+#include "Container/meta/database.h"
+#include "Container/meta/database_builder.h"
+#include "Container/dense_map.h"
+#include "Container/vector.h"
+#include "Core/WorkerPool.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+
+struct transform {};
+struct mesh {};
+struct bounds {};
+
+// Trivially copyable, but not trivial: relocated as raw memory anyway.
+struct mat4
+{
+	mat4() : m{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f } {}
+	float m[16];
+};
+
+struct aabb
+{
+	aabb() : min{}, max{} {}
+	float min[3];
+	float max[3];
+};
+
+using database_t = A3D::db::database_builder<uint32_t>::data<transform, mat4>::data<mesh, uint32_t>::data<bounds, aabb>::build;
+
+// Growth of database up to million rows: new chunks are added, rows already stored are never moved.
+class GrowFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 16000, 256000, 1000000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		count = static_cast<uint32_t>(experiment_value->Value);
+	}
+
+	uint32_t count;
+};
+
+// Single table reallocated twice bigger on overflow, every growth copies all rows by raw memcpy.
+BASELINE_F(Grow, Realloc, GrowFixture, SAMPLES, ITERATIONS)
+{
+	constexpr size_t row_size = database_t::data_table::row_sizeof;
+	uint8_t* data = nullptr;
+	uint32_t capacity = 0;
+	for (uint32_t size = 0; size < count; ++size)
+	{
+		if (size == capacity)
+		{
+			capacity = capacity > 0 ? capacity * 2 : database_t::chunk_rows;
+			uint8_t* new_data = static_cast<uint8_t*>(malloc(capacity * row_size));
+			if (data != nullptr)
+				memcpy(new_data, data, size * row_size);
+			free(data);
+			data = new_data;
+		}
+		memset(data + size * row_size, 0, row_size);
+	}
+	celero::DoNotOptimizeAway(data);
+	free(data);
+}
+
+BENCHMARK_F(Grow, Database, GrowFixture, SAMPLES, ITERATIONS)
+{
+	database_t db;
+	for (uint32_t i = 0; i < count; ++i)
+		db.insert();
+	celero::DoNotOptimizeAway(db.size());
+}
+
+// The same columns kept by hand: dense map per column, handles of rows and rows of keys.
+struct HandWrittenSoA
+{
+	uint32_t insert()
+	{
+		const uint32_t row = transforms.insert(mat4());
+		meshes.insert(0);
+		bounds.insert(aabb());
+
+		uint32_t key;
+		if (!free_keys.empty())
+		{
+			key = free_keys.back();
+			free_keys.pop_back();
+			rows[key] = row;
+		}
+		else
+		{
+			key = rows.size();
+			rows.push_back(row);
+		}
+		handles.insert(key);
+		return key;
+	}
+
+	void erase(uint32_t key)
+	{
+		const uint32_t row = rows[key];
+		transforms.erase(row);
+		meshes.erase(row);
+		bounds.erase(row);
+		if (handles.erase(row) != handles.INVALID_KEY)
+			rows[handles[row]] = row;
+		free_keys.push_back(key);
+	}
+
+	A3D::dense_map<uint32_t, mat4> transforms;
+	A3D::dense_map<uint32_t, uint32_t> meshes;
+	A3D::dense_map<uint32_t, aabb> bounds;
+	A3D::dense_map<uint32_t, uint32_t> handles;
+	A3D::vector<uint32_t, uint32_t> rows;
+	A3D::vector<uint32_t, uint32_t> free_keys;
+};
+
+// Spawns rows and despawns half of them in scattered order.
+class EraseFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 1000, 4000, 16000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		count = static_cast<uint32_t>(experiment_value->Value);
+		erased.clear();
+		for (uint32_t i = 0; i < count / 2; ++i)
+			erased.push_back(static_cast<uint32_t>((i * 2654435761u) % count));
+		std::sort(erased.begin(), erased.end());
+		erased.erase(std::unique(erased.begin(), erased.end()), erased.end());
+		for (size_t i = erased.size(); i > 1; --i)
+			std::swap(erased[i - 1], erased[(i * 40503u) % i]);
+	}
+
+	void tearDown() override
+	{
+		erased.clear();
+	}
+
+	uint32_t count;
+	std::vector<uint32_t> erased;
+};
+
+BASELINE_F(Erase, DenseMap, EraseFixture, SAMPLES, ITERATIONS)
+{
+	HandWrittenSoA soa;
+	for (uint32_t i = 0; i < count; ++i)
+		soa.insert();
+	for (uint32_t key : erased)
+		soa.erase(key);
+	celero::DoNotOptimizeAway(soa.rows.size());
+}
+
+BENCHMARK_F(Erase, Database, EraseFixture, SAMPLES, ITERATIONS)
+{
+	database_t db;
+	for (uint32_t i = 0; i < count; ++i)
+		db.insert();
+	for (uint32_t key : erased)
+		db.erase(key);
+	celero::DoNotOptimizeAway(db.size());
+}
+
+BENCHMARK_F(Erase, DatabaseBatch, EraseFixture, SAMPLES, ITERATIONS)
+{
+	database_t db;
+	for (uint32_t i = 0; i < count; ++i)
+		db.insert();
+	std::vector<uint32_t> keys(erased);
+	db.erase_batch(keys.data(), static_cast<uint32_t>(keys.size()));
+	celero::DoNotOptimizeAway(db.size());
+}
+
+// Column sweep of server tick: transforms are moved, bounds are recomputed from them.
+class SweepFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 16000, 256000, 1000000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		db.clear();
+		for (int64_t i = 0; i < experiment_value->Value; ++i)
+			db.insert();
+	}
+
+	static void Update(mat4& tr, aabb& box)
+	{
+		tr.m[12] += 0.1f;
+		box.min[0] = tr.m[12] - 1.0f;
+		box.max[0] = tr.m[12] + 1.0f;
+	}
+
+	database_t db;
+	A3D::WorkerPool pool;
+};
+
+BASELINE_F(Sweep, ForEach, SweepFixture, SAMPLES, ITERATIONS)
+{
+	db.for_each<transform, bounds>(&SweepFixture::Update);
+}
+
+// The same sweep over aligned column spans, so that compiler vectorizes loop with aligned loads.
+BENCHMARK_F(Sweep, ColumnSpan, SweepFixture, SAMPLES, ITERATIONS)
+{
+	for (uint32_t chunk = 0; chunk < db.chunks_count(); ++chunk)
+	{
+		const std::span<mat4> transforms = db.column<transform>(chunk);
+		const std::span<aabb> boxes = db.column<bounds>(chunk);
+		for (size_t i = 0; i < transforms.size(); ++i)
+			Update(transforms[i], boxes[i]);
+	}
+}
+
+BENCHMARK_F(Sweep, ParallelForEach, SweepFixture, SAMPLES, ITERATIONS)
+{
+	db.parallel_for_each<transform, bounds>(pool, &SweepFixture::Update);
+}
+
+BENCHMARK_F(Sweep, ParallelReduce, SweepFixture, SAMPLES, ITERATIONS)
+{
+	const float max = db.parallel_reduce<bounds>(
+		pool,
+		0.0f,
+		[](float& partial, const aabb& box) { partial = std::max(partial, box.max[0]); },
+		[](float result, float partial) { return std::max(result, partial); });
+	celero::DoNotOptimizeAway(max);
+}
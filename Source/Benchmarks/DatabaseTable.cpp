@@ -0,0 +1,95 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <celero/Celero.h>
+#include "Container/meta/database_table.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+
+// Trivially copyable, but not trivial: relocated as raw memory anyway.
+struct mat4
+{
+	mat4() : m{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f } {}
+	float m[16];
+};
+
+struct aabb
+{
+	aabb() : min{}, max{} {}
+	float min[3];
+	float max[3];
+};
+
+using types_t = A3D::meta::types_list_builder<mat4, uint32_t, aabb>::type;
+using table_t = A3D::db::database_table<types_t, uint32_t>;
+
+// Relocation of filled table into new memory block, as done by table growth.
+class RelocateFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 1000, 16000, 256000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		count = static_cast<uint32_t>(experiment_value->Value);
+		src_mem = static_cast<uint8_t*>(malloc(table_t::memory_size(count)));
+		dst_mem = static_cast<uint8_t*>(malloc(table_t::memory_size(count)));
+		src.allocate(src_mem, count);
+		dst.allocate(dst_mem, count);
+		src.create_n(count);
+	}
+
+	void tearDown() override
+	{
+		free(src_mem);
+		free(dst_mem);
+	}
+
+	table_t src;
+	table_t dst;
+	uint8_t* src_mem;
+	uint8_t* dst_mem;
+	uint32_t count;
+};
+
+// Single memcpy per column, lower bound for relocation cost.
+BASELINE_F(Relocate, Memcpy, RelocateFixture, SAMPLES, ITERATIONS)
+{
+	memcpy(&dst.front<mat4, types_t>(), &src.front<mat4, types_t>(), count * sizeof(mat4));
+	memcpy(&dst.front<uint32_t, types_t>(), &src.front<uint32_t, types_t>(), count * sizeof(uint32_t));
+	memcpy(&dst.front<aabb, types_t>(), &src.front<aabb, types_t>(), count * sizeof(aabb));
+	celero::DoNotOptimizeAway(dst_mem);
+}
+
+BENCHMARK_F(Relocate, MoveN, RelocateFixture, SAMPLES, ITERATIONS)
+{
+	dst.move_n(src, count);
+	celero::DoNotOptimizeAway(dst_mem);
+}
@@ -0,0 +1,105 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <celero/Celero.h>
+#include <unordered_map>
+#include "Container/flat_map.h"
+#include "Container/string_hash.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+
+using flat_map = A3D::flat_map<A3D::string_hash, uint32_t>;
+using unordered_map = std::unordered_map<A3D::string_hash, uint32_t>;
+
+// Package file names index, keyed by name hashes the same way as resource caches.
+class NameIndexFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 1000, 5000, 20000, 100000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		char buffer[64];
+		const uint32_t count = static_cast<uint32_t>(experiment_value->Value);
+		names.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "Textures/Environment/texture_%u.dds", i);
+			names[i] = buffer;
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			flat.emplace(names[i], i);
+			unordered.emplace(names[i], i);
+		}
+	}
+
+	void tearDown() override
+	{
+		flat.clear();
+		unordered.clear();
+	}
+
+	std::vector<A3D::string_hash> names;
+	flat_map flat;
+	unordered_map unordered;
+};
+
+BASELINE_F(NameIndexBuild, UnorderedMap, NameIndexFixture, SAMPLES, ITERATIONS)
+{
+	unordered_map map;
+	for (uint32_t i = 0; i < names.size(); ++i)
+		map.emplace(names[i], i);
+	celero::DoNotOptimizeAway(map.size());
+}
+
+BENCHMARK_F(NameIndexBuild, FlatMap, NameIndexFixture, SAMPLES, ITERATIONS)
+{
+	flat_map map;
+	for (uint32_t i = 0; i < names.size(); ++i)
+		map.emplace(names[i], i);
+	celero::DoNotOptimizeAway(map.size());
+}
+
+BASELINE_F(NameIndexFind, UnorderedMap, NameIndexFixture, SAMPLES, ITERATIONS)
+{
+	uint32_t sum = 0;
+	for (const A3D::string_hash& name : names)
+		sum += unordered.find(name)->second;
+	celero::DoNotOptimizeAway(sum);
+}
+
+BENCHMARK_F(NameIndexFind, FlatMap, NameIndexFixture, SAMPLES, ITERATIONS)
+{
+	uint32_t sum = 0;
+	for (const A3D::string_hash& name : names)
+		sum += flat.find(name)->second;
+	celero::DoNotOptimizeAway(sum);
+}
@@ -0,0 +1,104 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <celero/Celero.h>
+#include "Core/DefaultAllocator.h"
+#include "Core/HugePageAllocator.h"
+#include "System/VirtualMemory.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+static constexpr uint32_t LOOKUPS = 1 << 20;
+
+// Bounding sphere sized item.
+struct Sphere
+{
+	float center[3];
+	float radius;
+};
+
+// Random reads over large column, so that most of them miss TLB with regular pages.
+// Run it under perf stat -e dTLB-load-misses to compare both allocators.
+class GatherFixture : public celero::TestFixture
+{
+public:
+	GatherFixture() :
+		huge_alloc(&default_alloc)
+	{
+	}
+
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t megabytes : { 16, 64, 256 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(megabytes));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		size = static_cast<size_t>(experiment_value->Value) * 1024 * 1024;
+		count = static_cast<uint32_t>(size / sizeof(Sphere));
+
+		regular = static_cast<Sphere*>(default_alloc.Allocate(size));
+		huge = static_cast<Sphere*>(huge_alloc.Allocate(size));
+		memset(regular, 0, size);
+		memset(huge, 0, size);
+
+		printf("Huge pages back %zu of %zu bytes.\n", A3D_GetHugePagesResidentSize(huge, size), size);
+	}
+
+	void tearDown() override
+	{
+		default_alloc.Deallocate(regular);
+		huge_alloc.Deallocate(huge);
+	}
+
+	static float Gather(const Sphere* spheres, uint32_t count)
+	{
+		uint32_t index = 1;
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < LOOKUPS; ++i)
+		{
+			index = index * 1664525u + 1013904223u;
+			sum += spheres[index % count].radius;
+		}
+		return sum;
+	}
+
+	A3D::DefaultAllocator default_alloc;
+	A3D::HugePageAllocator huge_alloc;
+	Sphere* regular;
+	Sphere* huge;
+	size_t size;
+	uint32_t count;
+};
+
+BASELINE_F(Gather, Default, GatherFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(Gather(regular, count));
+}
+
+BENCHMARK_F(Gather, HugePages, GatherFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(Gather(huge, count));
+}
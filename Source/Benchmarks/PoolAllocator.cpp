@@ -0,0 +1,92 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <celero/Celero.h>
+#include <vector>
+#include "Core/DefaultAllocator.h"
+#include "Core/PoolAllocator.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+
+// Mixed small allocations churn: every round releases every other block and allocates it again.
+class ChurnFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 1000, 10000, 100000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		const size_t count = static_cast<size_t>(experiment_value->Value);
+		sizes.resize(count);
+		blocks.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			sizes[i] = 8 + (i * 2654435761u) % 248;
+	}
+
+	void tearDown() override
+	{
+		sizes.clear();
+		blocks.clear();
+	}
+
+	void Churn(A3D::IAllocator& alloc)
+	{
+		for (size_t i = 0; i < sizes.size(); ++i)
+			blocks[i] = alloc.Allocate(sizes[i]);
+		for (int round = 0; round < 4; ++round)
+		{
+			for (size_t i = round & 1; i < sizes.size(); i += 2)
+				alloc.Deallocate(blocks[i]);
+			for (size_t i = round & 1; i < sizes.size(); i += 2)
+				blocks[i] = alloc.Allocate(sizes[i]);
+		}
+		for (void* block : blocks)
+			alloc.Deallocate(block);
+		celero::DoNotOptimizeAway(blocks.data());
+	}
+
+	std::vector<size_t> sizes;
+	std::vector<void*> blocks;
+};
+
+BASELINE_F(Churn, Default, ChurnFixture, SAMPLES, ITERATIONS)
+{
+	A3D::DefaultAllocator alloc;
+	Churn(alloc);
+}
+
+BENCHMARK_F(Churn, Pool, ChurnFixture, SAMPLES, ITERATIONS)
+{
+	A3D::PoolAllocator alloc;
+	Churn(alloc);
+}
+
+BENCHMARK_F(Churn, PoolThreadCache, ChurnFixture, SAMPLES, ITERATIONS)
+{
+	A3D::PoolAllocator alloc(true);
+	Churn(alloc);
+}
@@ -0,0 +1,99 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <celero/Celero.h>
+#include "Container/sparse_map.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 100000;
+
+using sparse_map = A3D::sparse_map<uint32_t, uint32_t>;
+
+// Map is filled with experiment value keys, then single cell is released and taken again.
+// Insertion cost must not depend on map size, wherever released cell is placed.
+// Interleaved case keeps one item at the tail, so that every second insert searches past a filled hole.
+class SparseMapFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count = 1000; count <= 1000000; count *= 10)
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		count = static_cast<uint32_t>(experiment_value->Value);
+		for (uint32_t i = 0; i < count; ++i)
+			map.insert(i);
+		tail_key = map.insert(count);
+		random_state = 0x9E3779B9;
+	}
+
+	void tearDown() override
+	{
+		map.clear();
+	}
+
+	uint32_t reinsert(uint32_t key)
+	{
+		map.erase(key);
+		return map.insert(key);
+	}
+
+	uint32_t next_random_key()
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		return random_state % count;
+	}
+
+	sparse_map map;
+	uint32_t count;
+	uint32_t tail_key;
+	uint32_t random_state;
+};
+
+BASELINE_F(SparseMapInsert, ReinsertFirst, SparseMapFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(reinsert(0));
+}
+
+BENCHMARK_F(SparseMapInsert, ReinsertLast, SparseMapFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(reinsert(count - 1));
+}
+
+BENCHMARK_F(SparseMapInsert, ReinsertRandom, SparseMapFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(reinsert(next_random_key()));
+}
+
+BENCHMARK_F(SparseMapInsert, InterleaveFirstAndTail, SparseMapFixture, SAMPLES, ITERATIONS)
+{
+	map.erase(0);
+	map.erase(tail_key);
+	celero::DoNotOptimizeAway(map.insert(0));
+	tail_key = map.insert(count);
+}
@@ -0,0 +1,132 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <celero/Celero.h>
+#include <unordered_map>
+#include "Container/string_hash.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 100000;
+static constexpr int LOOKUP_ITERATIONS = 1000;
+static constexpr size_t MAX_LENGTH = 256;
+static constexpr uint32_t NAMES_COUNT = 10000;
+
+// Previous byte at a time Jenkins one-at-a-time hash, kept as baseline.
+struct JenkinsHash
+{
+	size_t operator()(const char* str) const noexcept
+	{
+		size_t hash = 0;
+		while (*str)
+		{
+			hash += (size_t)*str;
+			hash += (hash << 10Lu);
+			hash ^= (hash << 6Lu);
+			++str;
+		}
+		hash += (hash << 3Lu);
+		hash ^= (hash << 11Lu);
+		hash += (hash << 15Lu);
+		return hash;
+	}
+};
+
+struct WordHash
+{
+	size_t operator()(const char* str) const noexcept { return static_cast<size_t>(A3D::hash_string(str)); }
+};
+
+// Throughput of hashing single string of experiment value length.
+class StringHashFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t length = 8; length <= (int64_t)MAX_LENGTH; length *= 2)
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(length));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		const size_t length = static_cast<size_t>(experiment_value->Value);
+		for (size_t i = 0; i < length; ++i)
+			text[i] = static_cast<char>('a' + i % 26);
+		text[length] = '\0';
+	}
+
+	char text[MAX_LENGTH + 1];
+};
+
+BASELINE_F(StringHash, Jenkins, StringHashFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(JenkinsHash{}(text));
+}
+
+BENCHMARK_F(StringHash, Word, StringHashFixture, SAMPLES, ITERATIONS)
+{
+	celero::DoNotOptimizeAway(WordHash{}(text));
+}
+
+// Lookup of similar resource names in hash table: poor distribution shows up as longer bucket chains.
+template <typename Hasher>
+class NameLookupFixture : public celero::TestFixture
+{
+public:
+	void setUp(const celero::TestFixture::ExperimentValue* const) override
+	{
+		for (uint32_t i = 0; i < NAMES_COUNT; ++i)
+		{
+			snprintf(names[i], sizeof(names[i]), "Data/Textures/texture_%u.dds", i);
+			map.emplace(Hasher{}(names[i]), i);
+		}
+	}
+
+	void tearDown() override
+	{
+		map.clear();
+	}
+
+	uint32_t lookup_all() const
+	{
+		uint32_t ret = 0;
+		for (uint32_t i = 0; i < NAMES_COUNT; ++i)
+			ret += map.find(Hasher{}(names[i]))->second;
+		return ret;
+	}
+
+	// Keys are already hashes, so table spreads them with identity.
+	std::unordered_map<size_t, uint32_t> map;
+	char names[NAMES_COUNT][40];
+};
+
+BASELINE_F(NameLookup, Jenkins, NameLookupFixture<JenkinsHash>, SAMPLES, LOOKUP_ITERATIONS)
+{
+	celero::DoNotOptimizeAway(lookup_all());
+}
+
+BENCHMARK_F(NameLookup, Word, NameLookupFixture<WordHash>, SAMPLES, LOOKUP_ITERATIONS)
+{
+	celero::DoNotOptimizeAway(lookup_all());
+}
@@ -0,0 +1,106 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <celero/Celero.h>
+#include <thread>
+#include <vector>
+#include "Core/DefaultAllocator.h"
+#include "Core/PoolAllocator.h"
+#include "Core/ThreadCacheAllocator.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+static constexpr size_t BLOCKS_PER_THREAD = 10000;
+
+// Small allocations churn on several threads at once, every thread does the same amount of work.
+// Time grows with threads count when allocator serializes them.
+class ThreadsFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		const int64_t max_threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() : 1;
+		for (int64_t threads = 1; threads <= max_threads; threads *= 2)
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(threads));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		threads_count = static_cast<size_t>(experiment_value->Value);
+		sizes.resize(BLOCKS_PER_THREAD);
+		for (size_t i = 0; i < BLOCKS_PER_THREAD; ++i)
+			sizes[i] = 8 + (i * 2654435761u) % 248;
+	}
+
+	void tearDown() override
+	{
+		sizes.clear();
+	}
+
+	void Churn(A3D::IAllocator& alloc)
+	{
+		std::vector<void*> blocks(BLOCKS_PER_THREAD);
+		for (size_t i = 0; i < BLOCKS_PER_THREAD; ++i)
+			blocks[i] = alloc.Allocate(sizes[i]);
+		for (int round = 0; round < 4; ++round)
+		{
+			for (size_t i = round & 1; i < BLOCKS_PER_THREAD; i += 2)
+				alloc.Deallocate(blocks[i]);
+			for (size_t i = round & 1; i < BLOCKS_PER_THREAD; i += 2)
+				blocks[i] = alloc.Allocate(sizes[i]);
+		}
+		for (void* block : blocks)
+			alloc.Deallocate(block);
+		celero::DoNotOptimizeAway(blocks.data());
+	}
+
+	void Run(A3D::IAllocator& alloc)
+	{
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < threads_count; ++i)
+			threads.emplace_back([this, &alloc] { Churn(alloc); });
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	size_t threads_count;
+	std::vector<size_t> sizes;
+};
+
+BASELINE_F(Threads, Default, ThreadsFixture, SAMPLES, ITERATIONS)
+{
+	A3D::DefaultAllocator alloc;
+	Run(alloc);
+}
+
+BENCHMARK_F(Threads, ThreadCache, ThreadsFixture, SAMPLES, ITERATIONS)
+{
+	A3D::ThreadCacheAllocator alloc;
+	Run(alloc);
+}
+
+BENCHMARK_F(Threads, PoolThreadCache, ThreadsFixture, SAMPLES, ITERATIONS)
+{
+	A3D::PoolAllocator alloc(true);
+	Run(alloc);
+}
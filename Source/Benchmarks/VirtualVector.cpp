@@ -0,0 +1,67 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <celero/Celero.h>
+#include "Container/vector.h"
+#include "Container/virtual_vector.h"
+
+CELERO_MAIN
+
+static constexpr int SAMPLES = 30;
+static constexpr int ITERATIONS = 10;
+
+// Matrix sized item, the same as global transform of scene node.
+struct Transform
+{
+	float m[16];
+};
+
+class PushBackFixture : public celero::TestFixture
+{
+public:
+	std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> getExperimentValues() const override
+	{
+		std::vector<std::shared_ptr<celero::TestFixture::ExperimentValue>> ret;
+		for (int64_t count : { 1000, 10000, 100000, 1000000 })
+			ret.push_back(std::make_shared<celero::TestFixture::ExperimentValue>(count));
+		return ret;
+	}
+
+	void setUp(const celero::TestFixture::ExperimentValue* const experiment_value) override
+	{
+		count = static_cast<uint32_t>(experiment_value->Value);
+	}
+
+	uint32_t count;
+};
+
+BASELINE_F(PushBack, Vector, PushBackFixture, SAMPLES, ITERATIONS)
+{
+	A3D::vector<uint32_t, Transform> vec;
+	for (uint32_t i = 0; i < count; ++i)
+		vec.push_back({ { static_cast<float>(i) } });
+	celero::DoNotOptimizeAway(vec.back().m[0]);
+}
+
+BENCHMARK_F(PushBack, VirtualVector, PushBackFixture, SAMPLES, ITERATIONS)
+{
+	A3D::virtual_vector<uint32_t, Transform> vec;
+	for (uint32_t i = 0; i < count; ++i)
+		vec.push_back({ { static_cast<float>(i) } });
+	celero::DoNotOptimizeAway(vec.back().m[0]);
+}
@@ -23,7 +23,7 @@
 
 namespace A3D
 {
-using MaterialHandle = uint16_t;
+using MaterialHandle = uint32_t;
 
 struct Material
 {
@@ -20,7 +20,7 @@
 #define COMMON_MODEL_H
 
 #include <bgfx/bgfx.h>
-#include "Container/vector.h"
+#include "Container/small_vector.h"
 
 namespace A3D
 {
@@ -40,7 +40,7 @@ struct MeshPrimitive
 
 struct Model
 {
-	vector<uint32_t, MeshGroup> groups;
+	small_vector<uint32_t, MeshGroup, 4> groups;
 };
 } // namespace A3D
 
@@ -23,7 +23,7 @@
 
 namespace A3D
 {
-using TechniqueHandle = uint16_t;
+using TechniqueHandle = uint32_t;
 
 struct Technique
 {
@@ -0,0 +1,412 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_ATOM_TABLE_H
+#define CONTAINER_ATOM_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include "hash_bytes.h"
+#include "noexcept_allocator.h"
+
+namespace A3D
+{
+// Id of string interned in atom table. Equal strings of the same table always have equal atoms,
+// so that atoms are compared and hashed as plain integers.
+class atom
+{
+public:
+	using value_type = uint32_t;
+
+	static constexpr value_type INVALID_ID = std::numeric_limits<value_type>::max();
+
+	constexpr atom() noexcept :
+		id_(INVALID_ID)
+	{
+	}
+
+	constexpr explicit atom(value_type id) noexcept :
+		id_(id)
+	{
+	}
+
+	constexpr value_type id() const noexcept { return id_; }
+	constexpr bool is_valid() const noexcept { return id_ != INVALID_ID; }
+
+	constexpr bool operator==(atom other) const noexcept { return id_ == other.id_; }
+	constexpr bool operator!=(atom other) const noexcept { return id_ != other.id_; }
+
+private:
+	value_type id_;
+};
+
+// Table of unique strings, which grows by appending segments. Lookup and interning are lock-free and may be
+// called from any thread concurrently: open addressing index of every segment is filled by single
+// compare-and-swap per string, segments and string bodies are never moved or released until table is destroyed.
+// Every next segment is twice bigger than previous one. Segment keeps load factor not greater than 1/2,
+// so that probe sequences stay short. Atom id is index of string's slot counted through all segments.
+// String is inserted into a segment only after all previous ones are full and do not contain it,
+// so that equal strings never get two atoms.
+template <typename Allocator = noexcept_allocator<uint8_t>>
+class basic_atom_table
+{
+public:
+	using size_type = atom::value_type;
+	using allocator_type = Allocator;
+
+	// Capacity is of the first segment, it is rounded up to power of two.
+	explicit basic_atom_table(size_type capacity, const Allocator& alloc = Allocator()) :
+		first_capacity_(static_cast<size_type>(std::bit_ceil(std::max<size_t>(capacity, 1)))),
+		alloc_(alloc)
+	{
+		static_assert(std::is_same_v<typename allocator_type::value_type, uint8_t>);
+
+		for (std::atomic<segment*>& seg : segments_)
+			std::construct_at(&seg, nullptr);
+	}
+
+	basic_atom_table(const basic_atom_table&) = delete;
+	void operator=(const basic_atom_table&) = delete;
+
+	~basic_atom_table()
+	{
+		for (size_type index = 0; index < MAX_SEGMENTS; ++index)
+		{
+			segment* seg = segments_[index].load(std::memory_order_relaxed);
+			if (seg == nullptr)
+				break;
+
+			std::atomic<record*>* slots = get_slots(seg);
+			for (size_t i = 0; i < get_slots_count(index); ++i)
+			{
+				record* rec = slots[i].load(std::memory_order_relaxed);
+				if (rec != nullptr)
+					destroy_record(rec);
+			}
+			alloc_.deallocate(reinterpret_cast<uint8_t*>(seg), get_segment_memory_size(index));
+		}
+	}
+
+	// Returns atom of string, interning it when it is not in the table yet.
+	// Returns invalid atom when memory or atom ids are exhausted.
+	atom intern(const char* str, size_t length)
+	{
+		const uint64_t hash = hash_bytes(str, length);
+
+		atom ret;
+		record* rec = nullptr;
+		for (size_type index = 0; index < MAX_SEGMENTS; ++index)
+		{
+			segment* seg = get_or_create_segment(index);
+			if (seg == nullptr || intern_segment(index, *seg, str, length, hash, rec, ret))
+				break;
+		}
+
+		if (rec != nullptr)
+			destroy_record(rec);
+		return ret;
+	}
+
+	atom intern(const char* str) { return intern(str, strlen(str)); }
+
+	// Returns atom of string or invalid atom when string is not interned.
+	atom find(const char* str, size_t length) const noexcept
+	{
+		const uint64_t hash = hash_bytes(str, length);
+
+		for (size_type index = 0; index < MAX_SEGMENTS; ++index)
+		{
+			const segment* seg = segments_[index].load(std::memory_order_acquire);
+			if (seg == nullptr)
+				break;
+
+			const std::atomic<record*>* slots = get_slots(seg);
+			const size_type mask = get_slots_count(index) - 1;
+			for (size_type slot = static_cast<size_type>(hash & mask);; slot = (slot + 1) & mask)
+			{
+				const record* found = slots[slot].load(std::memory_order_acquire);
+				if (found == nullptr)
+					break;
+				if (is_equal(found, str, length, hash))
+					return atom(get_offset(index) + slot);
+			}
+		}
+		return atom();
+	}
+
+	atom find(const char* str) const noexcept { return find(str, strlen(str)); }
+
+	// Invalid or unknown atoms give empty string, so that they are safe to print.
+	const char* c_str(atom name) const noexcept
+	{
+		const record* rec = get_record(name);
+		return rec != nullptr ? rec->get_str() : "";
+	}
+
+	size_t length(atom name) const noexcept
+	{
+		const record* rec = get_record(name);
+		return rec != nullptr ? rec->length : 0;
+	}
+
+	uint64_t hash(atom name) const noexcept
+	{
+		const record* rec = get_record(name);
+		return rec != nullptr ? rec->hash : 0;
+	}
+
+	size_type size() const noexcept
+	{
+		size_type ret = 0;
+		for_each_segment([&](size_type, const segment& seg) { ret += seg.published.load(std::memory_order_relaxed); });
+		return ret;
+	}
+
+	// Strings fitting into already allocated segments.
+	size_type capacity() const noexcept
+	{
+		size_type ret = 0;
+		for_each_segment([&](size_type index, const segment&) { ret += get_capacity(index); });
+		return ret;
+	}
+
+	// Upper bound of atom ids given out so far, use it to size arrays indexed by atoms.
+	size_type max_id() const noexcept
+	{
+		size_type ret = 0;
+		for_each_segment([&](size_type index, const segment&) { ret = get_offset(index) + get_slots_count(index); });
+		return ret;
+	}
+
+	// Memory of index. String bodies are not counted.
+	size_t memory_size() const noexcept
+	{
+		size_t ret = 0;
+		for_each_segment([&](size_type index, const segment&) { ret += get_segment_memory_size(index); });
+		return ret;
+	}
+
+private:
+	static constexpr size_type MAX_SEGMENTS = 32;
+
+	struct record
+	{
+		uint64_t hash;
+		size_t length;
+
+		char* get_str() noexcept { return reinterpret_cast<char*>(this + 1); }
+		const char* get_str() const noexcept { return reinterpret_cast<const char*>(this + 1); }
+	};
+
+	// Header of segment, its slots follow it in the same memory block.
+	// Capacity is reserved before slot is taken, and returned when concurrent insertion of the same string wins.
+	// Segment is full for good, when every reserved record is published.
+	struct segment
+	{
+		std::atomic<size_type> reserved;
+		std::atomic<size_type> published;
+	};
+
+	static_assert(sizeof(segment) % alignof(std::atomic<record*>) == 0);
+
+	size_type get_capacity(size_type index) const noexcept { return first_capacity_ << index; }
+	size_t get_slots_count(size_type index) const noexcept { return static_cast<size_t>(first_capacity_) * 2 << index; }
+	size_type get_offset(size_type index) const noexcept { return static_cast<size_type>(get_wide_offset(index)); }
+	uint64_t get_wide_offset(size_type index) const noexcept { return static_cast<uint64_t>(first_capacity_) * 2 * ((1ull << index) - 1); }
+
+	size_t get_segment_memory_size(size_type index) const noexcept
+	{
+		return sizeof(segment) + sizeof(std::atomic<record*>) * get_slots_count(index);
+	}
+
+	static std::atomic<record*>* get_slots(segment* seg) noexcept { return reinterpret_cast<std::atomic<record*>*>(seg + 1); }
+	static const std::atomic<record*>* get_slots(const segment* seg) noexcept { return reinterpret_cast<const std::atomic<record*>*>(seg + 1); }
+
+	template <typename Function>
+	void for_each_segment(Function function) const noexcept
+	{
+		for (size_type index = 0; index < MAX_SEGMENTS; ++index)
+		{
+			const segment* seg = segments_[index].load(std::memory_order_acquire);
+			if (seg == nullptr)
+				break;
+			function(index, *seg);
+		}
+	}
+
+	// Segment losing publishing race is released, so that every thread continues in the same one.
+	// Returns nullptr when memory is exhausted or ids of segment would not fit into atom.
+	segment* get_or_create_segment(size_type index)
+	{
+		segment* seg = segments_[index].load(std::memory_order_acquire);
+		if (seg != nullptr)
+			return seg;
+
+		if (get_wide_offset(index) + get_slots_count(index) > atom::INVALID_ID)
+			return nullptr;
+
+		seg = reinterpret_cast<segment*>(alloc_.allocate(get_segment_memory_size(index)));
+		if (seg == nullptr)
+			return nullptr;
+
+		std::construct_at(&seg->reserved, 0);
+		std::construct_at(&seg->published, 0);
+		std::atomic<record*>* slots = get_slots(seg);
+		for (size_t i = 0; i < get_slots_count(index); ++i)
+			std::construct_at(&slots[i], nullptr);
+
+		segment* expected = nullptr;
+		if (!segments_[index].compare_exchange_strong(expected, seg, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			alloc_.deallocate(reinterpret_cast<uint8_t*>(seg), get_segment_memory_size(index));
+			return expected;
+		}
+		return seg;
+	}
+
+	// Returns false when segment is full and has no such string, so that search goes on in the next one.
+	// Otherwise ret is atom of string, or invalid atom when record could not be allocated.
+	// Record is created once per intern call and reused between segments, it is taken when published.
+	bool intern_segment(size_type index, segment& seg, const char* str, size_t length, uint64_t hash, record*& rec, atom& ret)
+	{
+		std::atomic<record*>* slots = get_slots(&seg);
+		const size_type mask = static_cast<size_type>(get_slots_count(index) - 1);
+		const size_type capacity = get_capacity(index);
+		bool reserved = false;
+		for (;;)
+		{
+			// Nothing is published after segment became full, so that empty slot ends search for good.
+			const bool full = seg.published.load(std::memory_order_acquire) == capacity;
+			for (size_type slot = static_cast<size_type>(hash & mask);; slot = (slot + 1) & mask)
+			{
+				record* found = slots[slot].load(std::memory_order_acquire);
+				if (found == nullptr)
+				{
+					if (full)
+						return false;
+
+					if (!reserved)
+					{
+						reserved = seg.reserved.fetch_add(1, std::memory_order_relaxed) < capacity;
+						if (!reserved)
+						{
+							seg.reserved.fetch_sub(1, std::memory_order_relaxed);
+							break;
+						}
+					}
+
+					if (rec == nullptr)
+					{
+						rec = create_record(str, length, hash);
+						if (rec == nullptr)
+						{
+							seg.reserved.fetch_sub(1, std::memory_order_relaxed);
+							return true;
+						}
+					}
+
+					// Record is filled before publishing, so that any thread, that found it, reads whole string.
+					if (slots[slot].compare_exchange_strong(found, rec, std::memory_order_acq_rel, std::memory_order_acquire))
+					{
+						rec = nullptr;
+						seg.published.fetch_add(1, std::memory_order_release);
+						ret = atom(get_offset(index) + slot);
+						return true;
+					}
+				}
+
+				// Slot is taken, either before or by concurrent insertion.
+				if (is_equal(found, str, length, hash))
+				{
+					if (reserved)
+						seg.reserved.fetch_sub(1, std::memory_order_relaxed);
+					ret = atom(get_offset(index) + slot);
+					return true;
+				}
+			}
+
+			// Capacity is taken by insertions in flight, they either publish or give it back soon.
+			std::this_thread::yield();
+		}
+	}
+
+	record* create_record(const char* str, size_t length, uint64_t hash)
+	{
+		record* rec = reinterpret_cast<record*>(alloc_.allocate(sizeof(record) + length + 1));
+		if (rec == nullptr)
+			return nullptr;
+
+		rec->hash = hash;
+		rec->length = length;
+		memcpy(rec->get_str(), str, length);
+		rec->get_str()[length] = '\0';
+
+		return rec;
+	}
+
+	void destroy_record(record* rec)
+	{
+		alloc_.deallocate(reinterpret_cast<uint8_t*>(rec), sizeof(record) + rec->length + 1);
+	}
+
+	const record* get_record(atom name) const noexcept
+	{
+		if (!name.is_valid())
+			return nullptr;
+
+		const size_type index = static_cast<size_type>(std::bit_width(name.id() / (static_cast<size_t>(first_capacity_) * 2) + 1) - 1);
+		const segment* seg = index < MAX_SEGMENTS ? segments_[index].load(std::memory_order_acquire) : nullptr;
+		if (seg == nullptr)
+			return nullptr;
+		return get_slots(seg)[name.id() - get_offset(index)].load(std::memory_order_acquire);
+	}
+
+	static bool is_equal(const record* rec, const char* str, size_t length, uint64_t hash) noexcept
+	{
+		return rec->hash == hash && rec->length == length && memcmp(rec->get_str(), str, length) == 0;
+	}
+
+	std::atomic<segment*> segments_[MAX_SEGMENTS];
+	const size_type first_capacity_;
+	[[no_unique_address]] allocator_type alloc_;
+};
+
+using atom_table = basic_atom_table<>;
+} // namespace A3D
+
+namespace std
+{
+template <>
+struct hash<A3D::atom>
+{
+	constexpr size_t operator()(A3D::atom name) const noexcept
+	{
+		return name.id();
+	}
+};
+}
+
+#endif // CONTAINER_ATOM_TABLE_H
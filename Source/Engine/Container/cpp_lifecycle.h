@@ -26,6 +26,15 @@
 
 namespace A3D
 {
+// Object is trivially relocatable when moving it to a new address and forgetting the old
+// one is equal to memcpy. Every trivially copyable type is relocatable, other types opt in
+// by specialization, e.g. types holding owning pointers to heap memory.
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 template <typename T, typename... Args>
 inline void construct(T* ptr, Args&&... args)
 {
@@ -72,14 +81,18 @@ inline void move_assign(T* dst, T* src)
 	*dst = std::move(*src);
 };
 
+// Value-initialized trivial object is all zero bits, so that whole range is filled by single memset.
 template <typename T, typename... Args>
 inline void construct_n(T* begin, const T* end, const Args&... args)
 {
-	while (begin < end)
-	{
-		construct(begin);
-		++begin;
-	}
+	if constexpr (sizeof...(Args) == 0 && std::is_trivially_default_constructible_v<T> && std::is_trivially_copyable_v<T>)
+		memset(static_cast<void*>(begin), 0, (end - begin) * sizeof(T));
+	else
+		while (begin < end)
+		{
+			construct(begin, args...);
+			++begin;
+		}
 };
 
 template <typename T, typename... Args>
@@ -91,7 +104,7 @@ inline void construct_n(T* begin, size_t size, const Args&... args)
 template <typename T>
 inline void destroy_n(T* begin, const T* end)
 {
-	if constexpr (!std::is_integral_v<T> && !std::is_trivial_v<T>)
+	if constexpr (!std::is_trivially_destructible_v<T>)
 		while (begin < end)
 		{
 			destroy(begin);
@@ -105,14 +118,15 @@ inline void destroy_n(T* begin, size_t size)
 	destroy_n(begin, begin + size);
 };
 
+// Ranges of trivially copyable objects are copied by single memcpy, even when type has user constructors.
 template <typename T>
 inline void copy_construct_n(T* dst, const T* src, size_t size)
 {
-	if constexpr (!std::is_integral_v<T> && !std::is_trivial_v<T>)
+	if constexpr (std::is_trivially_copyable_v<T>)
+		memcpy(static_cast<void*>(dst), static_cast<const void*>(src), size * sizeof(T));
+	else
 		for (const T* dst_end = dst + size; dst < dst_end; ++dst, ++src)
 			copy_construct(dst, src);
-	else
-		memcpy(dst, src, size * sizeof(T));
 };
 
 template <typename T>
@@ -124,27 +138,41 @@ inline void copy_construct_n(T* dst, const T* src, const T* src_end)
 template <typename T>
 inline void move_construct_n(T* dst, T* src, size_t size)
 {
-	if constexpr (!std::is_integral_v<T> && !std::is_trivial_v<T>)
+	if constexpr (std::is_trivially_copyable_v<T>)
+		memcpy(static_cast<void*>(dst), static_cast<const void*>(src), size * sizeof(T));
+	else
 		for (const T* dst_end = dst + size; dst < dst_end; ++dst, ++src)
 			move_construct(dst, src);
-	else
-		memcpy(dst, src, size * sizeof(T));
 };
 
 template <typename T>
 inline void move_construct_n(T* dst, T* src, const T* src_end)
 {
-	move_construct_n(dst, src, src_end);
+	move_construct_n(dst, src, src_end - src);
 };
 
+// Move objects to uninitialized memory and end lifetime of source objects.
+template <typename T>
+inline void relocate_n(T* dst, T* src, size_t size)
+{
+	if constexpr (is_trivially_relocatable_v<T>)
+		memcpy(static_cast<void*>(dst), static_cast<const void*>(src), size * sizeof(T));
+	else
+		for (const T* dst_end = dst + size; dst < dst_end; ++dst, ++src)
+		{
+			move_construct(dst, src);
+			destroy(src);
+		}
+}
+
 template <typename T>
 inline void copy_assign_n(T* dst, const T* src, size_t size)
 {
-	if constexpr (!std::is_integral_v<T> && !std::is_trivial_v<T>)
+	if constexpr (std::is_trivially_copyable_v<T>)
+		memcpy(static_cast<void*>(dst), static_cast<const void*>(src), size * sizeof(T));
+	else
 		for (const T* dst_end = dst + size; dst < dst_end; ++dst, ++src)
 			copy_assign(dst, src);
-	else
-		memcpy(dst, src, size * sizeof(T));
 }
 
 template <typename T>
@@ -153,14 +181,15 @@ inline void copy_assign_n(T* dst, const T* src, const T* src_end)
 	copy_assign_n(dst, src, src_end - src);
 }
 
+// Ranges may overlap when items are shifted towards the beginning of the same array.
 template <typename T>
 inline void move_assign_n(T* dst, T* src, size_t size)
 {
-	if constexpr (!std::is_integral_v<T> && !std::is_trivial_v<T>)
+	if constexpr (std::is_trivially_copyable_v<T>)
+		memmove(static_cast<void*>(dst), static_cast<const void*>(src), size * sizeof(T));
+	else
 		for (const T* dst_end = dst + size; dst < dst_end; ++dst, ++src)
 			move_assign(dst, src);
-	else
-		memcpy(dst, src, size * sizeof(T));
 }
 
 template <typename T>
@@ -21,18 +21,30 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include "growth_policy.h"
 #include "noexcept_allocator.h"
 #include "vector.h"
 
 namespace A3D
 {
+// Item moved by batch erase from one key to another.
+// Shared by all dense maps with the same key type, so that parallel maps apply the same remap.
+template <typename Key>
+struct dense_map_remap_entry
+{
+	Key from;
+	Key to;
+};
+
 template <typename Key,
 		  typename Value,
-		  typename Allocator = noexcept_allocator<Value>>
+		  typename Allocator = noexcept_allocator<Value>,
+		  typename GrowthPolicy = growth_default>
 class dense_map
 {
 public:
@@ -44,8 +56,10 @@ public:
 	using pointer = value_type*;
 	using const_pointer = const value_type*;
 	using allocator_type = Allocator;
+	using growth_policy = GrowthPolicy;
 	using iterator = pointer;
 	using const_iterator = const_pointer;
+	using remap_entry = dense_map_remap_entry<key_type>;
 
 	static constexpr key_type INVALID_KEY = std::numeric_limits<key_type>::max();
 
@@ -116,6 +130,43 @@ public:
 		return is_not_last ? last - data_.begin() : INVALID_KEY;
 	}
 
+	// Erase count unique keys at once. Keys array is sorted in place.
+	// Holes are filled by surviving items from the tail, every move is written into remap,
+	// which must fit count entries. Returns number of written remap entries.
+	// Parallel dense maps are compacted the same way by apply_remap.
+	size_type erase_batch(key_type* keys, size_type count, remap_entry* remap)
+	{
+		std::sort(keys, keys + count);
+
+		const size_type new_size = static_cast<size_type>(data_.size() - count);
+		const key_type* hole = keys;
+		const key_type* erased_tail = std::lower_bound(keys, keys + count, new_size);
+		const key_type* const keys_end = keys + count;
+
+		size_type remap_size = 0;
+		for (size_type src = new_size; hole < erased_tail; ++src)
+		{
+			if (erased_tail < keys_end && *erased_tail == src)
+			{
+				++erased_tail;
+				continue;
+			}
+			remap[remap_size++] = { src, *hole++ };
+		}
+
+		apply_remap(remap, remap_size, count);
+
+		return remap_size;
+	}
+
+	// Repeat batch erase of count items, which is described by remap.
+	void apply_remap(const remap_entry* remap, size_type remap_size, size_type count) noexcept
+	{
+		for (size_type i = 0; i < remap_size; ++i)
+			move(remap[i].to, remap[i].from);
+		data_.shrink(static_cast<size_type>(data_.size() - count));
+	}
+
 	void move(key_type dst, key_type src) noexcept { move(begin() + dst, begin() + src); }
 
 	static void move(const_iterator dst, const_iterator src) noexcept
@@ -155,9 +206,10 @@ public:
 	bool shrink_to_fit() { return data_.shrink_to_fit(); }
 
 	size_t memory_size() const noexcept { return data_.memory_size(); }
+	size_t memory_slack() const noexcept { return data_.memory_slack(); }
 
 private:
-	vector<key_type, value_type, allocator_type> data_;
+	vector<key_type, value_type, allocator_type, growth_policy> data_;
 };
 } // namespace A3D
 
@@ -0,0 +1,640 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_FLAT_MAP_H
+#define CONTAINER_FLAT_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "cpp_lifecycle.h"
+#include "noexcept_allocator.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+namespace A3D
+{
+namespace flat_map_detail
+{
+// Control byte of every slot: empty, deleted or 7 low bits of the key hash, when slot is full.
+using ctrl_type = int8_t;
+
+inline constexpr ctrl_type CTRL_EMPTY = -128;
+inline constexpr ctrl_type CTRL_DELETED = -2;
+
+// Bit mask of matching slots inside a group. Every slot takes 1 << SHIFT bits.
+template <typename Mask, unsigned Shift>
+class group_mask
+{
+public:
+	explicit constexpr group_mask(Mask mask) noexcept :
+		mask_(mask)
+	{
+	}
+
+	explicit constexpr operator bool() const noexcept { return mask_ != 0; }
+
+	constexpr size_t lowest() const noexcept { return static_cast<size_t>(std::countr_zero(mask_)) >> Shift; }
+	constexpr void clear_lowest() noexcept { mask_ &= mask_ - 1; }
+
+private:
+	Mask mask_;
+};
+
+#ifdef __SSE2__
+// Sixteen control bytes compared by a single SSE2 instruction.
+class group
+{
+public:
+	static constexpr size_t WIDTH = 16;
+
+	using mask_type = group_mask<uint32_t, 0>;
+
+	explicit group(const ctrl_type* ctrl) noexcept :
+		ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+	{
+	}
+
+	mask_type match(ctrl_type h2) const noexcept
+	{
+		return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+	}
+
+	mask_type match_empty() const noexcept { return match(CTRL_EMPTY); }
+
+	// Empty and deleted control bytes are the only negative ones.
+	mask_type match_empty_or_deleted() const noexcept
+	{
+		return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(ctrl_)));
+	}
+
+private:
+	__m128i ctrl_;
+};
+#else // __SSE2__
+// Eight control bytes compared as a single 64-bit word. Match may report false positive
+// for byte next to matching one, that is filtered out by keys compare.
+class group
+{
+public:
+	static constexpr size_t WIDTH = 8;
+
+	using mask_type = group_mask<uint64_t, 3>;
+
+	explicit group(const ctrl_type* ctrl) noexcept
+	{
+		memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+		if constexpr (std::endian::native == std::endian::big)
+			ctrl_ = __builtin_bswap64(ctrl_);
+	}
+
+	mask_type match(ctrl_type h2) const noexcept
+	{
+		const uint64_t x = ctrl_ ^ (LSBS * static_cast<uint8_t>(h2));
+		return mask_type((x - LSBS) & ~x & MSBS);
+	}
+
+	mask_type match_empty() const noexcept { return mask_type(ctrl_ & (~ctrl_ << 6) & MSBS); }
+	mask_type match_empty_or_deleted() const noexcept { return mask_type(ctrl_ & MSBS); }
+
+private:
+	static constexpr uint64_t LSBS = 0x0101010101010101ull;
+	static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+	uint64_t ctrl_;
+};
+#endif // __SSE2__
+} // namespace flat_map_detail
+
+// Open addressing hash map in the style of Swiss tables. Items are stored in single flat array,
+// every slot has control byte with 7 hash bits, so that group of slots is probed by one compare
+// of control bytes and keys are compared only for slots with matching hash bits.
+// Heterogeneous lookup is enabled when both Hash and KeyEqual declare is_transparent.
+// Pointers and iterators are invalidated by insertion that rehashes table.
+template <typename Key,
+		  typename Value,
+		  typename Hash = std::hash<Key>,
+		  typename KeyEqual = std::equal_to<Key>,
+		  typename Allocator = noexcept_allocator<std::pair<Key, Value>>>
+class flat_map
+{
+	template <typename Map, typename Reference>
+	class basic_iterator;
+
+	static constexpr bool IS_TRANSPARENT = requires { typename Hash::is_transparent; typename KeyEqual::is_transparent; };
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<Key, Value>;
+	using size_type = size_t;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using iterator = basic_iterator<flat_map, value_type&>;
+	using const_iterator = basic_iterator<const flat_map, const value_type&>;
+
+	static constexpr size_type GROUP_WIDTH = flat_map_detail::group::WIDTH;
+
+	flat_map() :
+		slots_(nullptr),
+		ctrl_(nullptr),
+		size_(0),
+		capacity_(0),
+		growth_left_(0)
+	{
+	}
+
+	explicit flat_map(const Allocator& alloc) :
+		slots_(nullptr),
+		ctrl_(nullptr),
+		size_(0),
+		capacity_(0),
+		growth_left_(0),
+		alloc_(alloc)
+	{
+	}
+
+	flat_map(const flat_map& other) :
+		slots_(nullptr),
+		ctrl_(nullptr),
+		size_(0),
+		capacity_(0),
+		growth_left_(0),
+		hash_(other.hash_),
+		equal_(other.equal_),
+		alloc_(other.alloc_)
+	{
+		copy_from(other);
+	}
+
+	flat_map(flat_map&& other) noexcept :
+		slots_(other.slots_),
+		ctrl_(other.ctrl_),
+		size_(other.size_),
+		capacity_(other.capacity_),
+		growth_left_(other.growth_left_),
+		hash_(std::move(other.hash_)),
+		equal_(std::move(other.equal_)),
+		alloc_(std::move(other.alloc_))
+	{
+		other.reset();
+	}
+
+	~flat_map() { destroy(); }
+
+	void operator=(const flat_map& other)
+	{
+		clear();
+		copy_from(other);
+	}
+
+	void operator=(flat_map&& other) noexcept
+	{
+		destroy();
+
+		slots_ = other.slots_;
+		ctrl_ = other.ctrl_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		growth_left_ = other.growth_left_;
+
+		other.reset();
+	}
+
+	iterator begin() noexcept { return iterator(this, find_next_full(0)); }
+	const_iterator begin() const noexcept { return const_iterator(this, find_next_full(0)); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	iterator end() noexcept { return iterator(this, capacity_); }
+	const_iterator end() const noexcept { return const_iterator(this, capacity_); }
+	const_iterator cend() const noexcept { return end(); }
+
+	size_type size() const noexcept { return size_; }
+	size_type capacity() const noexcept { return capacity_; }
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+	iterator find(const key_type& key) noexcept { return iterator(this, find_index(key)); }
+	const_iterator find(const key_type& key) const noexcept { return const_iterator(this, find_index(key)); }
+	bool contains(const key_type& key) const noexcept { return find_index(key) != capacity_; }
+
+	template <typename K>
+		requires IS_TRANSPARENT
+	iterator find(const K& key) noexcept
+	{
+		return iterator(this, find_index(key));
+	}
+
+	template <typename K>
+		requires IS_TRANSPARENT
+	const_iterator find(const K& key) const noexcept
+	{
+		return const_iterator(this, find_index(key));
+	}
+
+	template <typename K>
+		requires IS_TRANSPARENT
+	bool contains(const K& key) const noexcept
+	{
+		return find_index(key) != capacity_;
+	}
+
+	// Inserts item, when key is not present yet. Returns iterator to item with the key and insertion flag.
+	// Returns end() on allocation failure.
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+	{
+		// Without transparent hasher key of other type is hashed and compared as key type.
+		if constexpr (!IS_TRANSPARENT && !std::is_same_v<std::remove_cvref_t<K>, key_type>)
+			return try_emplace(key_type(std::forward<K>(key)), std::forward<Args>(args)...);
+		else
+		{
+			const size_t hash = get_hash(key);
+
+			const size_type found = find_index(key, hash);
+			if (found != capacity_)
+				return { iterator(this, found), false };
+
+			const size_type index = prepare_insert(hash);
+			if (index == capacity_)
+				return { end(), false };
+
+			std::construct_at(&slots_[index],
+							  std::piecewise_construct,
+							  std::forward_as_tuple(std::forward<K>(key)),
+							  std::forward_as_tuple(std::forward<Args>(args)...));
+			return { iterator(this, index), true };
+		}
+	}
+
+	template <typename K, typename V>
+	std::pair<iterator, bool> emplace(K&& key, V&& value)
+	{
+		return try_emplace(std::forward<K>(key), std::forward<V>(value));
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+	std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+
+	// Returns false on allocation failure.
+	template <typename K, typename V>
+	bool insert_or_assign(K&& key, V&& value)
+	{
+		auto [it, inserted] = try_emplace(std::forward<K>(key), std::forward<V>(value));
+		if (it == end())
+			return false;
+		if (!inserted)
+			it->second = std::forward<V>(value);
+		return true;
+	}
+
+	size_type erase(const key_type& key) { return erase_key(key); }
+
+	template <typename K>
+		requires IS_TRANSPARENT
+	size_type erase(const K& key)
+	{
+		return erase_key(key);
+	}
+
+	void erase(const_iterator it) { erase_index(it.index_); }
+	void erase(iterator it) { erase_index(it.index_); }
+
+	void clear()
+	{
+		if (capacity_ == 0)
+			return;
+
+		destroy_items();
+		memset(ctrl_, flat_map_detail::CTRL_EMPTY, capacity_ + GROUP_WIDTH);
+		size_ = 0;
+		growth_left_ = get_max_load(capacity_);
+	}
+
+	// Reserve space for count items without rehash.
+	bool reserve(size_type count)
+	{
+		if (count <= size_ + growth_left_)
+			return true;
+
+		return rehash(get_capacity_for(count));
+	}
+
+	size_t memory_size() const noexcept
+	{
+		return capacity_ > 0 ? get_memory_size(capacity_) : 0;
+	}
+
+private:
+	using ctrl_type = flat_map_detail::ctrl_type;
+	using group = flat_map_detail::group;
+	using byte_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<uint8_t>;
+
+	static constexpr size_type MIN_CAPACITY = GROUP_WIDTH;
+
+	// Slots are filled up to 7/8 of capacity, so that every probe sequence meets empty slot.
+	static constexpr size_type get_max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+	static constexpr size_type get_capacity_for(size_type count) noexcept
+	{
+		const size_type capacity = std::bit_ceil(count + count / 7 + 1);
+		return capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+	}
+
+	// Slots are followed by control bytes in the same block. Control bytes of the first group
+	// are repeated after the last one, so that group may be loaded from any slot without wrapping.
+	static constexpr size_t get_memory_size(size_type capacity) noexcept
+	{
+		return capacity * sizeof(value_type) + capacity + GROUP_WIDTH;
+	}
+
+	// Hashes of integers are often identity, so that hash is mixed before split into position and control bits.
+	template <typename K>
+	size_t get_hash(const K& key) const noexcept
+	{
+		const uint64_t h = static_cast<uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ull;
+		return static_cast<size_t>(h ^ (h >> 32));
+	}
+
+	static constexpr size_t get_h1(size_t hash) noexcept { return hash >> 7; }
+	static constexpr ctrl_type get_h2(size_t hash) noexcept { return static_cast<ctrl_type>(hash & 0x7f); }
+
+	void set_ctrl(size_type index, ctrl_type ctrl) noexcept
+	{
+		ctrl_[index] = ctrl;
+		if (index < GROUP_WIDTH)
+			ctrl_[capacity_ + index] = ctrl;
+	}
+
+	template <typename K>
+	size_type find_index(const K& key) const noexcept
+	{
+		return find_index(key, get_hash(key));
+	}
+
+	// Groups are probed in triangular sequence, that visits every group of power of two table.
+	// Returns capacity when key is not found.
+	template <typename K>
+	size_type find_index(const K& key, size_t hash) const noexcept
+	{
+		if (capacity_ == 0)
+			return capacity_;
+
+		const size_type mask = capacity_ - 1;
+		const ctrl_type h2 = get_h2(hash);
+		size_type pos = get_h1(hash) & mask;
+		size_type step = 0;
+		for (;;)
+		{
+			const group g(ctrl_ + pos);
+			for (auto match = g.match(h2); match; match.clear_lowest())
+			{
+				const size_type index = (pos + match.lowest()) & mask;
+				if (equal_(slots_[index].first, key))
+					return index;
+			}
+
+			if (g.match_empty())
+				return capacity_;
+
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	size_type find_first_non_full(size_t hash) const noexcept
+	{
+		const size_type mask = capacity_ - 1;
+		size_type pos = get_h1(hash) & mask;
+		size_type step = 0;
+		for (;;)
+		{
+			const auto match = group(ctrl_ + pos).match_empty_or_deleted();
+			if (match)
+				return (pos + match.lowest()) & mask;
+
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	// Takes slot for new item with given hash, rehashing table when it is out of empty slots.
+	// Returns capacity on allocation failure.
+	size_type prepare_insert(size_t hash)
+	{
+		size_type index = capacity_ > 0 ? find_first_non_full(hash) : 0;
+		if (capacity_ == 0 || (growth_left_ == 0 && ctrl_[index] == flat_map_detail::CTRL_EMPTY))
+		{
+			// Table full of deleted slots is cleaned up in the same capacity.
+			const size_type new_capacity = capacity_ == 0 ? MIN_CAPACITY :
+				size_ < get_max_load(capacity_) / 2 ? capacity_ : capacity_ * 2;
+			if (!rehash(new_capacity))
+				return capacity_;
+			index = find_first_non_full(hash);
+		}
+
+		if (ctrl_[index] == flat_map_detail::CTRL_EMPTY)
+			--growth_left_;
+		set_ctrl(index, get_h2(hash));
+		++size_;
+
+		return index;
+	}
+
+	template <typename K>
+	size_type erase_key(const K& key)
+	{
+		const size_type index = find_index(key);
+		if (index == capacity_)
+			return 0;
+
+		erase_index(index);
+		return 1;
+	}
+
+	void erase_index(size_type index)
+	{
+		A3D::destroy(&slots_[index]);
+		set_ctrl(index, flat_map_detail::CTRL_DELETED);
+		--size_;
+	}
+
+	bool rehash(size_type new_capacity)
+	{
+		uint8_t* new_data = alloc_.allocate(get_memory_size(new_capacity));
+		if (new_data == nullptr)
+			return false;
+
+		pointer old_slots = slots_;
+		ctrl_type* old_ctrl = ctrl_;
+		const size_type old_capacity = capacity_;
+
+		slots_ = reinterpret_cast<pointer>(new_data);
+		ctrl_ = reinterpret_cast<ctrl_type*>(new_data + new_capacity * sizeof(value_type));
+		capacity_ = new_capacity;
+		growth_left_ = get_max_load(new_capacity) - size_;
+		memset(ctrl_, flat_map_detail::CTRL_EMPTY, new_capacity + GROUP_WIDTH);
+
+		for (size_type i = 0; i < old_capacity; ++i)
+			if (old_ctrl[i] >= 0)
+			{
+				const size_t hash = get_hash(old_slots[i].first);
+				const size_type index = find_first_non_full(hash);
+				set_ctrl(index, get_h2(hash));
+				relocate_n(&slots_[index], &old_slots[i], 1);
+			}
+
+		if (old_capacity > 0)
+			alloc_.deallocate(reinterpret_cast<uint8_t*>(old_slots), get_memory_size(old_capacity));
+
+		return true;
+	}
+
+	size_type find_next_full(size_type index) const noexcept
+	{
+		while (index < capacity_ && ctrl_[index] < 0)
+			++index;
+		return index;
+	}
+
+	void copy_from(const flat_map& other)
+	{
+		if (other.size_ == 0 || !reserve(other.size_))
+			return;
+
+		for (const value_type& item : other)
+		{
+			const size_t hash = get_hash(item.first);
+			const size_type index = find_first_non_full(hash);
+			--growth_left_;
+			set_ctrl(index, get_h2(hash));
+			copy_construct(&slots_[index], &item);
+			++size_;
+		}
+	}
+
+	void destroy_items()
+	{
+		if constexpr (!std::is_trivially_destructible_v<value_type>)
+			for (size_type i = 0; i < capacity_; ++i)
+				if (ctrl_[i] >= 0)
+					std::destroy_at(&slots_[i]);
+	}
+
+	void destroy()
+	{
+		if (capacity_ == 0)
+			return;
+
+		destroy_items();
+		alloc_.deallocate(reinterpret_cast<uint8_t*>(slots_), get_memory_size(capacity_));
+	}
+
+	void reset() noexcept
+	{
+		slots_ = nullptr;
+		ctrl_ = nullptr;
+		size_ = 0;
+		capacity_ = 0;
+		growth_left_ = 0;
+	}
+
+	// Forward iterator over full slots in storage order.
+	template <typename Map, typename Reference>
+	class basic_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename Map::value_type;
+		using difference_type = ptrdiff_t;
+		using pointer = std::remove_reference_t<Reference>*;
+		using reference = Reference;
+
+		basic_iterator() noexcept :
+			map_(nullptr),
+			index_(0)
+		{
+		}
+
+		basic_iterator(Map* map, size_type index) noexcept :
+			map_(map),
+			index_(index)
+		{
+		}
+
+		// Mutable iterator is convertible to const one.
+		template <typename OtherMap, typename OtherReference>
+			requires(std::is_const_v<Map> && !std::is_const_v<OtherMap>)
+		basic_iterator(const basic_iterator<OtherMap, OtherReference>& other) noexcept :
+			map_(other.map_),
+			index_(other.index_)
+		{
+		}
+
+		reference operator*() const noexcept { return map_->slots_[index_]; }
+		pointer operator->() const noexcept { return &map_->slots_[index_]; }
+
+		basic_iterator& operator++() noexcept
+		{
+			index_ = map_->find_next_full(index_ + 1);
+			return *this;
+		}
+
+		basic_iterator operator++(int) noexcept
+		{
+			basic_iterator ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator==(const basic_iterator& other) const noexcept { return index_ == other.index_; }
+		bool operator!=(const basic_iterator& other) const noexcept { return index_ != other.index_; }
+
+	private:
+		Map* map_;
+		size_type index_;
+
+		template <typename, typename>
+		friend class basic_iterator;
+		friend class flat_map;
+	};
+
+	pointer slots_;
+	ctrl_type* ctrl_;
+	size_type size_;
+	size_type capacity_;
+	size_type growth_left_;
+	[[no_unique_address]] hasher hash_;
+	[[no_unique_address]] key_equal equal_;
+	[[no_unique_address]] byte_allocator_type alloc_;
+};
+} // namespace A3D
+
+#endif // CONTAINER_FLAT_MAP_H
@@ -0,0 +1,170 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_GENERATIONAL_SPARSE_MAP_H
+#define CONTAINER_GENERATIONAL_SPARSE_MAP_H
+
+#include <stdint.h>
+#include <limits>
+#include <type_traits>
+#include "growth_policy.h"
+#include "noexcept_allocator.h"
+#include "sparse_map.h"
+#include "vector.h"
+
+namespace A3D
+{
+// Sparse map with keys made of cell index in low bits and cell generation in high bits.
+// Generation of cell is incremented on every erase, so keys of erased items never alias
+// items inserted later into the same cell. Key validation is single generation compare.
+// Generation wraps around after 2^GenerationBits reuses of the same cell, so a stale key
+// becomes valid again then. Map holds at most MAX_SIZE = 2^(key bits - GenerationBits) - 1
+// items: uint16_t keys give 4 generation and 12 index bits, uint32_t keys 8 and 24 bits.
+template <typename Key,
+		  typename Value,
+		  unsigned GenerationBits = sizeof(Key) * 2,
+		  typename Bitfield = uint32_t,
+		  typename Allocator = noexcept_allocator<Value>,
+		  typename GrowthPolicy = growth_default>
+class generational_sparse_map
+{
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = key_type;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using allocator_type = Allocator;
+	using bitfield_type = Bitfield;
+	using growth_policy = GrowthPolicy;
+	using generation_type = std::conditional_t<GenerationBits <= 8, uint8_t, std::conditional_t<GenerationBits <= 16, uint16_t, uint32_t>>;
+
+	static constexpr key_type INVALID_KEY = std::numeric_limits<key_type>::max();
+	static constexpr unsigned GENERATION_BITS = GenerationBits;
+	static constexpr unsigned INDEX_BITS = sizeof(key_type) * 8 - GENERATION_BITS;
+	static constexpr key_type INDEX_MASK = static_cast<key_type>((static_cast<key_type>(1) << INDEX_BITS) - 1);
+	static constexpr generation_type GENERATION_MASK = static_cast<generation_type>((1ull << GENERATION_BITS) - 1);
+	static constexpr key_type MAX_SIZE = INDEX_MASK;
+
+	generational_sparse_map()
+	{
+		static_assert(std::is_unsigned<Key>::value);
+		static_assert(GenerationBits > 0 && GenerationBits < sizeof(Key) * 8);
+		static_assert(GenerationBits <= 32);
+	}
+
+	explicit generational_sparse_map(const Allocator& alloc) :
+		cells_(alloc)
+	{
+		static_assert(std::is_unsigned<Key>::value);
+		static_assert(GenerationBits > 0 && GenerationBits < sizeof(Key) * 8);
+		static_assert(GenerationBits <= 32);
+	}
+
+	value_type& operator[](key_type key) noexcept { return cells_[get_index(key)]; }
+	const value_type& operator[](key_type key) const noexcept { return cells_[get_index(key)]; }
+
+	size_type capacity() const noexcept { return cells_.capacity(); }
+	size_type size() const noexcept { return cells_.size(); }
+	[[nodiscard]] bool empty() const noexcept { return cells_.empty(); }
+
+	// Key is valid when it has not been erased yet.
+	bool contains(key_type key) const noexcept
+	{
+		const key_type index = get_index(key);
+		return index < generations_.size() && generations_[index] == get_generation(key);
+	}
+
+	key_type insert(value_type value)
+	{
+		const key_type index = cells_.insert(value);
+		if (index == INVALID_KEY)
+			return INVALID_KEY;
+
+		// Index of INDEX_MASK is reserved, so that any valid key differs from INVALID_KEY.
+		if (index >= INDEX_MASK)
+		{
+			cells_.erase(index);
+			return INVALID_KEY;
+		}
+
+		// Cells are taken from the lowest free one, so new index never jumps over generations array.
+		if (index == generations_.size() && !generations_.push_back(0))
+		{
+			cells_.erase(index);
+			return INVALID_KEY;
+		}
+
+		return build_key(index, generations_[index]);
+	}
+
+	void erase(key_type key)
+	{
+		const key_type index = get_index(key);
+		cells_.erase(index);
+		generations_[index] = static_cast<generation_type>((generations_[index] + 1) & GENERATION_MASK);
+	}
+
+	// Removes all items and invalidates all their keys. Generations are kept.
+	void clear()
+	{
+		for (key_type i = 0; i < generations_.size(); ++i)
+			if (cells_.contains(i))
+				generations_[i] = static_cast<generation_type>((generations_[i] + 1) & GENERATION_MASK);
+		cells_.clear();
+	}
+
+	bool reserve(size_type count)
+	{
+		if (count > INDEX_MASK)
+			return false;
+		return cells_.reserve(count) && generations_.reserve(count);
+	}
+
+	// Generations are never shrunk, or keys to the released tail would become valid again.
+	bool shrink_to_fit() { return cells_.shrink_to_fit(); }
+
+	size_t memory_size() const noexcept
+	{
+		return sizeof(generational_sparse_map) + cells_.memory_size() - sizeof(cells_) + generations_.memory_size();
+	}
+
+	static constexpr key_type get_index(key_type key) noexcept
+	{
+		return key & INDEX_MASK;
+	}
+
+	static constexpr generation_type get_generation(key_type key) noexcept
+	{
+		return static_cast<generation_type>(key >> INDEX_BITS);
+	}
+
+	static constexpr key_type build_key(key_type index, generation_type generation) noexcept
+	{
+		return static_cast<key_type>((static_cast<key_type>(generation) << INDEX_BITS) | index);
+	}
+
+private:
+	using generation_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<generation_type>;
+
+	sparse_map<key_type, value_type, bitfield_type, allocator_type, growth_policy> cells_;
+	vector<key_type, generation_type, generation_allocator_type, growth_policy> generations_;
+};
+} // namespace A3D
+
+#endif // CONTAINER_GENERATIONAL_SPARSE_MAP_H
@@ -0,0 +1,107 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_GROWTH_POLICY_H
+#define CONTAINER_GROWTH_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits>
+
+namespace A3D
+{
+// Growth policy computes new container capacity when container runs out of it.
+// Every policy provides single static function:
+//   SizeType grow(SizeType capacity, SizeType required, size_t value_size)
+// capacity   - current capacity in elements,
+// required   - minimal capacity in elements, that must fit after growth,
+// value_size - size of one element in bytes.
+// Result is never less than required and never overflows SizeType.
+
+namespace growth
+{
+template <typename SizeType>
+inline constexpr SizeType clamp(size_t capacity, SizeType required) noexcept
+{
+	constexpr size_t max_capacity = static_cast<size_t>(std::numeric_limits<SizeType>::max());
+	if (capacity > max_capacity)
+		capacity = max_capacity;
+	if (capacity < static_cast<size_t>(required))
+		capacity = static_cast<size_t>(required);
+	return static_cast<SizeType>(capacity);
+}
+} // namespace growth
+
+// Grow by constant count of elements.
+// Reallocation count is linear, use it only for containers with well known upper bound.
+template <size_t Step = 16>
+struct growth_linear
+{
+	static_assert(Step > 0);
+
+	template <typename SizeType>
+	static constexpr SizeType grow(SizeType capacity, SizeType required, [[maybe_unused]] size_t value_size) noexcept
+	{
+		return growth::clamp<SizeType>(static_cast<size_t>(capacity) + Step, required);
+	}
+};
+
+// Multiply capacity by Numerator / Denominator, but allocate at least Minimum elements.
+// Gives amortized O(1) insertion.
+template <size_t Numerator, size_t Denominator, size_t Minimum = 16>
+struct growth_geometric
+{
+	static_assert(Numerator > Denominator);
+	static_assert(Denominator > 0);
+	static_assert(Minimum > 0);
+
+	template <typename SizeType>
+	static constexpr SizeType grow(SizeType capacity, SizeType required, [[maybe_unused]] size_t value_size) noexcept
+	{
+		size_t ret = static_cast<size_t>(capacity) * Numerator / Denominator;
+		if (ret < Minimum)
+			ret = Minimum;
+		return growth::clamp<SizeType>(ret, required);
+	}
+};
+
+// Grow by whole memory pages, so that allocator never leaves half-used page in the tail.
+// Useful for huge arrays being allocated directly by system pages.
+template <size_t PageSize = 4096>
+struct growth_paged
+{
+	static_assert(PageSize > 0);
+	static_assert((PageSize & (PageSize - 1)) == 0, "Page size must be power of two.");
+
+	template <typename SizeType>
+	static constexpr SizeType grow(SizeType capacity, SizeType required, size_t value_size) noexcept
+	{
+		size_t bytes = static_cast<size_t>(capacity) * value_size + PageSize;
+		if (bytes < static_cast<size_t>(required) * value_size)
+			bytes = static_cast<size_t>(required) * value_size;
+		bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+		return growth::clamp<SizeType>(bytes / value_size, required);
+	}
+};
+
+using growth_x1_5 = growth_geometric<3, 2>;
+using growth_x2 = growth_geometric<2, 1>;
+using growth_default = growth_x1_5;
+} // namespace A3D
+
+#endif // CONTAINER_GROWTH_POLICY_H
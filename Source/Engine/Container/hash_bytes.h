@@ -0,0 +1,163 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_HASH_BYTES_H
+#define CONTAINER_HASH_BYTES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace A3D
+{
+// 64-bit wyhash (final version 4) of byte string. Input is consumed in 8 and 16 byte words,
+// so hashing cost is dominated by one 64x64->128 multiplication per 16 bytes.
+// Words are assembled little-endian byte by byte: result is the same on any platform and in
+// constant evaluation, and compilers fold assembly into single load on little-endian targets.
+namespace hash_detail
+{
+inline constexpr uint64_t HASH_SECRET[4] = { 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull };
+
+constexpr void mum(uint64_t& a, uint64_t& b) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	const __uint128_t r = static_cast<__uint128_t>(a) * b;
+	a = static_cast<uint64_t>(r);
+	b = static_cast<uint64_t>(r >> 64);
+#else
+	const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+	const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	const uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	const uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	a = lo;
+	b = hi;
+#endif
+}
+
+constexpr uint64_t mix(uint64_t a, uint64_t b) noexcept
+{
+	mum(a, b);
+	return a ^ b;
+}
+
+template <typename Char>
+constexpr uint64_t read8(const Char* p) noexcept
+{
+	return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[1])) << 8 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[2])) << 16 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[3])) << 24 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[4])) << 32 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[5])) << 40 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[6])) << 48 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[7])) << 56;
+}
+
+template <typename Char>
+constexpr uint64_t read4(const Char* p) noexcept
+{
+	return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[1])) << 8 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[2])) << 16 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[3])) << 24;
+}
+
+// Reads 1 to 3 bytes.
+template <typename Char>
+constexpr uint64_t read3(const Char* p, size_t length) noexcept
+{
+	return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[length >> 1])) << 8 |
+		   static_cast<uint64_t>(static_cast<uint8_t>(p[length - 1]));
+}
+} // namespace hash_detail
+
+template <typename Char>
+constexpr uint64_t hash_bytes(const Char* data, size_t length, uint64_t seed = 0) noexcept
+{
+	static_assert(sizeof(Char) == 1, "Only byte strings are supported.");
+
+	using namespace hash_detail;
+
+	const Char* p = data;
+	uint64_t a, b;
+
+	seed ^= mix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+
+	if (length <= 16)
+	{
+		if (length >= 4)
+		{
+			const size_t shift = (length >> 3) << 2;
+			a = (read4(p) << 32) | read4(p + shift);
+			b = (read4(p + length - 4) << 32) | read4(p + length - 4 - shift);
+		}
+		else if (length > 0)
+		{
+			a = read3(p, length);
+			b = 0;
+		}
+		else
+			a = b = 0;
+	}
+	else
+	{
+		size_t i = length;
+		if (i > 48)
+		{
+			uint64_t see1 = seed, see2 = seed;
+			do
+			{
+				seed = mix(read8(p) ^ HASH_SECRET[1], read8(p + 8) ^ seed);
+				see1 = mix(read8(p + 16) ^ HASH_SECRET[2], read8(p + 24) ^ see1);
+				see2 = mix(read8(p + 32) ^ HASH_SECRET[3], read8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16)
+		{
+			seed = mix(read8(p) ^ HASH_SECRET[1], read8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = read8(p + i - 16);
+		b = read8(p + i - 8);
+	}
+
+	a ^= HASH_SECRET[1];
+	b ^= seed;
+	mum(a, b);
+	return mix(a ^ HASH_SECRET[0] ^ length, b ^ HASH_SECRET[1]);
+}
+
+// Hash of zero-terminated string.
+template <typename Char>
+constexpr uint64_t hash_string(const Char* str) noexcept
+{
+	size_t length = 0;
+	while (str[length])
+		++length;
+	return hash_bytes(str, length);
+}
+} // namespace A3D
+
+#endif // CONTAINER_HASH_BYTES_H
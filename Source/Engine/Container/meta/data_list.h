@@ -19,7 +19,9 @@
 #ifndef CONTAINER_META_DATA_LIST_H
 #define CONTAINER_META_DATA_LIST_H
 
+#include <stddef.h>
 #include <type_traits>
+#include <utility>
 #include "types_list.h"
 
 namespace A3D
@@ -218,6 +220,56 @@ constexpr void data_list_foreach_by_tags(DataList1& dl1, DataList2& dl2, DataLis
 	}
 }
 
+// =========================================
+// Index based access to data list items
+// =========================================
+
+template <size_t Index, typename DataList>
+constexpr decltype(auto) data_list_at(DataList& dl) noexcept
+{
+	if constexpr (Index == 0)
+		return (dl.value);
+	else
+		return data_list_at<Index - 1>(dl.next);
+}
+
+template <typename Tag, typename TagsList, typename DataList>
+constexpr decltype(auto) get_tag(DataList& dl) noexcept
+{
+	return data_list_at<index_of<Tag, TagsList>::value>(dl);
+}
+
+template <typename DataList, typename Functor>
+constexpr void foreach(DataList& dl, Functor&& unary_op)
+{
+	data_list_foreach(dl, std::forward<Functor>(unary_op));
+}
+
+template <typename DataList1, typename DataList2, typename Functor>
+constexpr void foreach(DataList1& dl1, DataList2& dl2, Functor&& binary_op)
+{
+	data_list_foreach(dl1, dl2, std::forward<Functor>(binary_op));
+}
+
+template <typename SelectedTags, typename AllTags> struct foreach_tags_impl;
+
+template <template <typename...> typename List, typename... Selected, typename AllTags>
+struct foreach_tags_impl<List<Selected...>, AllTags>
+{
+	template <typename DataList1, typename DataList2, typename Functor, size_t... Index>
+	static constexpr void apply(DataList1& dst, DataList2& src, Functor& binary_op, std::index_sequence<Index...>)
+	{
+		(binary_op(data_list_at<Index>(dst), get_tag<Selected, AllTags>(src)), ...);
+	}
+};
+
+// Pairs items of dst in order with items of src selected by tags.
+template <typename SelectedTags, typename AllTags, typename DataList1, typename DataList2, typename Functor>
+constexpr void foreach_tags(DataList1& dst, DataList2& src, Functor&& binary_op)
+{
+	foreach_tags_impl<SelectedTags, AllTags>::apply(dst, src, binary_op, std::make_index_sequence<list_size<SelectedTags>::value>{});
+}
+
 } // namespace meta
 } // namespace A3D
 
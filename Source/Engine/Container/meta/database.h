@@ -19,12 +19,18 @@
 #ifndef CONTAINER_META_DATABASE_H
 #define CONTAINER_META_DATABASE_H
 
+#include <stddef.h>
 #include <stdint.h>
-#include <string.h>
-#include <bit>
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <span>
+#include <tuple>
 #include <utility>
+#include "Container/vector.h"
+#include "database_primary_index.h"
+#include "database_secondary_index.h"
 #include "database_table.h"
 #include "types_list.h"
 
@@ -34,40 +40,68 @@ namespace db
 {
 struct primary_key {};
 
+// Rows stored as structure of arrays in fixed size chunks: every chunk keeps all columns for chunk_rows rows.
+// Columns are accessed by tags, so that the same type may be stored in several columns.
+// Growth adds new chunk and never moves existing rows, so that growth cost does not depend on rows count.
+// Rows are referred to by primary keys, which stay valid until row is erased. Erase moves the last row
+// into the hole, primary key index maps keys to their current rows, primary_key column maps rows back.
+// Secondary indices map values of their columns to primary keys. They are maintained by insert, erase
+// and update, so that secondary key columns must be changed through update only.
 template <typename SizeType,
 		  typename ChunkType,
 		  typename DataTypesList,
 		  typename TagsTypesList,
+		  typename SecondaryKeysList = meta::types_list<>,
 		  typename Allocator = std::allocator<uint8_t>>
 class database
 {
 public:
 	using size_type = SizeType;
 	using primary_index = SizeType;
-	using internal_index = SizeType;
 	using data_types = DataTypesList;
-	using data_types_list = meta::make_data_list<data_types>;
 	using tags_types = TagsTypesList;
-	using data_table = database_table<data_types_list, size_type>;
+	using data_table = database_table<data_types, size_type>;
 	using chunk_type = ChunkType;
-	using primary_indices = pkey::map<size_type, chunk_type>;
+	using keys_index = db::primary_index::index<size_type, chunk_type>;
+	using secondary_keys = SecondaryKeysList;
 	using allocator_type = Allocator;
 
-	enum { grow_factor = sizeof(size_type) * 8 };
+	template <typename Tag>
+	using column_type = typename meta::type_by_tag<Tag, tags_types, data_types>::type;
+
+	template <typename Key>
+	using secondary_index_type = secondary_index::index<typename Key::kind, typename Key::tag, column_type<typename Key::tag>, size_type, allocator_type>;
+
+	// Rows of chunk are fitted into chunk_memory_size, single row bigger than it gets chunk of its own size.
+	static constexpr size_t chunk_memory_size = 16 * 1024;
+	static constexpr size_type chunk_rows = []
+	{
+		// Estimate ignores column padding, which is then taken off by whole rows.
+		size_t rows = std::max<size_t>(1, (chunk_memory_size - std::min(chunk_memory_size, data_table::memory_size(0))) / data_table::row_sizeof);
+		while (rows > 1 && data_table::memory_size(rows) > chunk_memory_size)
+			--rows;
+		return static_cast<size_type>(rows);
+	}();
+	static constexpr size_t chunk_bytes = std::max(chunk_memory_size, data_table::memory_size(chunk_rows));
+	static constexpr primary_index invalid_key = std::numeric_limits<primary_index>::max();
+	static constexpr size_t cache_line_size = 64;
 
 	template <typename... Tags>
-	using iterator = table::iterator<data_table, tags_types, typename meta::types_list_builder<Tags...>::type>;
+	using iterator = typename data_table::template iterator<meta::types_list<Tags...>, tags_types>;
 
 	template <typename... Tags>
-	using const_iterator = table::const_iterator<data_table, tags_types, typename meta::types_list_builder<Tags...>::type>;
+	using const_iterator = typename data_table::template const_iterator<meta::types_list<Tags...>, tags_types>;
 
-	using iterator_all = table::iterator<data_table, tags_types, tags_types>;
-	using const_iterator_all = table::const_iterator<data_table, tags_types, tags_types>;
+	using iterator_all = typename data_table::template iterator<tags_types, tags_types>;
+	using const_iterator_all = typename data_table::template const_iterator<tags_types, tags_types>;
 
 	database() :
+		keys_memory_(nullptr),
 		size_(0),
-		capacity_(0)
+		keys_capacity_(0),
+		keys_hint_(0)
 	{
+		static_assert(meta::index_of<primary_key, tags_types>::value < meta::list_size<tags_types>::value);
 	}
 
 	~database()
@@ -75,153 +109,662 @@ public:
 		release();
 	}
 
-	bool empty() const noexcept { return size_ == 0; }
-	size_type capacity() const noexcept { return capacity_; }
+	database(const database&) = delete;
+	void operator=(const database&) = delete;
+
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
 	size_type size() const noexcept { return size_; }
 
+	// Rows count that fits into used and pooled chunks without new allocations.
+	size_type capacity() const noexcept
+	{
+		return static_cast<size_type>((chunks_.size() + free_chunks_.size()) * chunk_rows);
+	}
+
+	// Chunks holding rows. Every chunk except the last one is full.
+	size_type chunks_count() const noexcept { return chunks_.size(); }
+
+	size_type chunk_size(size_type chunk) const noexcept
+	{
+		return chunk + 1 < chunks_.size() ? chunk_rows : static_cast<size_type>(size_ - chunk * chunk_rows);
+	}
+
 	template <typename... Tags>
-	iterator<Tags...> begin() noexcept
+	iterator<Tags...> begin(size_type chunk) noexcept
 	{
-		return iterator<Tags...>(data_);
+		return chunks_[chunk].table.template begin<meta::types_list<Tags...>, tags_types>();
 	}
 
 	template <typename... Tags>
-	const_iterator<Tags...> begin() const noexcept
+	const_iterator<Tags...> begin(size_type chunk) const noexcept
 	{
-		return const_iterator<Tags...>(data_);
+		return chunks_[chunk].table.template begin<meta::types_list<Tags...>, tags_types>();
 	}
 
 	template <typename... Tags>
-	const_iterator<Tags...> cbegin() const noexcept
+	const_iterator<Tags...> cbegin(size_type chunk) const noexcept
 	{
-		return const_iterator<Tags...>(data_);
+		return chunks_[chunk].table.template cbegin<meta::types_list<Tags...>, tags_types>();
 	}
 
 	template <typename... Tags>
-	iterator<Tags...> end() noexcept
+	iterator<Tags...> end(size_type chunk) noexcept
 	{
-		return iterator<Tags...>(data_, size_);
+		return chunks_[chunk].table.template mid<meta::types_list<Tags...>, tags_types>(chunk_size(chunk));
 	}
 
 	template <typename... Tags>
-	const_iterator<Tags...> end() const noexcept
+	const_iterator<Tags...> end(size_type chunk) const noexcept
 	{
-		return const_iterator<Tags...>(data_, size_);
+		return chunks_[chunk].table.template mid<meta::types_list<Tags...>, tags_types>(chunk_size(chunk));
 	}
 
 	template <typename... Tags>
-	const_iterator<Tags...> cend() const noexcept
+	const_iterator<Tags...> cend(size_type chunk) const noexcept
 	{
-		return const_iterator<Tags...>(data_, size_);
+		return chunks_[chunk].table.template cmid<meta::types_list<Tags...>, tags_types>(chunk_size(chunk));
 	}
 
-	iterator_all abegin() noexcept { return iterator_all(data_); }
-	const_iterator_all abegin() const noexcept { return const_iterator_all(data_); }
-	const_iterator_all cabegin() const noexcept { return const_iterator_all(data_); }
+	iterator_all abegin(size_type chunk) noexcept { return chunks_[chunk].table.template abegin<tags_types>(); }
+	const_iterator_all abegin(size_type chunk) const noexcept { return chunks_[chunk].table.template abegin<tags_types>(); }
+	const_iterator_all cabegin(size_type chunk) const noexcept { return chunks_[chunk].table.template cabegin<tags_types>(); }
+
+	iterator_all aend(size_type chunk) noexcept { return chunks_[chunk].table.template amid<tags_types>(chunk_size(chunk)); }
+	const_iterator_all aend(size_type chunk) const noexcept { return chunks_[chunk].table.template amid<tags_types>(chunk_size(chunk)); }
+	const_iterator_all caend(size_type chunk) const noexcept { return chunks_[chunk].table.template camid<tags_types>(chunk_size(chunk)); }
 
-	iterator_all aend() noexcept { return iterator_all(data_, size_); }
-	const_iterator_all aend() const noexcept { return const_iterator_all(data_, size_); }
-	const_iterator_all caend() const noexcept { return const_iterator_all(data_, size_); }
+	// Column of chunk rows aligned by column_alignment. Loads may read past the last row up to the next
+	// multiple of column_alignment bytes, so that SIMD kernels need no scalar tail.
+	template <typename Tag>
+	std::span<column_type<Tag>> column(size_type chunk) noexcept
+	{
+		return chunks_[chunk].table.template column<Tag, tags_types>(chunk_size(chunk));
+	}
+
+	template <typename Tag>
+	std::span<const column_type<Tag>> column(size_type chunk) const noexcept
+	{
+		return chunks_[chunk].table.template column<Tag, tags_types>(chunk_size(chunk));
+	}
+
+	// Calls function with references to Tags columns of every row, chunk by chunk.
+	template <typename... Tags, typename Function>
+	void for_each(Function&& function)
+	{
+		for (size_type chunk = 0; chunk < chunks_.size(); ++chunk)
+		{
+			const iterator<Tags...> last = end<Tags...>(chunk);
+			for (iterator<Tags...> it = begin<Tags...>(chunk); it != last; ++it)
+				function(it.template get<Tags>()...);
+		}
+	}
+
+	template <typename... Tags, typename Function>
+	void for_each(Function&& function) const
+	{
+		for (size_type chunk = 0; chunk < chunks_.size(); ++chunk)
+		{
+			const const_iterator<Tags...> last = end<Tags...>(chunk);
+			for (const_iterator<Tags...> it = begin<Tags...>(chunk); it != last; ++it)
+				function(static_cast<const typename meta::type_by_tag<Tags, tags_types, data_types>::type&>(it.template get<Tags>())...);
+		}
+	}
+
+	// Runs function over Tags columns of every row on pool, which is WorkerPool or anything with the same Run.
+	// Every chunk is split into tasks of grain rows, grain is rounded up to whole cache lines of every column,
+	// so that tasks never write into the same cache line. Partition depends on rows count and grain only.
+	template <typename... Tags, typename Pool, typename Function>
+	void parallel_for_each(Pool& pool, Function&& function, size_type grain = chunk_rows)
+	{
+		if (size_ == 0)
+			return;
+
+		parallel_context<std::remove_reference_t<Function>, void> context{ this, &function, nullptr, task_grain<Tags...>(grain), nullptr };
+		pool.Run(tasks_count(context.grain), &parallel_task<std::remove_reference_t<Function>, void, Tags...>, &context);
+	}
+
+	// Every task folds its rows into own partial value, starting from identity, by function(partial, columns...).
+	// Partials are then combined by reduce(result, partial) in tasks order on calling thread, so that result is
+	// the same on every run and for any threads count, floating point sums included. When partials can not be
+	// allocated, the same tasks are folded one by one on calling thread, so that result is still the same.
+	template <typename... Tags, typename Pool, typename T, typename Function, typename Reduce>
+	T parallel_reduce(Pool& pool, const T& identity, Function&& function, Reduce&& reduce, size_type grain = chunk_rows)
+	{
+		if (size_ == 0)
+			return identity;
+
+		using partials_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<T>;
+		partials_allocator_type partials_alloc(alloc_);
+
+		const size_type task_rows = task_grain<Tags...>(grain);
+		const uint32_t count = tasks_count(task_rows);
+		T* partials = partials_alloc.allocate(count);
+		if (partials == nullptr)
+		{
+			// Same partition folded on calling thread, so that result does not depend on allocation success.
+			T result = identity;
+			for (uint32_t task = 0; task < count; ++task)
+			{
+				T partial = identity;
+				task_for_each<Tags...>(task_rows, task, [&](auto&... values) { function(partial, values...); });
+				result = reduce(std::move(result), std::move(partial));
+			}
+			return result;
+		}
+
+		parallel_context<std::remove_reference_t<Function>, T> context{ this, &function, partials, task_rows, &identity };
+		pool.Run(count, &parallel_task<std::remove_reference_t<Function>, T, Tags...>, &context);
+
+		T result = identity;
+		for (uint32_t task = 0; task < count; ++task)
+			result = reduce(std::move(result), std::move(partials[task]));
+
+		destroy_n(partials, count);
+		partials_alloc.deallocate(partials, count);
+		return result;
+	}
 
 	template <typename Tag>
 	typename meta::type_by_tag<Tag, tags_types, data_types>::type&
 	front() noexcept
 	{
-		return *meta::get_tag<Tag, tags_types>(data_);
+		return chunks_[0].table.template front<Tag, tags_types>();
 	}
 
 	template <typename Tag>
 	const typename meta::type_by_tag<Tag, tags_types, data_types>::type&
 	front() const noexcept
 	{
-		return *meta::get_tag<Tag, tags_types>(data_);
+		return chunks_[0].table.template front<Tag, tags_types>();
 	}
 
 	template <typename Tag>
 	typename meta::type_by_tag<Tag, tags_types, data_types>::type&
 	back() noexcept
 	{
-		return *meta::get_tag<Tag, tags_types>(end().ptr()) - 1;
+		return row_at<Tag>(static_cast<size_type>(size_ - 1));
 	}
 
 	template <typename Tag>
 	const typename meta::type_by_tag<Tag, tags_types, data_types>::type&
 	back() const noexcept
 	{
-		return *meta::get_tag<Tag, tags_types>(end().ptr()) - 1;
+		return row_at<Tag>(static_cast<size_type>(size_ - 1));
 	}
 
-	std::pair<primary_index, iterator_all> insert()
+	template <typename Tag>
+	typename meta::type_by_tag<Tag, tags_types, data_types>::type&
+	at(primary_index key) noexcept
 	{
-		if (size_ + 1 > capacity_)
-			data_add_chunk();
+		return row_at<Tag>(keys_[key]);
+	}
 
-		const primary_index key = size_;
+	template <typename Tag>
+	const typename meta::type_by_tag<Tag, tags_types, data_types>::type&
+	at(primary_index key) const noexcept
+	{
+		return row_at<Tag>(keys_[key]);
+	}
 
-		iterator_all it = aend();
-		table::construct(it);
+	bool contains(primary_index key) const noexcept { return key < keys_capacity_ && keys_.contains(key); }
 
-		return std::make_pair<primary_index, iterator_all>(key, it);
+	// Current row of key. Rows are changed by erase of other keys, never by growth.
+	size_type get_row(primary_index key) const noexcept { return keys_[key]; }
+
+	// Keys of rows with value of secondary key column. Unique index finds single key, others any of them.
+	template <typename Tag>
+	primary_index find(const column_type<Tag>& value) const noexcept
+	{
+		return secondary<Tag>().find(value);
+	}
+
+	template <typename Tag>
+	std::span<const primary_index> equal_range(const column_type<Tag>& value) const noexcept
+	{
+		return secondary<Tag>().equal_range(value);
+	}
+
+	// Keys of rows with values in [min, max), available for sorted index only.
+	template <typename Tag>
+	std::span<const primary_index> range(const column_type<Tag>& min, const column_type<Tag>& max) const noexcept
+	{
+		return secondary<Tag>().range(min, max);
+	}
+
+	// Sets column value of row and moves key of row inside secondary index of column, when there is one.
+	// Returns false when unique index already has the value, row keeps the old one then.
+	template <typename Tag, typename Value>
+	bool update(primary_index key, Value&& value)
+	{
+		column_type<Tag>& column = at<Tag>(key);
+		if constexpr (meta::list_contains<Tag, secondary_tags>::value)
+		{
+			auto& index = secondary<Tag>();
+			index.erase(column, key);
+			if (!index.insert(value, key))
+			{
+				index.insert(column, key);
+				return false;
+			}
+		}
+		column = std::forward<Value>(value);
+		return true;
+	}
+
+	// Appends row with single value per secondary key, in order of their declaration, other columns are
+	// default constructed. Returns its key and iterator, or invalid_key when out of memory or unique
+	// secondary index already has the value.
+	template <typename... Values>
+	std::pair<primary_index, iterator_all> insert(Values&&... values)
+	{
+		static_assert(sizeof...(Values) == secondary_count, "Database insertion requires single value per secondary key.");
+
+		if (size_ == chunks_.size() * chunk_rows && !data_add_chunk())
+			return std::make_pair(invalid_key, iterator_all());
+
+		if (size_ == keys_capacity_ && !keys_add_chunk())
+			return std::make_pair(invalid_key, iterator_all());
+
+		const primary_index key = keys_.insert(size_, keys_index::states_count(keys_capacity_), keys_hint_);
+		keys_hint_ = keys_index::get_chunk_id(key);
+
+		iterator_all it = row_iterator(size_);
+		chunks_.back().table.template create<tags_types>(it);
+		it.template get<primary_key>() = key;
+		++size_;
+
+		if constexpr (secondary_count > 0)
+		{
+			secondary_assign(it, std::make_index_sequence<secondary_count>{}, std::forward<Values>(values)...);
+			if (!secondary_insert(key, static_cast<size_type>(size_ - 1)))
+			{
+				keys_erase(key);
+				remove_row(static_cast<size_type>(size_ - 1));
+				return std::make_pair(invalid_key, iterator_all());
+			}
+		}
+
+		return std::make_pair(key, it);
 	}
 
+	// Moves the last row into the hole, so that chunks stay dense.
 	void erase(primary_index key)
 	{
+		const size_type row = keys_[key];
+		secondary_erase(key, row);
+		keys_erase(key);
+		remove_row(row);
 	}
 
-private:
-	void release()
+	// Erase count unique keys at once. Keys array is overwritten by rows and sorted in place.
+	// Holes are filled by surviving rows from the tail, so that every row is moved at most once.
+	void erase_batch(primary_index* keys, size_type count)
 	{
-		if (capacity_ > 0)
+		for (size_type i = 0; i < count; ++i)
 		{
-			if (size_ > 0)
-				table::destroy_n(data_, size_);
+			const primary_index key = keys[i];
+			keys[i] = keys_[key];
+			secondary_erase(key, keys[i]);
+			keys_erase(key);
 		}
+
+		std::sort(keys, keys + count);
+
+		const size_type new_size = static_cast<size_type>(size_ - count);
+		const size_type* hole = keys;
+		const size_type* erased_tail = std::lower_bound(keys, keys + count, new_size);
+		const size_type* const keys_end = keys + count;
+
+		for (size_type src = new_size; hole < erased_tail; ++src)
+		{
+			if (erased_tail < keys_end && *erased_tail == src)
+			{
+				++erased_tail;
+				continue;
+			}
+			move_row(*hole++, src);
+		}
+
+		for (size_type row = new_size; row < size_; ++row)
+		{
+			iterator_all it = row_iterator(row);
+			chunks_[row / chunk_rows].table.template destroy<tags_types>(it);
+		}
+		size_ = new_size;
+		release_empty_chunks();
+	}
+
+	void clear()
+	{
+		for (size_type chunk = 0; chunk < chunks_.size(); ++chunk)
+			chunks_[chunk].table.destroy_n(chunk_size(chunk));
+		size_ = 0;
+		release_empty_chunks();
+
+		std::apply([](auto&... index) { (index.clear(), ...); }, secondary_);
+		if (keys_capacity_ > 0)
+			keys_.clear(keys_index::states_count(keys_capacity_));
+		keys_hint_ = 0;
+	}
+
+	// Fills chunk pool up to count rows capacity.
+	bool reserve(size_type count)
+	{
+		while (capacity() < count)
+		{
+			uint8_t* memory = alloc_.allocate(chunk_bytes);
+			if (memory == nullptr)
+				return false;
+			if (!free_chunks_.push_back(memory))
+			{
+				alloc_.deallocate(memory, chunk_bytes);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Returns pooled chunks to allocator. Chunks with rows are never moved.
+	bool shrink_to_fit()
+	{
+		free_chunks_release();
+		chunks_.shrink_to_fit();
+		free_chunks_.shrink_to_fit();
+		return true;
+	}
+
+	// Key index is never shrunk, or keys of live rows would be lost.
+	size_t memory_size() const noexcept
+	{
+		return (chunks_.size() + free_chunks_.size()) * chunk_bytes + chunks_.memory_size() + free_chunks_.memory_size() +
+			   keys_memory_size(keys_capacity_) +
+			   std::apply([](const auto&... index) { return (static_cast<size_t>(0) + ... + index.memory_size()); }, secondary_);
+	}
+
+private:
+	// Table of chunk points its columns into memory block of chunk_bytes.
+	struct chunk
+	{
+		data_table table;
+		uint8_t* memory;
+	};
+
+	template <typename List> struct secondary_list;
+
+	template <template <typename...> typename List, typename... Keys>
+	struct secondary_list<List<Keys...>>
+	{
+		using tags = meta::types_list<typename Keys::tag...>;
+		using indices = std::tuple<secondary_index_type<Keys>...>;
+	};
+
+	using secondary_tags = typename secondary_list<secondary_keys>::tags;
+	using secondary_indices = typename secondary_list<secondary_keys>::indices;
+
+	static constexpr size_t secondary_count = std::tuple_size_v<secondary_indices>;
+
+	using chunks_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<chunk>;
+	using free_chunks_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<uint8_t*>;
+
+	template <typename Tag>
+	typename meta::type_by_tag<Tag, tags_types, data_types>::type&
+	row_at(size_type row) noexcept
+	{
+		return chunks_[row / chunk_rows].table.template at<Tag, tags_types>(row % chunk_rows);
+	}
+
+	template <typename Tag>
+	const typename meta::type_by_tag<Tag, tags_types, data_types>::type&
+	row_at(size_type row) const noexcept
+	{
+		return chunks_[row / chunk_rows].table.template at<Tag, tags_types>(row % chunk_rows);
 	}
 
-	void data_add_chunk()
+	iterator_all row_iterator(size_type row) noexcept
 	{
-		if (capacity_ > 0)
+		return chunks_[row / chunk_rows].table.template amid<tags_types>(row % chunk_rows);
+	}
+
+	template <typename Function, typename T>
+	struct parallel_context
+	{
+		database* db;
+		Function* function;
+		T* partials;
+		size_type grain;
+		const T* identity;
+	};
+
+	// Grain rounded up to rows count filling whole cache lines in every column and cut to chunk size.
+	template <typename... Tags>
+	static constexpr size_type task_grain(size_type grain) noexcept
+	{
+		size_t line_rows = 1;
+		((line_rows = std::lcm(line_rows, cache_line_size / std::gcd(cache_line_size, sizeof(column_type<Tags>)))), ...);
+
+		const size_t rows = (std::max<size_t>(grain, 1) + line_rows - 1) / line_rows * line_rows;
+		return static_cast<size_type>(std::min<size_t>(rows, chunk_rows));
+	}
+
+	static constexpr size_type tasks_per_chunk(size_type grain) noexcept
+	{
+		return static_cast<size_type>((chunk_rows + grain - 1) / grain);
+	}
+
+	uint32_t tasks_count(size_type grain) const noexcept
+	{
+		return static_cast<uint32_t>(chunks_.size() * tasks_per_chunk(grain));
+	}
+
+	// Task of the last chunk may have no rows, its partial is identity then.
+	template <typename... Tags, typename Function>
+	void task_for_each(size_type grain, uint32_t task, Function&& function)
+	{
+		const size_type per_chunk = tasks_per_chunk(grain);
+		const size_type chunk = static_cast<size_type>(task / per_chunk);
+		const size_type rows = chunk_size(chunk);
+		const size_type first = std::min(static_cast<size_type>((task % per_chunk) * grain), rows);
+		const size_type last = std::min(static_cast<size_type>(first + grain), rows);
+
+		iterator<Tags...> it = chunks_[chunk].table.template mid<meta::types_list<Tags...>, tags_types>(first);
+		const iterator<Tags...> end = chunks_[chunk].table.template mid<meta::types_list<Tags...>, tags_types>(last);
+		for (; it != end; ++it)
+			function(it.template get<Tags>()...);
+	}
+
+	template <typename Function, typename T, typename... Tags>
+	static void parallel_task(void* data, uint32_t task)
+	{
+		parallel_context<Function, T>& context = *static_cast<parallel_context<Function, T>*>(data);
+
+		if constexpr (std::is_void_v<T>)
 		{
-			data_table new_data;
-			table::allocate(new_data, alloc_, capacity_ + grow_factor);
-			if (size_ > 0)
-				table::move_construct(new_data, data_, size_);
-			table::destruct(data_, size_);
-			table::deallocate(data_, alloc_, capacity_);
-			table::set_pointer(data_, new_data);
-			capacity_ += grow_factor;
+			context.db->template task_for_each<Tags...>(context.grain, task, *context.function);
 		}
 		else
 		{
-			table::allocate(data_, alloc_, grow_factor);
-			capacity_ = grow_factor;
+			T partial = *context.identity;
+			context.db->template task_for_each<Tags...>(context.grain, task, [&](auto&... values) { (*context.function)(partial, values...); });
+			std::construct_at(&context.partials[task], std::move(partial));
 		}
 	}
 
-	void data_shrink()
+	template <typename Tag>
+	auto& secondary() noexcept
+	{
+		return std::get<meta::index_of<Tag, secondary_tags>::value>(secondary_);
+	}
+
+	template <typename Tag>
+	const auto& secondary() const noexcept
+	{
+		return std::get<meta::index_of<Tag, secondary_tags>::value>(secondary_);
+	}
+
+	template <size_t... Index, typename... Values>
+	void secondary_assign(iterator_all& it, std::index_sequence<Index...>, Values&&... values)
+	{
+		((it.template get<typename std::tuple_element_t<Index, secondary_indices>::tag_type>() = std::forward<Values>(values)), ...);
+	}
+
+	// Indexes row in every secondary index, already indexed ones are rolled back on failure.
+	template <size_t Index = 0>
+	bool secondary_insert(primary_index key, size_type row)
 	{
-		if (size_ > 0)
+		if constexpr (Index == secondary_count)
+			return true;
+		else
 		{
-			data_table new_data;
-			table::allocate(new_data, alloc_, size_);
-			table::move_construct(new_data, data_, size_);
-			table::destruct(data_, size_);
-			table::deallocate(data_, alloc_, capacity_);
-			table::set_pointer(data_, new_data);
+			using tag = typename std::tuple_element_t<Index, secondary_indices>::tag_type;
+			auto& index = std::get<Index>(secondary_);
+			if (!index.insert(row_at<tag>(row), key))
+				return false;
+			if (secondary_insert<Index + 1>(key, row))
+				return true;
+			index.erase(row_at<tag>(row), key);
+			return false;
+		}
+	}
+
+	void secondary_erase(primary_index key, size_type row)
+	{
+		std::apply([this, key, row](auto&... index)
+		{
+			(index.erase(row_at<typename std::remove_reference_t<decltype(index)>::tag_type>(row), key), ...);
+		}, secondary_);
+	}
+
+	void release()
+	{
+		clear();
+		free_chunks_release();
+		if (keys_capacity_ > 0)
+		{
+			alloc_.deallocate(keys_memory_, keys_memory_size(keys_capacity_));
+			keys_memory_ = nullptr;
+			keys_capacity_ = 0;
+		}
+	}
+
+	void free_chunks_release()
+	{
+		for (uint8_t* memory : free_chunks_)
+			alloc_.deallocate(memory, chunk_bytes);
+		free_chunks_.clear();
+	}
+
+	// Moves row from src into dst and points key of moved row to its new place.
+	void move_row(size_type dst, size_type src)
+	{
+		chunks_[dst / chunk_rows].table.template move<tags_types>(row_iterator(dst), row_iterator(src));
+		keys_[row_at<primary_key>(dst)] = dst;
+	}
+
+	void remove_row(size_type row)
+	{
+		const size_type last = static_cast<size_type>(size_ - 1);
+		if (row != last)
+			move_row(row, last);
+
+		iterator_all it = row_iterator(last);
+		chunks_.back().table.template destroy<tags_types>(it);
+		--size_;
+		release_empty_chunks();
+	}
+
+	void keys_erase(primary_index key)
+	{
+		keys_.erase(key);
+		keys_hint_ = std::min<size_type>(keys_hint_, keys_index::get_chunk_id(key));
+	}
+
+	// Chunks left without rows go back into the pool, so that they are reused by the next growth.
+	void release_empty_chunks()
+	{
+		while (chunks_.size() * chunk_rows >= size_ + static_cast<size_t>(chunk_rows))
+		{
+			uint8_t* memory = chunks_.back().memory;
+			chunks_.pop_back();
+			if (!free_chunks_.push_back(memory))
+				alloc_.deallocate(memory, chunk_bytes);
+		}
+	}
+
+	// Takes chunk from the pool or allocates new one. Existing chunks are not touched.
+	bool data_add_chunk()
+	{
+		if (chunks_.size() * chunk_rows > std::numeric_limits<size_type>::max() - chunk_rows)
+			return false;
+
+		uint8_t* memory;
+		if (!free_chunks_.empty())
+		{
+			memory = free_chunks_.back();
+			free_chunks_.pop_back();
 		}
 		else
 		{
-			table::destruct(data_, size_);
-			table::deallocate(data_, alloc_, capacity_);
+			memory = alloc_.allocate(chunk_bytes);
+			if (memory == nullptr)
+				return false;
+		}
+
+		chunk new_chunk;
+		new_chunk.table.allocate(memory, chunk_rows);
+		new_chunk.memory = memory;
+		if (!chunks_.push_back(new_chunk))
+		{
+			if (!free_chunks_.push_back(memory))
+				alloc_.deallocate(memory, chunk_bytes);
+			return false;
 		}
-		capacity_ = size_;
+
+		return true;
+	}
+
+	static constexpr size_t keys_memory_size(size_type capacity) noexcept
+	{
+		return keys_index::indices_size(capacity) + keys_index::states_size(capacity);
+	}
+
+	// Key space is doubled in whole chunks of states bitfield, so that copy of key index is amortized.
+	bool keys_add_chunk()
+	{
+		if (keys_capacity_ > std::numeric_limits<size_type>::max() - keys_index::chunk_size)
+			return false;
+
+		const size_type capacity = keys_capacity_ > std::numeric_limits<size_type>::max() / 2 - keys_index::chunk_size
+			? static_cast<size_type>(keys_capacity_ + keys_index::chunk_size)
+			: static_cast<size_type>(std::max<size_type>(keys_index::chunk_size, keys_capacity_ * 2));
+		uint8_t* memory = alloc_.allocate(keys_memory_size(capacity));
+		if (memory == nullptr)
+			return false;
+
+		keys_index new_keys;
+		new_keys.allocate(memory, keys_index::indices_size(capacity), keys_index::states_size(capacity));
+		new_keys.clear(keys_index::states_count(capacity));
+
+		if (keys_capacity_ > 0)
+		{
+			new_keys.copy(keys_, keys_capacity_);
+			alloc_.deallocate(keys_memory_, keys_memory_size(keys_capacity_));
+		}
+
+		keys_.copy_ptr(new_keys);
+		keys_memory_ = memory;
+		keys_capacity_ = capacity;
+
+		return true;
 	}
 
-	internal_index* primary_keys_;
-	chunk_type* states_;
-	data_table data_;
+	vector<size_type, chunk, chunks_allocator_type> chunks_;
+	vector<size_type, uint8_t*, free_chunks_allocator_type> free_chunks_;
+	keys_index keys_;
+	secondary_indices secondary_;
+	uint8_t* keys_memory_;
 	size_type size_;
-	size_type capacity_;
+	size_type keys_capacity_;
+	size_type keys_hint_;
 	allocator_type alloc_;
 };
 } // namespace db
@@ -20,6 +20,7 @@
 #define CONTAINER_META_DATABASE_BUILDER_H
 
 #include "database.h"
+#include "database_secondary_index.h"
 
 namespace A3D
 {
@@ -30,6 +31,7 @@ template <typename SizeType = uint16_t,
 		  typename IndexTagsList = meta::types_list_builder<>,
 		  typename DataTypesList = meta::types_list_builder<>,
 		  typename TagsTypesList = meta::types_list_builder<>,
+		  typename IndexKindsList = meta::types_list_builder<>,
 		  typename Allocator = std::allocator<uint8_t>>
 struct database_builder
 {
@@ -38,6 +40,7 @@ struct database_builder
 	using secondary_index_tags_list = IndexTagsList;
 	using data_types_list = DataTypesList;
 	using data_tags_list = TagsTypesList;
+	using secondary_index_kinds_list = IndexKindsList;
 	using allocator_type = Allocator;
 
 	template <typename T>
@@ -49,18 +52,21 @@ struct database_builder
 		secondary_index_tags_list,
 		data_types_list,
 		data_tags_list,
+		secondary_index_kinds_list,
 		allocator_type
 	>;
 
-	template <typename T, typename U>
+	// Column of type T marked by tag U, indexed by index of Kind: hashed_unique, hashed_multi or sorted.
+	template <typename T, typename U, typename Kind = hashed_unique>
 	using secondary_key =
 	database_builder
 	<
 		primary_index_type,
-		typename secondary_index_types_list::add<T>,
-		typename secondary_index_tags_list::add<U>,
+		typename secondary_index_types_list::template add<T>,
+		typename secondary_index_tags_list::template add<U>,
 		data_types_list,
 		data_tags_list,
+		typename secondary_index_kinds_list::template add<Kind>,
 		allocator_type
 	>;
 
@@ -71,18 +77,20 @@ struct database_builder
 		primary_index_type,
 		secondary_index_types_list,
 		secondary_index_tags_list,
-		typename data_types_list::add<T>,
-		typename data_tags_list::add<Tag>,
+		typename data_types_list::template add<T>,
+		typename data_tags_list::template add<Tag>,
+		secondary_index_kinds_list,
 		allocator_type
 	>;
 
+	// Primary key column is appended to data, secondary key columns follow it.
 	using build = database
 	<
 		primary_index_type,
 		uint32_t,
-		typename data_types_list::add<primary_index_type>::type
-		typename meta::list_join<typename data_types_list::add<primary_index_type>::type, secondary_index_types_list>::type,
-		typename meta::list_join<typename data_tags_list::add<primary_key>::type, secondary_index_tags_list>::type,
+		typename meta::list_join<typename data_types_list::template add<primary_index_type>::type, typename secondary_index_types_list::type>::type,
+		typename meta::list_join<typename data_tags_list::template add<db::primary_key>::type, typename secondary_index_tags_list::type>::type,
+		typename secondary_index::keys_list<typename secondary_index_tags_list::type, typename secondary_index_kinds_list::type>::type,
 		allocator_type
 	>;
 };
@@ -92,13 +92,16 @@ public:
 		return mem + states_size;
 	}
 
-	void copy(const index& src, size_type size) noexcept
+	// Copies indices and states of rows_count keys, rows count must be multiple of chunk size.
+	void copy(const index& src, size_type rows_count) noexcept
 	{
-		memcpy(states_, src.states_, size);
+		memcpy(indices_, src.indices_, indices_size(rows_count));
+		memcpy(states_, src.states_, states_size(rows_count));
 	}
 
 	void copy_ptr(const index& other) noexcept
 	{
+		indices_ = other.indices_;
 		states_ = other.states_;
 	}
 
@@ -107,9 +110,10 @@ public:
 		return states_[get_chunk_id(key)] & (static_cast<states_bitfield>(1) << static_cast<states_bitfield>(get_bit_id(key)));
 	}
 
-	key_type insert(value_type value, size_type states_count) noexcept
+	// Search starts from first_state, so that owner may skip states known to be full.
+	key_type insert(value_type value, size_type states_count, size_type first_state = 0) noexcept
 	{
-		for (states_bitfield* state = states_; state < states_ + states_count; ++state)
+		for (states_bitfield* state = states_ + first_state; state < states_ + states_count; ++state)
 			if (*state != chunk_full)
 			{
 				const key_type key = get_key(static_cast<chunk_id_type>(state - states_),
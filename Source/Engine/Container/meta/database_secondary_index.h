@@ -0,0 +1,300 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_META_DATABASE_SECONDARY_INDEX_H
+#define CONTAINER_META_DATABASE_SECONDARY_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include "Container/flat_map.h"
+#include "Container/vector.h"
+
+namespace A3D
+{
+namespace db
+{
+// Kinds of secondary index, selected per secondary key when database type is declared.
+struct hashed_unique {};
+struct hashed_multi {};
+struct sorted {};
+
+namespace secondary_index
+{
+// Declares index of Kind over column Tag.
+template <typename Tag, typename Kind>
+struct key
+{
+	using tag = Tag;
+	using kind = Kind;
+};
+
+// Zips tags and kinds lists of the same length into list of keys.
+template <typename TagsList, typename KindsList> struct keys_list;
+
+template <template <typename...> typename List, typename... Tags, typename... Kinds>
+struct keys_list<List<Tags...>, List<Kinds...>>
+{
+	static_assert(sizeof...(Tags) == sizeof...(Kinds));
+	using type = List<key<Tags, Kinds>...>;
+};
+
+// Maps column values to primary keys. Primary keys never change on row moves,
+// so that index is touched only by insert, erase and update of indexed column.
+template <typename Kind, typename Tag, typename T, typename SizeType, typename Allocator>
+class index;
+
+// Single key per value, insertion of duplicate value fails.
+template <typename Tag, typename T, typename SizeType, typename Allocator>
+class index<hashed_unique, Tag, T, SizeType, Allocator>
+{
+public:
+	using tag_type = Tag;
+	using value_type = T;
+	using key_type = SizeType;
+	using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<T, SizeType>>;
+
+	static constexpr key_type invalid_key = std::numeric_limits<key_type>::max();
+
+	bool insert(const value_type& value, key_type key)
+	{
+		auto [it, inserted] = keys_.try_emplace(value, key);
+		return inserted;
+	}
+
+	void erase(const value_type& value, [[maybe_unused]] key_type key) { keys_.erase(value); }
+	void clear() { keys_.clear(); }
+
+	key_type find(const value_type& value) const noexcept
+	{
+		const auto it = keys_.find(value);
+		return it != keys_.end() ? it->second : invalid_key;
+	}
+
+	std::span<const key_type> equal_range(const value_type& value) const noexcept
+	{
+		const auto it = keys_.find(value);
+		if (it == keys_.end())
+			return {};
+		return { &it->second, 1 };
+	}
+
+	size_t memory_size() const noexcept { return keys_.memory_size(); }
+
+private:
+	flat_map<value_type, key_type, std::hash<value_type>, std::equal_to<value_type>, allocator_type> keys_;
+};
+
+// Bucket of keys per value. Position of every key inside its bucket is kept by key,
+// so that erase swaps it with the last key of bucket instead of searching the bucket.
+template <typename Tag, typename T, typename SizeType, typename Allocator>
+class index<hashed_multi, Tag, T, SizeType, Allocator>
+{
+public:
+	using tag_type = Tag;
+	using value_type = T;
+	using key_type = SizeType;
+	using bucket_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<key_type>;
+	using bucket_type = vector<key_type, key_type, bucket_allocator_type>;
+	using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<T, bucket_type>>;
+
+	static constexpr key_type invalid_key = std::numeric_limits<key_type>::max();
+
+	bool insert(const value_type& value, key_type key)
+	{
+		while (positions_.size() <= key)
+			if (!positions_.push_back(invalid_key))
+				return false;
+
+		auto [it, inserted] = buckets_.try_emplace(value);
+		if (it == buckets_.end())
+			return false;
+
+		if (!it->second.push_back(key))
+		{
+			if (inserted)
+				buckets_.erase(it);
+			return false;
+		}
+
+		positions_[key] = static_cast<key_type>(it->second.size() - 1);
+		return true;
+	}
+
+	void erase(const value_type& value, key_type key)
+	{
+		const auto it = buckets_.find(value);
+		bucket_type& bucket = it->second;
+
+		const key_type position = positions_[key];
+		const key_type last = bucket.back();
+		bucket[position] = last;
+		positions_[last] = position;
+		bucket.pop_back();
+
+		if (bucket.empty())
+			buckets_.erase(it);
+	}
+
+	// Positions are kept, so that they do not grow again on next inserts.
+	void clear() { buckets_.clear(); }
+
+	key_type find(const value_type& value) const noexcept
+	{
+		const auto it = buckets_.find(value);
+		return it != buckets_.end() ? it->second.front() : invalid_key;
+	}
+
+	// Keys of value in no particular order.
+	std::span<const key_type> equal_range(const value_type& value) const noexcept
+	{
+		const auto it = buckets_.find(value);
+		if (it == buckets_.end())
+			return {};
+		return { it->second.data(), it->second.size() };
+	}
+
+	size_t memory_size() const noexcept
+	{
+		size_t ret = buckets_.memory_size() + positions_.memory_size();
+		for (const auto& bucket : buckets_)
+			ret += bucket.second.memory_size();
+		return ret;
+	}
+
+private:
+	flat_map<value_type, bucket_type, std::hash<value_type>, std::equal_to<value_type>, allocator_type> buckets_;
+	vector<key_type, key_type, bucket_allocator_type> positions_;
+};
+
+// Values and keys in two parallel arrays sorted by value and then by key.
+// Lookup is binary search over values only, range query returns contiguous span of keys.
+// Insert and erase shift the tail of arrays, so that index suits rarely changed columns best.
+template <typename Tag, typename T, typename SizeType, typename Allocator>
+class index<sorted, Tag, T, SizeType, Allocator>
+{
+public:
+	using tag_type = Tag;
+	using value_type = T;
+	using key_type = SizeType;
+	using values_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+	using keys_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<key_type>;
+
+	static constexpr key_type invalid_key = std::numeric_limits<key_type>::max();
+
+	bool insert(const value_type& value, key_type key)
+	{
+		const size_t position = lower_bound(value, key);
+
+		if (!values_.push_back(value))
+			return false;
+		if (!keys_.push_back(key))
+		{
+			values_.pop_back();
+			return false;
+		}
+
+		std::move_backward(values_.begin() + position, values_.end() - 1, values_.end());
+		std::move_backward(keys_.begin() + position, keys_.end() - 1, keys_.end());
+		values_[position] = value;
+		keys_[position] = key;
+
+		return true;
+	}
+
+	void erase(const value_type& value, key_type key)
+	{
+		const size_t position = lower_bound(value, key);
+		std::move(values_.begin() + position + 1, values_.end(), values_.begin() + position);
+		std::move(keys_.begin() + position + 1, keys_.end(), keys_.begin() + position);
+		values_.pop_back();
+		keys_.pop_back();
+	}
+
+	void clear()
+	{
+		values_.clear();
+		keys_.clear();
+	}
+
+	key_type find(const value_type& value) const noexcept
+	{
+		if (values_.empty())
+			return invalid_key;
+
+		const value_type* it = std::lower_bound(values_.begin(), values_.end(), value);
+		return it != values_.end() && !(value < *it) ? keys_[it - values_.begin()] : invalid_key;
+	}
+
+	// Keys of value in ascending order.
+	std::span<const key_type> equal_range(const value_type& value) const noexcept
+	{
+		if (values_.empty())
+			return {};
+
+		const auto [first, last] = std::equal_range(values_.begin(), values_.end(), value);
+		return { keys_.begin() + (first - values_.begin()), keys_.begin() + (last - values_.begin()) };
+	}
+
+	// Keys of values in [min, max) ordered by value.
+	std::span<const key_type> range(const value_type& min, const value_type& max) const noexcept
+	{
+		if (values_.empty())
+			return {};
+
+		const value_type* first = std::lower_bound(values_.begin(), values_.end(), min);
+		const value_type* last = std::lower_bound(first, values_.end(), max);
+		return { keys_.begin() + (first - values_.begin()), keys_.begin() + (last - values_.begin()) };
+	}
+
+	size_t memory_size() const noexcept { return values_.memory_size() + keys_.memory_size(); }
+
+private:
+	// First position not less than pair of value and key.
+	size_t lower_bound(const value_type& value, key_type key) const noexcept
+	{
+		size_t first = 0;
+		size_t count = values_.size();
+		while (count > 0)
+		{
+			const size_t step = count / 2;
+			const size_t mid = first + step;
+			if (values_[mid] < value || (!(value < values_[mid]) && keys_[mid] < key))
+			{
+				first = mid + 1;
+				count -= step + 1;
+			}
+			else
+				count = step;
+		}
+		return first;
+	}
+
+	vector<key_type, value_type, values_allocator_type> values_;
+	vector<key_type, key_type, keys_allocator_type> keys_;
+};
+} // namespace secondary_index
+} // namespace db
+} // namespace A3D
+
+#endif // CONTAINER_META_DATABASE_SECONDARY_INDEX_H
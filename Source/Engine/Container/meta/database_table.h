@@ -20,23 +20,42 @@
 #define CONTAINER_META_DATABASE_TABLE_H
 
 #include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <span>
 #include "Container/cpp_lifecycle.h"
+#include "data_list.h"
 #include "types_list.h"
 
 namespace A3D
 {
 namespace db
 {
+// Columns start at cache line and their sizes are padded to whole cache lines, so that SIMD kernels
+// use aligned loads, loads of the last lane may read past the last row, and columns never share a line.
+inline constexpr size_t column_alignment = 64;
+
+template <typename T>
+inline constexpr size_t column_align = std::max(column_alignment, alignof(T));
+
+template <typename T>
+constexpr size_t column_size(size_t rows_count) noexcept
+{
+	return (rows_count * sizeof(T) + column_alignment - 1) & ~(column_alignment - 1);
+}
+
 class distribute_memory
 {
 public:
 	distribute_memory(uint8_t* mem, size_t rows_count) : mem_(mem), rows_count_(rows_count) {}
 
+	// Column starts at the first address aligned by column_align and takes column_size bytes.
 	template <typename T>
 	void operator()(T*& ptr)
 	{
-		ptr = reinterpret_cast<T*>(mem_);
-		mem_ += rows_count_ * sizeof(T);
+		const uintptr_t address = (reinterpret_cast<uintptr_t>(mem_) + column_align<T> - 1) & ~(column_align<T> - 1);
+		ptr = reinterpret_cast<T*>(address);
+		mem_ = reinterpret_cast<uint8_t*>(address) + column_size<T>(rows_count_);
 	}
 
 	uint8_t* mem() const noexcept { return mem_; }
@@ -46,6 +65,19 @@ private:
 	size_t rows_count_;
 };
 
+template <typename TypesList> struct columns_memory;
+
+// The first column may need padding up to cache line. Padded columns keep the next one aligned,
+// unless its type is aligned stronger than cache line.
+template <typename... Ts>
+struct columns_memory<meta::types_list<Ts...>>
+{
+	static constexpr size_t size(size_t rows_count) noexcept
+	{
+		return (column_alignment - 1) + (static_cast<size_t>(0) + ... + (column_size<Ts>(rows_count) + column_align<Ts> - column_alignment));
+	}
+};
+
 struct construct_value
 {
 	template <typename T>
@@ -135,8 +167,7 @@ public:
 	template <typename T>
 	void operator()(T* dst, T* src)
 	{
-		A3D::move_construct_n(dst, src, size_);
-		A3D::destroy_n(src, size_);
+		A3D::relocate_n(dst, src, size_);
 	}
 
 private:
@@ -190,7 +221,7 @@ struct decrement_pointer
 	template <typename T>
 	void operator()(T*& dst)
 	{
-		++dst;
+		--dst;
 	}
 };
 
@@ -227,7 +258,9 @@ public:
 	database_table_iterator(pointer_iter& ptr) noexcept { meta::foreach(ptr_, ptr, set_pointer{}); }
 	database_table_iterator(pointer_iter& ptr, ptrdiff_t bias) noexcept { meta::foreach(ptr_, ptr, set_pointer_bias{bias}); }
 
+	// Constructors from table columns, iterator itself goes to copy constructor.
 	template <typename DataList>
+		requires (!std::is_same_v<std::remove_const_t<DataList>, database_table_iterator>)
 	database_table_iterator(DataList& ptr) noexcept
 	{
 		meta::foreach_tags<tags_types_iter, tags_types_table>(ptr_, ptr, set_pointer{});
@@ -245,6 +278,7 @@ public:
 	}
 
 	template <typename DataList>
+		requires (!std::is_same_v<std::remove_const_t<DataList>, database_table_iterator>)
 	void operator=(DataList& ptr) noexcept
 	{
 		meta::foreach_tags<tags_types_iter, tags_types_table>(ptr_, ptr, set_pointer{});
@@ -254,20 +288,20 @@ public:
 
 	void operator++() noexcept { meta::foreach(ptr_, increment_pointer{}); }
 	void operator--() noexcept { meta::foreach(ptr_, decrement_pointer{}); }
-	void operator+=(ptrdiff_t delta) noexcept { meta::foreach(ptr_, set_pointer_bias{delta}); }
-	void operator-=(ptrdiff_t delta) noexcept { meta::foreach(ptr_, set_pointer_bias{-delta}); }
+	void operator+=(ptrdiff_t delta) noexcept { meta::foreach(ptr_, ptr_, set_pointer_bias{delta}); }
+	void operator-=(ptrdiff_t delta) noexcept { meta::foreach(ptr_, ptr_, set_pointer_bias{-delta}); }
 
 	database_table_iterator operator+(ptrdiff_t delta) noexcept
 	{
 		database_table_iterator ret;
-		meta::foreach(ret, ptr_, set_pointer_bias{delta});
+		meta::foreach(ret.ptr_, ptr_, set_pointer_bias{delta});
 		return ret;
 	}
 
 	database_table_iterator operator-(ptrdiff_t delta) noexcept
 	{
 		database_table_iterator ret;
-		meta::foreach(ret, ptr_, set_pointer_bias{-delta});
+		meta::foreach(ret.ptr_, ptr_, set_pointer_bias{-delta});
 		return ret;
 	}
 
@@ -320,6 +354,8 @@ public:
 	template <typename Tags, typename TableTags> using iterator = database_table_iterator<meta::bypass, data_type, TableTags, Tags>;
 	template <typename Tags, typename TableTags> using const_iterator = database_table_iterator<meta::bypass, data_type, TableTags, Tags>;
 
+	database_table() noexcept { meta::foreach(data_, reset_pointer{}); }
+
 	template <typename Tags, typename TableTags> iterator<Tags, TableTags> begin() noexcept { return { data_ }; }
 	template <typename Tags, typename TableTags> const_iterator<Tags, TableTags> begin() const noexcept { return { data_ }; }
 	template <typename Tags, typename TableTags> const_iterator<Tags, TableTags> cbegin() const noexcept { return { data_ }; }
@@ -361,6 +397,21 @@ public:
 	pointers_type& data() noexcept { return data_; }
 	const pointers_type& data() const noexcept { return data_; }
 
+	// Column of rows_count rows. Memory past the last row up to column_size belongs to column too.
+	template <typename Tag, typename TableTags>
+	std::span<typename meta::type_by_tag<Tag, TableTags, data_type>::type>
+	column(size_type rows_count) noexcept
+	{
+		return { std::assume_aligned<column_alignment>(meta::get_tag<Tag, TableTags>(data_)), rows_count };
+	}
+
+	template <typename Tag, typename TableTags>
+	std::span<const typename meta::type_by_tag<Tag, TableTags, data_type>::type>
+	column(size_type rows_count) const noexcept
+	{
+		return { std::assume_aligned<column_alignment>(meta::get_tag<Tag, TableTags>(data_)), rows_count };
+	}
+
 	uint8_t* allocate(uint8_t* mem, size_t rows_count) noexcept
 	{
 		distribute_memory dm(mem, rows_count);
@@ -371,19 +422,19 @@ public:
 	template <typename TableTags>
 	void create(iterator<TableTags, TableTags>& iter)
 	{
-		meta::foreach(iter, construct_value{});
+		meta::foreach(iter.ptr(), construct_value{});
 	}
 
 	template <typename TableTags>
 	void destroy(iterator<TableTags, TableTags>& iter)
 	{
-		meta::foreach(iter, destroy_value{});
+		meta::foreach(iter.ptr(), destroy_value{});
 	}
 
 	template <typename TableTags>
 	void copy(iterator<TableTags, TableTags> dst, iterator<TableTags, TableTags> src)
 	{
-		meta::foreach(dst, src, copy_value{});
+		meta::foreach(dst.ptr(), src.ptr(), copy_value{});
 	}
 
 	template <typename TableTags>
@@ -403,7 +454,7 @@ private:
 	pointers_type data_;
 
 public:
-	static inline constexpr size_t memory_size(size_t rows_count) noexcept { return rows_count * row_sizeof; }
+	static inline constexpr size_t memory_size(size_t rows_count) noexcept { return columns_memory<TypesList>::size(rows_count); }
 
 	static constexpr size_t row_sizeof = meta::list_sizeof<TypesList>();
 };
@@ -19,6 +19,8 @@
 #ifndef CONTAINER_META_TYPES_LIST_H
 #define CONTAINER_META_TYPES_LIST_H
 
+#include <stddef.h>
+#include <tuple>
 #include <type_traits>
 
 namespace A3D
@@ -218,6 +220,133 @@ struct types_list_select_by_tags
 	using type = typename types_list_modify_by_tags<modifier_bypass, SelectedTags, AllTags, TypesList>::type;
 };
 
+// =========================================
+// Types list builder
+// =========================================
+
+// Appends types one by one, so that lists are built by chains of add.
+template <typename... Ts>
+struct types_list_builder
+{
+	using type = types_list<Ts...>;
+	template <typename T> using add = types_list_builder<Ts..., T>;
+};
+
+template <typename TypesList1, typename TypesList2> struct list_join;
+
+template <template <typename...> typename List, typename... Ts1, typename... Ts2>
+struct list_join<List<Ts1...>, List<Ts2...>>
+{
+	using type = List<Ts1..., Ts2...>;
+};
+
+// =========================================
+// Pack based list operations
+// =========================================
+
+// Work on any list template, so that types lists and data lists are handled the same way.
+
+template <typename T>
+struct bypass
+{
+	using type = T;
+};
+
+template <typename List> struct list_size;
+
+template <template <typename...> typename List, typename... Ts>
+struct list_size<List<Ts...>>
+{
+	static constexpr size_t value = sizeof...(Ts);
+};
+
+template <typename List> struct list_sizeof_impl;
+
+template <template <typename...> typename List, typename... Ts>
+struct list_sizeof_impl<List<Ts...>>
+{
+	static constexpr size_t value = (static_cast<size_t>(0) + ... + sizeof(Ts));
+};
+
+template <typename List>
+constexpr size_t list_sizeof() noexcept
+{
+	return list_sizeof_impl<List>::value;
+}
+
+template <typename T, typename List> struct index_of;
+
+template <typename T, template <typename...> typename List, typename... Ts>
+struct index_of<T, List<Ts...>>
+{
+	static constexpr size_t find() noexcept
+	{
+		static_assert((std::is_same_v<T, Ts> + ... + 0) > 0, "Type must be present in list.");
+
+		constexpr bool matches[] = { std::is_same_v<T, Ts>... };
+		size_t ret = 0;
+		while (!matches[ret])
+			++ret;
+		return ret;
+	}
+
+	static constexpr size_t value = find();
+};
+
+template <typename T, typename List> struct list_contains;
+
+template <typename T, template <typename...> typename List, typename... Ts>
+struct list_contains<T, List<Ts...>>
+{
+	static constexpr bool value = (std::is_same_v<T, Ts> || ...);
+};
+
+template <size_t Index, typename List> struct type_at;
+
+template <size_t Index, template <typename...> typename List, typename... Ts>
+struct type_at<Index, List<Ts...>>
+{
+	using type = std::tuple_element_t<Index, std::tuple<Ts...>>;
+};
+
+// Type of the first column marked by tag.
+template <typename Tag, typename TagsList, typename TypesList>
+struct type_by_tag
+{
+	using type = typename type_at<index_of<Tag, TagsList>::value, TypesList>::type;
+};
+
+template <template <typename> typename Modifier, template <typename...> typename Container, typename List>
+struct list_modify;
+
+template <template <typename> typename Modifier,
+		  template <typename...> typename Container,
+		  template <typename...> typename List,
+		  typename... Ts>
+struct list_modify<Modifier, Container, List<Ts...>>
+{
+	using type = Container<typename Modifier<Ts>::type...>;
+};
+
+// Container of modified types of selected tags in order of selection.
+template <template <typename> typename Modifier,
+		  template <typename...> typename Container,
+		  typename TypesList,
+		  typename SelectedTags,
+		  typename AllTags>
+struct tags_modify;
+
+template <template <typename> typename Modifier,
+		  template <typename...> typename Container,
+		  typename TypesList,
+		  template <typename...> typename List,
+		  typename... Selected,
+		  typename AllTags>
+struct tags_modify<Modifier, Container, TypesList, List<Selected...>, AllTags>
+{
+	using type = Container<typename Modifier<typename type_by_tag<Selected, AllTags, TypesList>::type>::type...>;
+};
+
 } // namespace meta
 } // namespace A3D
 
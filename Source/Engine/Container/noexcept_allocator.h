@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <concepts>
 #include <memory>
 #include <type_traits>
 
@@ -56,8 +57,30 @@ struct noexcept_allocator
 		free(p);
 	}
 
+	// Resize block in place when possible. Contents are moved bitwise, so that containers
+	// use it only for trivially relocatable types. Glibc serves large blocks by mmap and
+	// resizes them by mremap, so that growing huge arrays does not copy its data.
+	[[nodiscard]] T* reallocate(T* p, [[maybe_unused]] size_t old_n, size_t new_n) noexcept
+	{
+		T* ret = reinterpret_cast<T*>(realloc(p, new_n * sizeof(T)));
+		if (ret != nullptr)
+			return ret;
+		else
+		{
+			std::terminate();
+			return nullptr;
+		}
+	}
+
 	constexpr bool operator==(const noexcept_allocator&) const noexcept { return true; }
 };
+
+// Allocator provides optional reallocate(ptr, old_count, new_count) hook.
+template <typename Allocator>
+concept reallocatable_allocator = requires(Allocator& alloc, typename Allocator::value_type* ptr, size_t n)
+{
+	{ alloc.reallocate(ptr, n, n) } -> std::same_as<typename Allocator::value_type*>;
+};
 } // namespace A3D
 
 #endif // CONTAINER_NOEXCEPT_ALLOCATOR_H
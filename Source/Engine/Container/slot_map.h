@@ -0,0 +1,221 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_SLOT_MAP_H
+#define CONTAINER_SLOT_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "dense_map.h"
+#include "generational_sparse_map.h"
+
+namespace A3D
+{
+// Items stored as structure of arrays: each column is packed dense map, all columns share the same index.
+// External code refers to items by generational handles, which stay valid until item is erased.
+// Erase moves the last item into the hole, so columns stay contiguous and iteration over them is linear.
+template <typename Handle, typename... Columns>
+class slot_map
+{
+public:
+	using handle_type = Handle;
+	using index_type = Handle;
+	using size_type = Handle;
+
+	template <size_t Column>
+	using column_type = std::tuple_element_t<Column, std::tuple<Columns...>>;
+
+	template <typename T>
+	using column_container = dense_map<index_type, T>;
+
+	using handles_container = dense_map<index_type, handle_type>;
+
+	static constexpr size_t COLUMNS_COUNT = sizeof...(Columns);
+	static constexpr handle_type INVALID_HANDLE = generational_sparse_map<handle_type, index_type>::INVALID_KEY;
+	// Insert fails past this count, see generational_sparse_map for handle bits layout.
+	static constexpr size_type MAX_SIZE = generational_sparse_map<handle_type, index_type>::MAX_SIZE;
+
+	slot_map()
+	{
+		static_assert(sizeof...(Columns) > 0);
+	}
+
+	// Insert single value per column. Returns handle of new item or INVALID_HANDLE.
+	template <typename... Args>
+	handle_type insert(Args&&... values)
+	{
+		static_assert(sizeof...(Args) == sizeof...(Columns), "Slot map insertion requires single value per column.");
+
+		const index_type index = handles_.size();
+		const handle_type handle = indices_.insert(index);
+		if (handle == INVALID_HANDLE)
+			return INVALID_HANDLE;
+
+		if (handles_.insert(handle) == handles_.INVALID_KEY ||
+			!insert_columns(std::index_sequence_for<Columns...>{}, std::forward<Args>(values)...))
+		{
+			rollback_insert(index, std::index_sequence_for<Columns...>{});
+			indices_.erase(handle);
+			return INVALID_HANDLE;
+		}
+
+		return handle;
+	}
+
+	void erase(handle_type handle)
+	{
+		const index_type index = indices_[handle];
+		indices_.erase(handle);
+
+		erase_columns(index, std::index_sequence_for<Columns...>{});
+
+		const index_type rebound = handles_.erase(index);
+		if (rebound != handles_.INVALID_KEY)
+			indices_[handles_[index]] = index;
+	}
+
+	bool contains(handle_type handle) const noexcept { return indices_.contains(handle); }
+
+	index_type get_index(handle_type handle) const noexcept { return indices_[handle]; }
+	handle_type get_handle(index_type index) const noexcept { return handles_[index]; }
+
+	template <size_t Column>
+	column_type<Column>& get(handle_type handle) noexcept
+	{
+		return std::get<Column>(columns_)[indices_[handle]];
+	}
+
+	template <size_t Column>
+	const column_type<Column>& get(handle_type handle) const noexcept
+	{
+		return std::get<Column>(columns_)[indices_[handle]];
+	}
+
+	template <typename T>
+	T& get(handle_type handle) noexcept
+	{
+		return get<get_column_index<T>()>(handle);
+	}
+
+	template <typename T>
+	const T& get(handle_type handle) const noexcept
+	{
+		return get<get_column_index<T>()>(handle);
+	}
+
+	// Whole column, indexed by item index. Use it for linear passes over all items.
+	template <size_t Column>
+	column_container<column_type<Column>>& column() noexcept
+	{
+		return std::get<Column>(columns_);
+	}
+
+	template <size_t Column>
+	const column_container<column_type<Column>>& column() const noexcept
+	{
+		return std::get<Column>(columns_);
+	}
+
+	template <typename T>
+	column_container<T>& column() noexcept
+	{
+		return column<get_column_index<T>()>();
+	}
+
+	template <typename T>
+	const column_container<T>& column() const noexcept
+	{
+		return column<get_column_index<T>()>();
+	}
+
+	const handles_container& handles() const noexcept { return handles_; }
+
+	size_type size() const noexcept { return handles_.size(); }
+	[[nodiscard]] bool empty() const noexcept { return handles_.empty(); }
+
+	// Removes all items. Handles of removed items are invalidated.
+	void clear()
+	{
+		std::apply([](auto&... columns) { (columns.clear(), ...); }, columns_);
+		handles_.clear();
+		indices_.clear();
+	}
+
+	bool reserve(size_type count)
+	{
+		return indices_.reserve(count) && handles_.reserve(count) &&
+			   std::apply([count](auto&... columns) { return (columns.reserve(count) && ...); }, columns_);
+	}
+
+	bool shrink_to_fit()
+	{
+		indices_.shrink_to_fit();
+		handles_.shrink_to_fit();
+		std::apply([](auto&... columns) { (columns.shrink_to_fit(), ...); }, columns_);
+		return true;
+	}
+
+	size_t memory_size() const noexcept
+	{
+		return indices_.memory_size() + handles_.memory_size() +
+			   std::apply([](const auto&... columns) { return (columns.memory_size() + ...); }, columns_);
+	}
+
+	template <typename T>
+	static constexpr size_t get_column_index() noexcept
+	{
+		static_assert((std::is_same_v<T, Columns> + ...) == 1, "Column type must be present in slot map exactly once.");
+
+		constexpr bool matches[] = { std::is_same_v<T, Columns>... };
+		size_t ret = 0;
+		while (!matches[ret])
+			++ret;
+		return ret;
+	}
+
+private:
+	template <size_t... Column, typename... Args>
+	bool insert_columns(std::index_sequence<Column...>, Args&&... values)
+	{
+		return ((std::get<Column>(columns_).emplace(std::forward<Args>(values)) != INVALID_HANDLE) && ...);
+	}
+
+	template <size_t... Column>
+	void rollback_insert(index_type index, std::index_sequence<Column...>)
+	{
+		if (handles_.size() > index)
+			handles_.erase(index);
+		((std::get<Column>(columns_).size() > index ? (void)std::get<Column>(columns_).erase(index) : (void)0), ...);
+	}
+
+	template <size_t... Column>
+	void erase_columns(index_type index, std::index_sequence<Column...>)
+	{
+		(std::get<Column>(columns_).erase(index), ...);
+	}
+
+	generational_sparse_map<handle_type, index_type> indices_;
+	handles_container handles_;
+	std::tuple<column_container<Columns>...> columns_;
+};
+} // namespace A3D
+
+#endif // CONTAINER_SLOT_MAP_H
@@ -0,0 +1,309 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_SMALL_VECTOR_H
+#define CONTAINER_SMALL_VECTOR_H
+
+#include <stdint.h>
+#include <string.h>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "cpp_lifecycle.h"
+#include "growth_policy.h"
+#include "noexcept_allocator.h"
+
+namespace A3D
+{
+// Vector keeping first InlineCapacity items inside itself.
+// Heap memory is allocated only when items count overflows inline storage.
+template <typename Key,
+		  typename Value,
+		  Key InlineCapacity,
+		  typename Allocator = noexcept_allocator<Value>,
+		  typename GrowthPolicy = growth_default>
+class small_vector
+{
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = key_type;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using allocator_type = Allocator;
+	using growth_policy = GrowthPolicy;
+	using iterator = pointer;
+	using const_iterator = const_pointer;
+
+	static constexpr key_type INVALID_KEY = std::numeric_limits<key_type>::max();
+	static constexpr size_type INLINE_CAPACITY = InlineCapacity;
+
+	small_vector() :
+		data_(get_inline_data()),
+		size_(0),
+		capacity_(INLINE_CAPACITY)
+	{
+		static_assert(std::is_trivial<Key>::value);
+		static_assert(std::is_integral<Key>::value);
+		static_assert(InlineCapacity > 0);
+	}
+
+	explicit small_vector(const Allocator& alloc) :
+		data_(get_inline_data()),
+		size_(0),
+		capacity_(INLINE_CAPACITY),
+		alloc_(alloc)
+	{
+		static_assert(std::is_trivial<Key>::value);
+		static_assert(std::is_integral<Key>::value);
+		static_assert(InlineCapacity > 0);
+	}
+
+	small_vector(const small_vector& other) :
+		data_(get_inline_data()),
+		size_(0),
+		capacity_(INLINE_CAPACITY),
+		alloc_(other.alloc_)
+	{
+		copy_from(other);
+	}
+
+	small_vector(small_vector&& other) noexcept :
+		data_(get_inline_data()),
+		size_(0),
+		capacity_(INLINE_CAPACITY),
+		alloc_(other.alloc_)
+	{
+		move_from(other);
+	}
+
+	~small_vector() { destroy(); }
+
+	void operator=(const small_vector& other)
+	{
+		clear();
+		copy_from(other);
+	}
+
+	void operator=(small_vector&& other) noexcept
+	{
+		clear();
+		move_from(other);
+	}
+
+	iterator begin() noexcept { return data_; }
+	const_iterator begin() const noexcept { return data_; }
+	const_iterator cbegin() const noexcept { return data_; }
+	iterator end() noexcept { return data_ + size_; }
+	const_iterator end() const noexcept { return data_ + size_; }
+	const_iterator cend() const noexcept { return data_ + size_; }
+
+	value_type& front() noexcept { return data_[0]; }
+	const value_type& front() const noexcept { return data_[0]; }
+	value_type& back() noexcept { return data_[size_ - 1]; }
+	const value_type& back() const noexcept { return data_[size_ - 1]; }
+
+	value_type& operator[](key_type key) noexcept { return data_[key]; }
+	const value_type& operator[](key_type key) const noexcept { return data_[key]; }
+
+	pointer data() noexcept { return data_; }
+	const_pointer data() const noexcept { return data_; }
+
+	size_type size() const noexcept { return size_; }
+	size_type capacity() const noexcept { return capacity_; }
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+	bool is_inline() const noexcept { return data_ == get_inline_data(); }
+
+	template <typename... Args>
+	bool emplace_back(Args&&... args)
+	{
+		if (size_ == capacity_)
+			if (capacity_ == MAX_CAPACITY || !reserve(growth_policy::grow(capacity_, static_cast<size_type>(size_ + 1), sizeof(value_type))))
+				return false;
+
+		if constexpr (std::is_trivial<value_type>::value)
+			data_[size_] = { std::forward<Args>(args)... };
+		else
+			std::construct_at(&data_[size_], std::forward<Args>(args)...);
+
+		++size_;
+
+		return true;
+	}
+
+	bool push_back(const value_type& value)
+	{
+		return emplace_back(value);
+	}
+
+	bool push_back(value_type&& value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	void pop_back()
+	{
+		if constexpr (!std::is_trivial<value_type>::value)
+			std::destroy_at(&back());
+		--size_;
+	}
+
+	void clear()
+	{
+		destroy();
+
+		data_ = get_inline_data();
+		size_ = 0;
+		capacity_ = INLINE_CAPACITY;
+	}
+
+	bool reserve(size_type count)
+	{
+		if (count <= capacity_)
+			return true;
+
+		return reallocate(count);
+	}
+
+	void shrink(size_type count)
+	{
+		if constexpr (!std::is_trivial<value_type>::value)
+			for (iterator it = begin() + count; it < end(); ++it)
+				std::destroy_at(it);
+
+		size_ = count;
+	}
+
+	bool shrink_to_fit()
+	{
+		if (is_inline() || size_ == capacity_)
+			return true;
+
+		if (size_ > INLINE_CAPACITY)
+			return reallocate(size_);
+
+		// Move items back into inline storage.
+		pointer heap_data = data_;
+		relocate_n(get_inline_data(), heap_data, size_);
+		alloc_.deallocate(heap_data, capacity_);
+
+		data_ = get_inline_data();
+		capacity_ = INLINE_CAPACITY;
+
+		return true;
+	}
+
+	// Allocated heap memory. Inline storage is a part of container itself.
+	size_t memory_size() const noexcept
+	{
+		return is_inline() ? 0 : capacity_ * sizeof(value_type);
+	}
+
+	// Allocated but unused tail memory, including inline storage.
+	size_t memory_slack() const noexcept
+	{
+		return (capacity_ - size_) * sizeof(value_type);
+	}
+
+private:
+	static constexpr size_type MAX_CAPACITY = std::numeric_limits<size_type>::max();
+
+	pointer get_inline_data() noexcept { return reinterpret_cast<pointer>(inline_data_); }
+	const_pointer get_inline_data() const noexcept { return reinterpret_cast<const_pointer>(inline_data_); }
+
+	// Move items to the heap storage with count capacity. Count must be greater than inline capacity.
+	bool reallocate(size_type count)
+	{
+		if constexpr (is_trivially_relocatable_v<value_type> && reallocatable_allocator<allocator_type>)
+		{
+			if (!is_inline())
+			{
+				pointer new_data = alloc_.reallocate(data_, capacity_, count);
+				if (new_data == nullptr)
+					return false;
+
+				data_ = new_data;
+				capacity_ = count;
+
+				return true;
+			}
+		}
+
+		pointer new_data = alloc_.allocate(count);
+		if (new_data == nullptr)
+			return false;
+
+		relocate_n(new_data, data_, size_);
+		if (!is_inline())
+			alloc_.deallocate(data_, capacity_);
+
+		data_ = new_data;
+		capacity_ = count;
+
+		return true;
+	}
+
+	void copy_from(const small_vector& other)
+	{
+		if (other.size_ > capacity_ && !reserve(other.size_))
+			return;
+
+		copy_construct_n(data_, other.data_, other.size_);
+		size_ = other.size_;
+	}
+
+	void move_from(small_vector& other) noexcept
+	{
+		if (other.is_inline())
+		{
+			relocate_n(data_, other.data_, other.size_);
+			size_ = other.size_;
+		}
+		else
+		{
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+
+			other.data_ = other.get_inline_data();
+			other.capacity_ = INLINE_CAPACITY;
+		}
+
+		other.size_ = 0;
+	}
+
+	void destroy()
+	{
+		destroy_n(data_, size_);
+
+		if (!is_inline())
+			alloc_.deallocate(data_, capacity_);
+	}
+
+	pointer data_;
+	size_type size_;
+	size_type capacity_;
+	allocator_type alloc_;
+	alignas(value_type) uint8_t inline_data_[INLINE_CAPACITY * sizeof(value_type)];
+};
+} // namespace A3D
+
+#endif // CONTAINER_SMALL_VECTOR_H
@@ -22,9 +22,11 @@
 #include <stdint.h>
 #include <string.h>
 #include <bit>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <type_traits>
+#include "growth_policy.h"
 #include "noexcept_allocator.h"
 
 namespace A3D
@@ -32,9 +34,13 @@ namespace A3D
 template <typename Key,
 		  typename Value,
 		  typename Bitfield = uint32_t,
-		  typename Allocator = noexcept_allocator<Value>>
+		  typename Allocator = noexcept_allocator<Value>,
+		  typename GrowthPolicy = growth_default>
 class sparse_map
 {
+	template <typename Map, typename Reference>
+	class basic_iterator;
+
 public:
 	using key_type = Key;
 	using value_type = Value;
@@ -45,12 +51,16 @@ public:
 	using const_pointer = const value_type*;
 	using allocator_type = Allocator;
 	using bitfield_type = Bitfield;
+	using growth_policy = GrowthPolicy;
+	using iterator = basic_iterator<sparse_map, value_type&>;
+	using const_iterator = basic_iterator<const sparse_map, const value_type&>;
 
 	static constexpr key_type INVALID_KEY = std::numeric_limits<key_type>::max();
 
 	sparse_map() :
 		size_(0),
-		capacity_(0)
+		capacity_(0),
+		free_hint_(0)
 	{
 		static_assert(std::is_trivial<Key>::value);
 		static_assert(std::is_trivial<Value>::value);
@@ -60,6 +70,7 @@ public:
 	explicit sparse_map(const Allocator& alloc) :
 		size_(0),
 		capacity_(0),
+		free_hint_(0),
 		alloc_(alloc)
 	{
 		static_assert(std::is_trivial<Key>::value);
@@ -68,38 +79,36 @@ public:
 	}
 
 	sparse_map(const sparse_map& other) :
-		size_(other.size_),
-		capacity_(other.capacity_),
+		size_(0),
+		capacity_(0),
+		free_hint_(0),
 		alloc_(other.alloc_)
 	{
-		const size_type bitfield_size = allocate(data_, items_state_, capacity_);
-		memcpy(data_, other.data_, capacity_ * sizeof(value_type));
-		memcpy(items_state_, other.items_state_, bitfield_size);
+		copy_from(other);
 	}
 
 	sparse_map(sparse_map&& other) noexcept :
 		data_(other.data_),
 		items_state_(other.items_state_),
+		free_summary_(other.free_summary_),
+		used_summary_(other.used_summary_),
+		free_top_(other.free_top_),
 		size_(other.size_),
 		capacity_(other.capacity_),
+		free_hint_(other.free_hint_),
 		alloc_(other.alloc_)
 	{
 		other.size_ = 0;
 		other.capacity_ = 0;
+		other.free_hint_ = 0;
 	}
 
 	~sparse_map() { destroy(); }
 
 	void operator=(const sparse_map& other)
 	{
-		destroy();
-
-		size_ = other.size_;
-		capacity_ = other.capacity_;
-
-		const size_type bitfield_size = allocate(data_, items_state_, capacity_);
-		memcpy(data_, other.data_, capacity_ * sizeof(value_type));
-		memcpy(items_state_, other.items_state_, bitfield_size);
+		clear();
+		copy_from(other);
 	}
 
 	void operator=(sparse_map&& other) noexcept
@@ -108,13 +117,25 @@ public:
 
 		data_ = other.data_;
 		items_state_ = other.items_state_;
+		free_summary_ = other.free_summary_;
+		used_summary_ = other.used_summary_;
+		free_top_ = other.free_top_;
 		size_ = other.size_;
 		capacity_ = other.capacity_;
+		free_hint_ = other.free_hint_;
 
 		other.size_ = 0;
 		other.capacity_ = 0;
+		other.free_hint_ = 0;
 	}
 
+	iterator begin() noexcept { return iterator(this, find_next_occupied(0)); }
+	const_iterator begin() const noexcept { return const_iterator(this, find_next_occupied(0)); }
+	const_iterator cbegin() const noexcept { return const_iterator(this, find_next_occupied(0)); }
+	iterator end() noexcept { return iterator(this, capacity_); }
+	const_iterator end() const noexcept { return const_iterator(this, capacity_); }
+	const_iterator cend() const noexcept { return const_iterator(this, capacity_); }
+
 	value_type& operator[](key_type key) noexcept { return data_[key]; }
 	const value_type& operator[](key_type key) const noexcept { return data_[key]; }
 
@@ -126,13 +147,13 @@ public:
 	{
 		const size_type segment = get_bf_segment(key);
 		const bitfield_type bit = get_bf_bit(key);
-		return capacity_ > 0 && get_bf_value(items_state_[segment], bit);
+		return key < capacity_ && get_bf_value(items_state_[segment], bit);
 	}
 
 	key_type insert(value_type value)
 	{
-		if (size_ + 1 > capacity_)
-			if (!reserve(capacity_ + BITS_IN_BITFIELD))
+		if (size_ == capacity_)
+			if (capacity_ == MAX_CAPACITY || !reserve(get_grown_capacity()))
 				return INVALID_KEY;
 
 		++size_;
@@ -150,81 +171,80 @@ public:
 		const bitfield_type bit = get_bf_bit(key);
 		disable_bf_bit(items_state_[segment], bit);
 
+		const size_type summary = get_summary_index(segment);
+		const summary_type summary_bit = get_summary_bit(segment);
+		free_summary_[summary] |= summary_bit;
+		if (items_state_[segment] == BITS_ALL_DISABLED)
+			used_summary_[summary] &= ~summary_bit;
+
+		const size_type top = get_summary_index(summary);
+		free_top_[top] |= get_summary_bit(summary);
+		if (top < free_hint_)
+			free_hint_ = top;
+
 		--size_;
 	}
 
+	// Call func(key, value) for every occupied cell in keys order.
+	// Fully empty segments are skipped by used summary, so empty tail costs nothing.
+	// Function is allowed to erase the cell it is called for.
+	template <typename Function>
+	void for_each_occupied(Function func)
+	{
+		for_each_occupied_impl(*this, func);
+	}
+
+	template <typename Function>
+	void for_each_occupied(Function func) const
+	{
+		for_each_occupied_impl(*this, func);
+	}
+
 	void clear()
 	{
 		destroy();
 		size_ = 0;
 		capacity_ = 0;
+		free_hint_ = 0;
 	}
 
 	bool reserve(size_type count)
 	{
-		pointer new_data;
-		bitfield_type* new_items_state;
-		const size_type bitfield_count = allocate(new_data, new_items_state, count);
-		if (bitfield_count > 0)
-		{
-			const size_type old_data_size = capacity_ * sizeof(value_type);
-			const size_type old_items_state_size = get_bitfield_size(capacity_) * sizeof(bitfield_type);
-			const size_type new_data_size = count * sizeof(value_type);
-			const size_type new_items_state_size = bitfield_count * sizeof(bitfield_type);
-
-			if (capacity_ > 0)
-			{
-				memcpy(new_data, data_, old_data_size);
-				memcpy(new_items_state, items_state_, old_items_state_size);
-				deallocate(data_, items_state_);
-			}
-
-			data_ = new_data;
-			items_state_ = new_items_state;
-			capacity_ = count;
-
+		if (count <= capacity_)
 			return true;
-		}
-		else
-			return false;
+
+		return reallocate(count);
 	}
 
 	bool shrink_to_fit()
 	{
+		if (capacity_ == 0)
+			return false;
+
 		size_type to_deallocate = get_segments_to_shrink();
 		if (to_deallocate == 0)
 			return false;
 
 		const size_type new_capacity = capacity_ - to_deallocate * BITS_IN_BITFIELD;
 		if (new_capacity > 0)
-		{
-			pointer new_data;
-			bitfield_type* new_items_state;
-			const size_type new_items_state_size = allocate(new_data, new_items_state, new_capacity);
-			if (new_items_state_size == 0)
-				return false;
-
-			if (capacity_)
-			{
-				memcpy(new_data, data_, capacity_ * sizeof(value_type));
-				memcpy(new_items_state, items_state_, new_items_state_size);
-				deallocate(data_, items_state_);
-			}
-
-			data_ = new_data;
-			items_state_ = new_items_state;
-		}
-		else
-			deallocate(data_, items_state_);
+			return reallocate(new_capacity);
 
-		capacity_ = new_capacity;
+		deallocate(data_, capacity_);
+		capacity_ = 0;
+		free_hint_ = 0;
 
 		return true;
 	}
 
 	size_t memory_size() const noexcept
 	{
-		return sizeof(sparse_map) + capacity_ * sizeof(value_type) + get_bitfield_size(capacity_) * sizeof(bitfield_type);
+		return sizeof(sparse_map) + (capacity_ > 0 ? get_memory_layout(capacity_).size : 0);
+	}
+
+	// Allocated but unused cells memory.
+	size_t memory_slack() const noexcept
+	{
+		return (capacity_ - size_) * sizeof(value_type);
 	}
 
 #ifndef NDEBUG
@@ -249,71 +269,289 @@ private:
 	static constexpr bitfield_type BITS_ONE = static_cast<bitfield_type>(1);
 	static constexpr bitfield_type BITS_ALL_DISABLED = static_cast<bitfield_type>(0);
 	static constexpr bitfield_type BITS_ALL_ENABLED = ~BITS_ALL_DISABLED;
-	static constexpr key_type BITFIELD_MAX_VALUE_BITS = std::bit_width(BITS_IN_BITFIELD - 1);
+	static constexpr key_type BITFIELD_MAX_VALUE_BITS = std::bit_width(static_cast<size_t>(BITS_IN_BITFIELD - 1));
+	// Capacity is always multiple of bitfield size, and INVALID_KEY must stay out of range.
+	static constexpr size_type MAX_CAPACITY = INVALID_KEY & ~static_cast<size_type>(BITS_IN_BITFIELD - 1);
 
-	size_type allocate(pointer& data, bitfield_type*& items_state, size_type capacity)
+	size_type get_grown_capacity() const noexcept
 	{
-		using rebound_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<uint8_t>;
-		rebound_allocator_type rebound_allocator(alloc_);
+		const size_type required = capacity_ + BITS_IN_BITFIELD;
+		size_t ret = growth_policy::grow(capacity_, required, sizeof(value_type));
+		ret = (ret + BITS_IN_BITFIELD - 1) & ~static_cast<size_t>(BITS_IN_BITFIELD - 1);
+		return ret < MAX_CAPACITY ? static_cast<size_type>(ret) : MAX_CAPACITY;
+	}
+
+	using rebound_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<uint8_t>;
+
+	// Each summary bit describes a whole bitfield segment:
+	// free summary - segment has at least one empty cell,
+	// used summary - segment has at least one occupied cell.
+	// Each free top bit describes a whole free summary word, so that empty cell is found by
+	// two countr_zero after skipping zero top words, one top word covers 64 * 64 segments.
+	using summary_type = uint64_t;
+
+	static constexpr size_type BITS_IN_SUMMARY = static_cast<size_type>(sizeof(summary_type) * 8);
+	static constexpr key_type SUMMARY_MAX_VALUE_BITS = std::bit_width(static_cast<size_t>(BITS_IN_SUMMARY - 1));
+
+	// Single memory block contains cells, their states, both summaries and free top.
+	struct memory_layout
+	{
+		size_t items_state_offset;
+		size_t summary_offset;
+		size_t summary_size;
+		size_t top_offset;
+		size_t size;
+	};
+
+	static memory_layout get_memory_layout(size_type capacity) noexcept
+	{
+		constexpr size_t summary_align = alignof(summary_type);
+
+		memory_layout ret;
+		ret.items_state_offset = static_cast<size_t>(capacity) * sizeof(value_type);
+		ret.summary_offset = ret.items_state_offset + get_bitfield_size(capacity) * sizeof(bitfield_type);
+		ret.summary_offset = (ret.summary_offset + summary_align - 1) & ~(summary_align - 1);
+		ret.summary_size = get_summary_size(capacity) * sizeof(summary_type);
+		ret.top_offset = ret.summary_offset + ret.summary_size * 2;
+		ret.size = ret.top_offset + get_top_size(capacity) * sizeof(summary_type);
+		return ret;
+	}
 
-		const size_type data_size = capacity * sizeof(value_type);
-		const size_type bitfield_size = get_bitfield_size(capacity) * sizeof(bitfield_type);
-		uint8_t* memory = rebound_allocator.allocate(data_size + bitfield_size);
-		data = reinterpret_cast<pointer>(memory);
-		memory += data_size;
-		items_state = reinterpret_cast<bitfield_type*>(memory);
+	void bind_memory(uint8_t* memory, size_type capacity) noexcept
+	{
+		const memory_layout layout = get_memory_layout(capacity);
+		data_ = reinterpret_cast<pointer>(memory);
+		items_state_ = reinterpret_cast<bitfield_type*>(memory + layout.items_state_offset);
+		free_summary_ = reinterpret_cast<summary_type*>(memory + layout.summary_offset);
+		used_summary_ = reinterpret_cast<summary_type*>(memory + layout.summary_offset + layout.summary_size);
+		free_top_ = reinterpret_cast<summary_type*>(memory + layout.top_offset);
+	}
+
+	// Move cells and their states into storage with new capacity.
+	// When shrinking, all cells behind new capacity must be empty.
+	bool reallocate(size_type new_capacity)
+	{
+		const memory_layout old_layout = get_memory_layout(capacity_);
+		const memory_layout new_layout = get_memory_layout(new_capacity);
+		const size_t old_items_state_size = get_bitfield_size(capacity_) * sizeof(bitfield_type);
+		const size_t new_items_state_size = get_bitfield_size(new_capacity) * sizeof(bitfield_type);
 
-		if (memory != nullptr)
+		// Grow in place: cells are trivial, states are moved behind the grown cells array.
+		if constexpr (reallocatable_allocator<rebound_allocator_type>)
 		{
-			memset(items_state, 0, bitfield_size);
-			return bitfield_size;
+			if (capacity_ > 0 && new_capacity > capacity_)
+			{
+				rebound_allocator_type rebound_allocator(alloc_);
+				uint8_t* memory = rebound_allocator.reallocate(reinterpret_cast<uint8_t*>(data_), old_layout.size, new_layout.size);
+				if (memory == nullptr)
+					return false;
+
+				memmove(memory + new_layout.items_state_offset, memory + old_layout.items_state_offset, old_items_state_size);
+				memset(memory + new_layout.items_state_offset + old_items_state_size, 0, new_items_state_size - old_items_state_size);
+
+				bind_memory(memory, new_capacity);
+				capacity_ = new_capacity;
+				rebuild_summary();
+
+				return true;
+			}
+		}
+
+		uint8_t* memory = allocate(new_capacity);
+		if (memory == nullptr)
+			return false;
+
+		memset(memory + new_layout.items_state_offset, 0, new_items_state_size);
+		if (capacity_ > 0)
+		{
+			memcpy(memory,
+				   data_,
+				   old_layout.items_state_offset < new_layout.items_state_offset ? old_layout.items_state_offset
+																				 : new_layout.items_state_offset);
+			memcpy(memory + new_layout.items_state_offset,
+				   items_state_,
+				   old_items_state_size < new_items_state_size ? old_items_state_size : new_items_state_size);
+			deallocate(data_, capacity_);
 		}
-		else
-			return 0;
+
+		bind_memory(memory, new_capacity);
+		capacity_ = new_capacity;
+		rebuild_summary();
+
+		return true;
 	}
 
-	void deallocate(pointer data, [[maybe_unused]] bitfield_type* items_state)
+	void copy_from(const sparse_map& other)
+	{
+		if (other.capacity_ == 0)
+			return;
+
+		uint8_t* memory = allocate(other.capacity_);
+		if (memory == nullptr)
+			return;
+
+		memcpy(memory, other.data_, get_memory_layout(other.capacity_).size);
+		bind_memory(memory, other.capacity_);
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		free_hint_ = other.free_hint_;
+	}
+
+	uint8_t* allocate(size_type capacity)
 	{
-		using rebound_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<uint8_t>;
 		rebound_allocator_type rebound_allocator(alloc_);
+		return rebound_allocator.allocate(get_memory_layout(capacity).size);
+	}
 
-		const size_type size = capacity_ * sizeof(value_type) + get_bitfield_size(capacity_) * sizeof(bitfield_type);
-		rebound_allocator.deallocate(reinterpret_cast<uint8_t*>(data), size);
+	void deallocate(pointer data, size_type capacity)
+	{
+		rebound_allocator_type rebound_allocator(alloc_);
+		rebound_allocator.deallocate(reinterpret_cast<uint8_t*>(data), get_memory_layout(capacity).size);
 	}
 
 	void destroy()
 	{
 		if (capacity_ > 0)
-			deallocate(data_, items_state_);
+			deallocate(data_, capacity_);
 	}
 
-	key_type take_empty_cell()
+	// Recalculate summaries and free top from cells states. Called once per reallocation only.
+	void rebuild_summary() noexcept
 	{
 		const size_type bitfield_count = get_bitfield_size(capacity_);
+		const size_type summary_count = get_summary_size(capacity_);
+		memset(free_summary_, 0, summary_count * sizeof(summary_type));
+		memset(used_summary_, 0, summary_count * sizeof(summary_type));
+		memset(free_top_, 0, get_top_size(capacity_) * sizeof(summary_type));
+
 		for (size_type i = 0; i < bitfield_count; ++i)
 		{
 			if (is_bf_segment_not_full(items_state_[i]))
+				free_summary_[get_summary_index(i)] |= get_summary_bit(i);
+			if (items_state_[i] != BITS_ALL_DISABLED)
+				used_summary_[get_summary_index(i)] |= get_summary_bit(i);
+		}
+
+		for (size_type i = 0; i < summary_count; ++i)
+			if (free_summary_[i] != 0)
+				free_top_[get_summary_index(i)] |= get_summary_bit(i);
+
+		free_hint_ = 0;
+	}
+
+	// All free top words before free hint are zero, so search starts from it.
+	key_type take_empty_cell()
+	{
+		const size_type top_count = get_top_size(capacity_);
+		for (size_type top = free_hint_; top < top_count; ++top)
+		{
+			if (free_top_[top] != 0)
 			{
-				const bitfield_type bit = get_bf_first_empty_bit(items_state_[i]);
-				enable_bf_bit(items_state_[i], bit);
-				return build_bf_key(i, bit);
+				free_hint_ = top;
+
+				const size_type summary = (top << SUMMARY_MAX_VALUE_BITS) | std::countr_zero(free_top_[top]);
+				const size_type segment = (summary << SUMMARY_MAX_VALUE_BITS) | std::countr_zero(free_summary_[summary]);
+				const bitfield_type bit = get_bf_first_empty_bit(items_state_[segment]);
+				enable_bf_bit(items_state_[segment], bit);
+
+				const summary_type summary_bit = get_summary_bit(segment);
+				used_summary_[summary] |= summary_bit;
+				if (!is_bf_segment_not_full(items_state_[segment]))
+				{
+					free_summary_[summary] &= ~summary_bit;
+					if (free_summary_[summary] == 0)
+						free_top_[top] &= ~get_summary_bit(summary);
+				}
+
+				return build_bf_key(segment, bit);
 			}
 		}
+		free_hint_ = top_count;
 		return INVALID_KEY;
 	}
 
+	// Count empty segments in the tail, looking for the last occupied one in used summary.
 	size_type get_segments_to_shrink() const noexcept
 	{
-		size_type ret = 0;
-		size_type segment = get_bitfield_size(capacity_) - 1;
-		while (items_state_[segment] == BITS_ALL_DISABLED)
+		const size_type bitfield_count = get_bitfield_size(capacity_);
+		size_type summary = get_summary_size(capacity_);
+		while (summary > 0)
 		{
-			++ret;
-			if (segment == 0)
-				break;
-			--segment;
+			--summary;
+			if (used_summary_[summary] != 0)
+			{
+				const size_type last_used = (summary << SUMMARY_MAX_VALUE_BITS) | (std::bit_width(used_summary_[summary]) - 1);
+				return bitfield_count - last_used - 1;
+			}
 		}
-		return ret;
+		return bitfield_count;
+	}
+
+	// Find first occupied cell starting from key, or capacity if there is no one.
+	size_type find_next_occupied(size_t key) const noexcept
+	{
+		if (key >= capacity_)
+			return capacity_;
+
+		size_t segment = key >> BITFIELD_MAX_VALUE_BITS;
+		const bitfield_type bits = items_state_[segment] & static_cast<bitfield_type>(BITS_ALL_ENABLED << get_bf_bit_position(static_cast<key_type>(key)));
+		if (bits != BITS_ALL_DISABLED)
+			return static_cast<size_type>((segment << BITFIELD_MAX_VALUE_BITS) | std::countr_zero(bits));
+
+		++segment;
+		size_t summary = segment >> SUMMARY_MAX_VALUE_BITS;
+		const size_t summary_count = get_summary_size(capacity_);
+		if (summary >= summary_count)
+			return capacity_;
+
+		summary_type segments = used_summary_[summary] & (~static_cast<summary_type>(0) << (segment & (BITS_IN_SUMMARY - 1)));
+		while (segments == 0)
+		{
+			if (++summary == summary_count)
+				return capacity_;
+			segments = used_summary_[summary];
+		}
+
+		segment = (summary << SUMMARY_MAX_VALUE_BITS) | std::countr_zero(segments);
+		return static_cast<size_type>((segment << BITFIELD_MAX_VALUE_BITS) | std::countr_zero(items_state_[segment]));
+	}
+
+	template <typename Map, typename Function>
+	static void for_each_occupied_impl(Map& map, Function& func)
+	{
+		const size_type summary_count = get_summary_size(map.capacity_);
+		for (size_type summary = 0; summary < summary_count; ++summary)
+		{
+			for (summary_type segments = map.used_summary_[summary]; segments != 0; segments &= segments - 1)
+			{
+				const size_t segment = (static_cast<size_t>(summary) << SUMMARY_MAX_VALUE_BITS) | std::countr_zero(segments);
+				for (bitfield_type bits = map.items_state_[segment]; bits != BITS_ALL_DISABLED; bits &= bits - 1)
+				{
+					const key_type key = static_cast<key_type>((segment << BITFIELD_MAX_VALUE_BITS) | std::countr_zero(bits));
+					func(key, map.data_[key]);
+				}
+			}
+		}
+	}
+
+	static size_type get_summary_index(size_type segment) noexcept
+	{
+		return segment >> SUMMARY_MAX_VALUE_BITS;
+	}
+
+	static summary_type get_summary_bit(size_type segment) noexcept
+	{
+		return static_cast<summary_type>(1) << (segment & (BITS_IN_SUMMARY - 1));
+	}
+
+	static size_type get_summary_size(size_type capacity) noexcept
+	{
+		return static_cast<size_type>((static_cast<size_t>(get_bitfield_size(capacity)) + BITS_IN_SUMMARY - 1) >> SUMMARY_MAX_VALUE_BITS);
+	}
+
+	static size_type get_top_size(size_type capacity) noexcept
+	{
+		return static_cast<size_type>((static_cast<size_t>(get_summary_size(capacity)) + BITS_IN_SUMMARY - 1) >> SUMMARY_MAX_VALUE_BITS);
 	}
 
 	static size_type get_bf_segment(key_type key) noexcept
@@ -366,10 +604,62 @@ private:
 		return capacity >> BITFIELD_MAX_VALUE_BITS;
 	}
 
+	// Forward iterator over occupied cells. Dereferences to value, key() returns its key.
+	template <typename Map, typename Reference>
+	class basic_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename Map::value_type;
+		using difference_type = ptrdiff_t;
+		using pointer = std::remove_reference_t<Reference>*;
+		using reference = Reference;
+
+		basic_iterator() noexcept :
+			map_(nullptr),
+			key_(0)
+		{
+		}
+
+		basic_iterator(Map* map, size_type key) noexcept :
+			map_(map),
+			key_(key)
+		{
+		}
+
+		reference operator*() const noexcept { return map_->data_[key_]; }
+		pointer operator->() const noexcept { return &map_->data_[key_]; }
+		key_type key() const noexcept { return key_; }
+
+		basic_iterator& operator++() noexcept
+		{
+			key_ = map_->find_next_occupied(static_cast<size_t>(key_) + 1);
+			return *this;
+		}
+
+		basic_iterator operator++(int) noexcept
+		{
+			basic_iterator ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator==(const basic_iterator& other) const noexcept { return key_ == other.key_; }
+		bool operator!=(const basic_iterator& other) const noexcept { return key_ != other.key_; }
+
+	private:
+		Map* map_;
+		size_type key_;
+	};
+
 	pointer data_;
 	bitfield_type* items_state_;
+	summary_type* free_summary_;
+	summary_type* used_summary_;
+	summary_type* free_top_;
 	size_type size_;
 	size_type capacity_;
+	size_type free_hint_;
 	allocator_type alloc_;
 };
 } // namespace A3D
@@ -22,10 +22,13 @@
 #include <iterator>
 #include <memory>
 #include <utility>
+#include "hash_bytes.h"
 #include "noexcept_allocator.h"
 
 namespace A3D
 {
+// Strings up to INLINE_CAPACITY characters are stored inside the object itself and copied by value.
+// Longer strings are allocated on the heap and shared between copies by reference counter.
 template <typename Char = char, typename Allocator = A3D::noexcept_allocator<Char>>
 class basic_string
 {
@@ -44,38 +47,35 @@ public:
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+	// Inline buffer reuses heap pointers storage and takes the same space as pointers and size: 23 chars for 64-bit char string.
+	static constexpr size_type INLINE_CAPACITY = static_cast<size_type>((sizeof(pointer) + sizeof(size_type*) + sizeof(size_type)) / sizeof(Char) - 1);
+
 	basic_string() :
-		str_(nullptr),
-		refs_(nullptr),
 		size_(0)
 	{
+		storage_.inline_str[0] = '\0';
 	}
 
 	explicit basic_string(Allocator&& alloc) :
-		alloc_(std::forward<Allocator>(alloc)),
-		str_(nullptr),
-		refs_(nullptr),
-		size_(0)
+		size_(0),
+		alloc_(std::forward<Allocator>(alloc))
 	{
+		storage_.inline_str[0] = '\0';
 	}
 
-	basic_string(const_pointer str) { copy_new_str(str); }
-	basic_string(const_pointer str, Allocator&& alloc) : alloc_(std::forward<Allocator>(alloc)) { copy_new_str(str); }
+	basic_string(const_pointer str) { copy_new_str(str, szstr_length(str)); }
+	basic_string(const_pointer str, Allocator&& alloc) : alloc_(std::forward<Allocator>(alloc)) { copy_new_str(str, szstr_length(str)); }
 
 	basic_string(const basic_string& src) :
-		alloc_(src.alloc_),
-		refs_(src.refs_),
-		str_(src.str_),
-		size_(src.size_)
+		alloc_(src.alloc_)
 	{
-		++*refs_;
+		share_str(src);
 	}
 
 	basic_string(basic_string&& src) noexcept :
-		alloc_(src.alloc_),
-		refs_(src.refs_),
-		str_(src.str_),
-		size_(src.size_)
+		storage_(src.storage_),
+		size_(src.size_),
+		alloc_(src.alloc_)
 	{
 		src.set_empty();
 	}
@@ -84,26 +84,27 @@ public:
 
 	void operator=(const_pointer str)
 	{
-		delete_str();
-		copy_new_str(str);
+		// Source may point into this string, so release old buffer after copying.
+		basic_string tmp(str);
+		*this = std::move(tmp);
 	}
 
 	void operator=(const basic_string& src)
 	{
+		if (this == &src)
+			return;
 		delete_str();
 		alloc_ = src.alloc_;
-		refs_ = src.refs_;
-		str_ = src.str_;
-		size_ = src.size_;
-		++*refs_;
+		share_str(src);
 	}
 
 	void operator=(basic_string&& src) noexcept
 	{
+		if (this == &src)
+			return;
 		delete_str();
 		alloc_ = src.alloc_;
-		refs_ = src.refs_;
-		str_ = src.str_;
+		storage_ = src.storage_;
 		size_ = src.size_;
 		src.set_empty();
 	}
@@ -111,21 +112,21 @@ public:
 	basic_string operator+(const_pointer rhs) const
 	{
 		basic_string ret;
-		ret.concat_string(str_, rhs, szstr_length(rhs));
+		ret.concat_string(c_str(), size_, rhs, szstr_length(rhs));
 		return ret;
 	}
 
 	basic_string operator+(const basic_string& rhs) const
 	{
 		basic_string ret;
-		ret.concat_string(str_, rhs.str_, rhs.size_);
+		ret.concat_string(c_str(), size_, rhs.c_str(), rhs.size_);
 		return ret;
 	}
 
-	void operator+=(const_pointer rhs) { append_string(rhs, size_ + szstr_length(rhs)); }
-	void operator+=(const basic_string& rhs) { append_string(rhs.c_str(), size_ + rhs.size_); }
+	void operator+=(const_pointer rhs) { append_string(rhs, szstr_length(rhs)); }
+	void operator+=(const basic_string& rhs) { append_string(rhs.c_str(), rhs.size_); }
 	bool operator==(const_pointer rhs) const { return compare_string(rhs); }
-	bool operator==(const basic_string& rhs) const { return compare_string(rhs.c_str()); }
+	bool operator==(const basic_string& rhs) const { return size_ == rhs.size_ && compare_string(rhs.c_str()); }
 
 	void clear()
 	{
@@ -134,18 +135,19 @@ public:
 	}
 
 	bool empty() const { return size_ == 0; }
-	const_pointer c_str() const { return str_; }
-	const_pointer data() const { return str_; }
+	bool is_inline() const { return size_ <= INLINE_CAPACITY; }
+	const_pointer c_str() const { return is_inline() ? storage_.inline_str : storage_.heap.str; }
+	const_pointer data() const { return c_str(); }
 	size_type size() const { return size_; }
 	size_type length() const { return size(); }
-	size_type refs() const { return *refs_; }
-
-	pointer front() { return str_; }
-	pointer back() { return str_ + size_; }
-	const_pointer front() const { return str_; }
-	const_pointer back() const { return str_ + size_; }
-	reference at(size_type index) { return str_[index]; }
-	const_reference at(size_type index) const { return str_[index]; }
+	size_type refs() const { return is_inline() ? 1 : *storage_.heap.refs; }
+
+	pointer front() { return is_inline() ? storage_.inline_str : storage_.heap.str; }
+	pointer back() { return front() + size_; }
+	const_pointer front() const { return c_str(); }
+	const_pointer back() const { return c_str() + size_; }
+	reference at(size_type index) { return front()[index]; }
+	const_reference at(size_type index) const { return front()[index]; }
 	reference operator[](size_type index) { return at(index); }
 	const_reference operator[](size_type index) const { return at(index); }
 
@@ -167,100 +169,76 @@ public:
 	const_reverse_iterator crend() const { return std::make_reverse_iterator(begin()); }
 
 private:
-	void alloc_memory(pointer& str, size_type*& refs, size_type length)
+	explicit basic_string(const allocator_type& alloc) :
+		size_(0),
+		alloc_(alloc)
 	{
-		pointer data = alloc_.allocate(size_ + 1 + sizeof(*refs_));
-		str = data + sizeof(*refs);
-		refs = (size_type*)data;
-		*refs = 1;
+		storage_.inline_str[0] = '\0';
 	}
 
-	void alloc_new_str(size_type length)
+	// Count of chars, that reference counter takes in front of heap string.
+	static constexpr size_type REFS_SIZE = static_cast<size_type>((sizeof(size_type) + sizeof(Char) - 1) / sizeof(Char));
+
+	// Set string size and return storage for length chars and terminating zero.
+	pointer alloc_new_str(size_type length)
 	{
-		alloc_memory(str_, refs_, length);
+		size_ = length;
+		if (is_inline())
+			return storage_.inline_str;
+
+		pointer data = alloc_.allocate(REFS_SIZE + length + 1);
+		storage_.heap.refs = reinterpret_cast<size_type*>(data);
+		storage_.heap.str = data + REFS_SIZE;
+		*storage_.heap.refs = 1;
+		return storage_.heap.str;
 	}
 
 	void delete_str()
 	{
-		if (refs_)
-		{
-			--*refs_;
-			if (*refs_ == 0)
-				alloc_.deallocate((pointer)refs_, size_ + 1 + sizeof(*refs_));
-		}
+		if (!is_inline() && --*storage_.heap.refs == 0)
+			alloc_.deallocate(reinterpret_cast<pointer>(storage_.heap.refs), REFS_SIZE + size_ + 1);
 	}
 
-	void copy_new_str(const_pointer str)
+	void share_str(const basic_string& src)
 	{
-		size_ = szstr_length(str);
-		alloc_new_str(size_);
-		const_pointer src = str;
-		pointer dst = str_;
-		for (; src < str + size_; ++src, ++dst)
-			*dst = *src;
-		*dst = '\0';
+		storage_ = src.storage_;
+		size_ = src.size_;
+		if (!is_inline())
+			++*storage_.heap.refs;
+	}
+
+	void copy_new_str(const_pointer str, size_type length)
+	{
+		pointer dst = alloc_new_str(length);
+		copy_chars(dst, str, length);
+		dst[length] = '\0';
 	}
 
 	void set_empty()
 	{
-		refs_ = nullptr;
-		str_ = nullptr;
 		size_ = 0;
+		storage_.inline_str[0] = '\0';
 	}
 
 	void append_string(const_pointer rhs, size_type rhs_size)
 	{
-		size_ = size_ + rhs_size;
-		pointer newstr;
-		size_type* newrefs;
-		alloc_memory(newstr, newrefs, size_);
-		pointer dstchr = newstr;
-		const_pointer srcchr = str_;
-		while (*srcchr != '\0')
-		{
-			*dstchr = *srcchr;
-			++srcchr;
-			++dstchr;
-		}
-		srcchr = rhs;
-		while (*srcchr != '\0')
-		{
-			*dstchr = *srcchr;
-			++srcchr;
-			++dstchr;
-		}
-		*dstchr = '\0';
-		delete_str();
-		str_ = newstr;
-		refs_ = newrefs;
+		basic_string tmp(alloc_);
+		tmp.concat_string(c_str(), size_, rhs, rhs_size);
+		*this = std::move(tmp);
 	}
 
-	void concat_string(const_pointer lhs, const_pointer rhs, size_type result_size)
+	void concat_string(const_pointer lhs, size_type lhs_size, const_pointer rhs, size_type rhs_size)
 	{
-		size_ = result_size;
-		alloc_new_str(size_);
-		pointer dstchr = str_;
-		const_pointer srcchr = lhs;
-		while (*srcchr != '\0')
-		{
-			*dstchr = *srcchr;
-			++srcchr;
-			++dstchr;
-		}
-		srcchr = rhs;
-		while (*srcchr != '\0')
-		{
-			*dstchr = *srcchr;
-			++srcchr;
-			++dstchr;
-		}
-		*dstchr = '\0';
+		pointer dst = alloc_new_str(lhs_size + rhs_size);
+		copy_chars(dst, lhs, lhs_size);
+		copy_chars(dst + lhs_size, rhs, rhs_size);
+		dst[lhs_size + rhs_size] = '\0';
 	}
 
 	bool compare_string(const_pointer rhs) const
 	{
-		const_pointer lhs = str_;
-		while (*lhs == '\0' && *rhs == '\0')
+		const_pointer lhs = c_str();
+		while (*lhs == *rhs && *lhs != '\0')
 		{
 			++lhs;
 			++rhs;
@@ -268,6 +246,12 @@ private:
 		return *lhs == *rhs;
 	}
 
+	static void copy_chars(pointer dst, const_pointer src, size_type length)
+	{
+		for (const_pointer end = src + length; src < end; ++src, ++dst)
+			*dst = *src;
+	}
+
 	static size_type szstr_length(const_pointer str)
 	{
 		size_type count = 0;
@@ -279,10 +263,21 @@ private:
 		return count;
 	}
 
-	pointer str_;
-	size_type* refs_;
+	struct heap_storage
+	{
+		pointer str;
+		size_type* refs;
+	};
+
+	union storage
+	{
+		heap_storage heap;
+		Char inline_str[INLINE_CAPACITY + 1];
+	};
+
+	storage storage_;
 	size_type size_;
-	allocator_type alloc_;
+	[[no_unique_address]] allocator_type alloc_;
 };
 
 using string = basic_string<char, A3D::noexcept_allocator<char>>;
@@ -295,19 +290,7 @@ struct hash<A3D::basic_string<T, Allocator>>
 {
 	constexpr size_t operator()(const A3D::basic_string<T, Allocator>& str) const noexcept
 	{
-		auto chr = str.begin();
-		size_t hash = 0;
-		while (*chr)
-		{
-			hash += (size_t)*chr;
-			hash += (hash << 10Lu);
-			hash ^= (hash << 6Lu);
-			++chr;
-		}
-		hash += (hash << 3Lu);
-		hash ^= (hash << 11Lu);
-		hash += (hash << 15Lu);
-		return hash;
+		return static_cast<size_t>(A3D::hash_bytes(str.c_str(), str.size()));
 	}
 };
 }
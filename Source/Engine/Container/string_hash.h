@@ -20,6 +20,7 @@
 #define CONTAINER_STRING_HASH_H
 
 #include <stdint.h>
+#include "hash_bytes.h"
 #include "string.h"
 
 namespace std
@@ -29,29 +30,20 @@ struct hash<const char*>
 {
 	constexpr size_t operator()(const char* str) const noexcept
 	{
-		size_t hash = 0;
-		while (*str)
-		{
-			hash += (size_t)*str;
-			hash += (hash << 10Lu);
-			hash ^= (hash << 6Lu);
-			++str;
-		}
-		hash += (hash << 3Lu);
-		hash ^= (hash << 11Lu);
-		hash += (hash << 15Lu);
-		return hash;
+		return static_cast<size_t>(A3D::hash_string(str));
 	}
 };
 }
 
 namespace A3D
 {
+// Hash of string, used as compact key instead of the string itself.
+// Different strings may have the same hash: maps keyed by it must compare stored string on hit.
 template <typename String, typename Hasher = std::hash<String>>
 class basic_string_hash
 {
 public:
-	using value_type = size_t;
+	using value_type = uint64_t;
 	using string_type = String;
 	using hasher_type = Hasher;
 
@@ -66,7 +58,7 @@ public:
 	}
 
 	constexpr basic_string_hash(const char* str) noexcept :
-		hash_(std::hash<const char*>{}(str))
+		hash_(A3D::hash_string(str))
 	{
 	}
 
@@ -82,7 +74,7 @@ public:
 
 	constexpr void operator=(const char* str) noexcept
 	{
-		hash_ = std::hash<const char*>{}(str);
+		hash_ = A3D::hash_string(str);
 	}
 
 	constexpr void operator=(const basic_string_hash& other) noexcept
@@ -110,6 +102,30 @@ private:
 };
 
 using string_hash = basic_string_hash<string>;
+
+// Strings, string hashes and zero-terminated strings of the same text have equal hashes,
+// so that containers keyed by them are searched by const char* without temporary string.
+struct string_hasher
+{
+	using is_transparent = void;
+
+	constexpr size_t operator()(const char* str) const noexcept
+	{
+		return static_cast<size_t>(hash_string(str));
+	}
+
+	template <typename Char, typename Allocator>
+	constexpr size_t operator()(const basic_string<Char, Allocator>& str) const noexcept
+	{
+		return std::hash<basic_string<Char, Allocator>>{}(str);
+	}
+
+	template <typename String>
+	constexpr size_t operator()(basic_string_hash<String> str) const noexcept
+	{
+		return static_cast<size_t>(str.hash());
+	}
+};
 } // namespace A3D
 
 namespace std
@@ -117,9 +133,9 @@ namespace std
 template <typename String, typename Hasher>
 struct hash<A3D::basic_string_hash<String, Hasher>>
 {
-	size_t operator()(A3D::basic_string_hash<String, Hasher> str) const noexcept
+	constexpr size_t operator()(A3D::basic_string_hash<String, Hasher> str) const noexcept
 	{
-		return str.hash();
+		return static_cast<size_t>(str.hash());
 	}
 };
 }
@@ -25,13 +25,16 @@
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include "cpp_lifecycle.h"
+#include "growth_policy.h"
 #include "noexcept_allocator.h"
 
 namespace A3D
 {
 template <typename Key,
 		  typename Value,
-		  typename Allocator = noexcept_allocator<Value>>
+		  typename Allocator = noexcept_allocator<Value>,
+		  typename GrowthPolicy = growth_default>
 class vector
 {
 public:
@@ -43,6 +46,7 @@ public:
 	using pointer = value_type*;
 	using const_pointer = const value_type*;
 	using allocator_type = Allocator;
+	using growth_policy = GrowthPolicy;
 	using iterator = pointer;
 	using const_iterator = const_pointer;
 
@@ -152,8 +156,8 @@ public:
 	template <typename... Args>
 	bool emplace_back(Args&&... args)
 	{
-		if (size_ + 1 > capacity_)
-			if (!reserve(capacity_ + GROW_FACTOR))
+		if (size_ == capacity_)
+			if (capacity_ == MAX_CAPACITY || !reserve(growth_policy::grow(capacity_, static_cast<size_type>(size_ + 1), sizeof(value_type))))
 				return false;
 
 		if constexpr (std::is_trivial<value_type>::value)
@@ -193,34 +197,10 @@ public:
 
 	bool reserve(size_type count)
 	{
-		pointer new_data = alloc_.allocate(count);
-		if (new_data == nullptr)
-			return false;
-
-		if (capacity_ > 0)
-		{
-			if constexpr (std::is_trivial<value_type>::value)
-				memcpy(new_data, data_, capacity_ * sizeof(value_type));
-			else
-			{
-				iterator src_it = begin();
-				const const_iterator src_end = end();
-				iterator dst_it = new_data;
-				for (; src_it != src_end; ++src_it, ++dst_it)
-					std::construct_at((pointer)dst_it, std::move(*src_it));
-			}
-
-			if constexpr (!std::is_trivial<value_type>::value)
-				for (iterator it = begin(); it != end(); ++it)
-					std::destroy_at(it);
-
-			alloc_.deallocate(data_, capacity_);
-		}
+		if (count <= capacity_)
+			return true;
 
-		data_ = new_data;
-		capacity_ = count;
-
-		return true;
+		return reallocate(count);
 	}
 
 	void shrink(size_type count)
@@ -234,45 +214,66 @@ public:
 
 	bool shrink_to_fit()
 	{
-		if (size_ > 0)
-		{
-			pointer new_data = alloc_.allocate(size_);
-			if (new_data == nullptr)
-				return false;
+		if (size_ == capacity_)
+			return true;
 
-			if (capacity_ > 0)
-			{
-				if constexpr (std::is_trivial<value_type>::value)
-					memcpy(new_data, data_, size_ * sizeof(value_type));
-				else
-				{
-					const_iterator src_it = begin();
-					pointer dst_ptr = new_data;
-					const pointer dst_end = new_data + size();
-					for (; dst_ptr != dst_end; ++src_it, ++dst_ptr)
-						std::construct_at(dst_ptr, std::move(*src_it));
-
-					const const_iterator src_end = end();
-					for (; src_it != src_end; ++src_it)
-						std::destroy_at(src_it);
-				}
-			}
-
-			data_ = new_data;
-		}
+		if (size_ > 0)
+			return reallocate(size_);
 
-		capacity_ = size_;
+		destroy();
+		capacity_ = 0;
 
 		return true;
 	}
 
+	// Allocated memory including unused tail.
 	size_t memory_size() const noexcept
 	{
 		return capacity_ * sizeof(value_type);
 	}
 
+	// Allocated but unused tail memory.
+	size_t memory_slack() const noexcept
+	{
+		return (capacity_ - size_) * sizeof(value_type);
+	}
+
 private:
-	static constexpr size_type GROW_FACTOR = 16;
+	static constexpr size_type MAX_CAPACITY = std::numeric_limits<size_type>::max();
+
+	// Move items to the new storage with count capacity. Count must be not less than size.
+	bool reallocate(size_type count)
+	{
+		if constexpr (is_trivially_relocatable_v<value_type> && reallocatable_allocator<allocator_type>)
+		{
+			if (capacity_ > 0)
+			{
+				pointer new_data = alloc_.reallocate(data_, capacity_, count);
+				if (new_data == nullptr)
+					return false;
+
+				data_ = new_data;
+				capacity_ = count;
+
+				return true;
+			}
+		}
+
+		pointer new_data = alloc_.allocate(count);
+		if (new_data == nullptr)
+			return false;
+
+		if (capacity_ > 0)
+		{
+			relocate_n(new_data, data_, size_);
+			alloc_.deallocate(data_, capacity_);
+		}
+
+		data_ = new_data;
+		capacity_ = count;
+
+		return true;
+	}
 
 	void destroy()
 	{
@@ -0,0 +1,66 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_VIRTUAL_MEMORY_H
+#define CONTAINER_VIRTUAL_MEMORY_H
+
+#include <stddef.h>
+#include "System/VirtualMemory.h"
+
+namespace A3D
+{
+// Thin wrappers over system virtual memory calls, so that containers stay free of platform headers.
+// Sizes and addresses passed to commit and decommit must be multiples of page size.
+namespace virtual_memory
+{
+inline size_t page_size() noexcept
+{
+	static const size_t ret = A3D_GetPageSize();
+	return ret;
+}
+
+inline size_t round_to_pages(size_t size) noexcept
+{
+	const size_t page = page_size();
+	return (size + page - 1) & ~(page - 1);
+}
+
+// Returns nullptr on failure.
+inline void* reserve(size_t size) noexcept
+{
+	return A3D_ReserveMemory(size);
+}
+
+inline bool commit(void* ptr, size_t size) noexcept
+{
+	return A3D_CommitMemory(ptr, size);
+}
+
+inline void decommit(void* ptr, size_t size) noexcept
+{
+	A3D_DecommitMemory(ptr, size);
+}
+
+inline void release(void* ptr, size_t size) noexcept
+{
+	A3D_ReleaseMemory(ptr, size);
+}
+} // namespace virtual_memory
+} // namespace A3D
+
+#endif // CONTAINER_VIRTUAL_MEMORY_H
@@ -0,0 +1,293 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINER_VIRTUAL_VECTOR_H
+#define CONTAINER_VIRTUAL_VECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "cpp_lifecycle.h"
+#include "growth_policy.h"
+#include "virtual_memory.h"
+
+namespace A3D
+{
+// Vector reserving address range for max_capacity items on the first insertion,
+// then committing its pages on demand. Growth never moves items, so that pointers
+// to them stay valid until they are removed. Shrink decommits unused tail pages.
+template <typename Key,
+		  typename Value,
+		  typename GrowthPolicy = growth_default>
+class virtual_vector
+{
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = key_type;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using growth_policy = GrowthPolicy;
+	using iterator = pointer;
+	using const_iterator = const_pointer;
+
+	static constexpr key_type INVALID_KEY = std::numeric_limits<key_type>::max();
+	static constexpr size_t DEFAULT_RESERVE_SIZE = sizeof(void*) == 8 ? 1ull << 32 : 1u << 26;
+	static constexpr size_type DEFAULT_MAX_CAPACITY = DEFAULT_RESERVE_SIZE / sizeof(value_type) < INVALID_KEY
+		? static_cast<size_type>(DEFAULT_RESERVE_SIZE / sizeof(value_type))
+		: INVALID_KEY;
+
+	virtual_vector() :
+		data_(nullptr),
+		size_(0),
+		capacity_(0),
+		max_capacity_(DEFAULT_MAX_CAPACITY)
+	{
+		static_assert(std::is_trivial<Key>::value);
+		static_assert(std::is_integral<Key>::value);
+	}
+
+	explicit virtual_vector(size_type max_capacity) :
+		data_(nullptr),
+		size_(0),
+		capacity_(0),
+		max_capacity_(max_capacity)
+	{
+		static_assert(std::is_trivial<Key>::value);
+		static_assert(std::is_integral<Key>::value);
+	}
+
+	virtual_vector(const virtual_vector& other) :
+		data_(nullptr),
+		size_(0),
+		capacity_(0),
+		max_capacity_(other.max_capacity_)
+	{
+		copy_from(other);
+	}
+
+	virtual_vector(virtual_vector&& other) noexcept :
+		data_(other.data_),
+		size_(other.size_),
+		capacity_(other.capacity_),
+		max_capacity_(other.max_capacity_)
+	{
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+	}
+
+	~virtual_vector() { release(); }
+
+	void operator=(const virtual_vector& other)
+	{
+		clear();
+		copy_from(other);
+	}
+
+	void operator=(virtual_vector&& other) noexcept
+	{
+		release();
+
+		data_ = other.data_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		max_capacity_ = other.max_capacity_;
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+	}
+
+	iterator begin() noexcept { return data_; }
+	const_iterator begin() const noexcept { return data_; }
+	const_iterator cbegin() const noexcept { return data_; }
+	iterator end() noexcept { return data_ + size_; }
+	const_iterator end() const noexcept { return data_ + size_; }
+	const_iterator cend() const noexcept { return data_ + size_; }
+
+	value_type& front() noexcept { return data_[0]; }
+	const value_type& front() const noexcept { return data_[0]; }
+	value_type& back() noexcept { return data_[size_ - 1]; }
+	const value_type& back() const noexcept { return data_[size_ - 1]; }
+
+	value_type& operator[](key_type key) noexcept { return data_[key]; }
+	const value_type& operator[](key_type key) const noexcept { return data_[key]; }
+
+	pointer data() noexcept { return data_; }
+	const_pointer data() const noexcept { return data_; }
+
+	size_type size() const noexcept { return size_; }
+	size_type capacity() const noexcept { return capacity_; }
+	size_type max_capacity() const noexcept { return max_capacity_; }
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+	template <typename... Args>
+	bool emplace_back(Args&&... args)
+	{
+		if (size_ == capacity_)
+			if (capacity_ == max_capacity_ || !reserve(growth_policy::grow(capacity_, static_cast<size_type>(size_ + 1), sizeof(value_type))))
+				return false;
+
+		if constexpr (std::is_trivial<value_type>::value)
+			data_[size_] = { std::forward<Args>(args)... };
+		else
+			std::construct_at(&data_[size_], std::forward<Args>(args)...);
+
+		++size_;
+
+		return true;
+	}
+
+	bool push_back(const value_type& value)
+	{
+		return emplace_back(value);
+	}
+
+	bool push_back(value_type&& value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	void pop_back()
+	{
+		if constexpr (!std::is_trivial<value_type>::value)
+			std::destroy_at(&back());
+		--size_;
+	}
+
+	// Removes all items and decommits all pages. Address range stays reserved.
+	void clear()
+	{
+		destroy_n(data_, size_);
+		size_ = 0;
+		commit(0);
+	}
+
+	// Commits pages for count items. Count is clamped to max capacity.
+	bool reserve(size_type count)
+	{
+		if (count <= capacity_)
+			return true;
+
+		if (count > max_capacity_)
+		{
+			if (capacity_ == max_capacity_)
+				return false;
+			count = max_capacity_;
+		}
+
+		if (data_ == nullptr)
+		{
+			data_ = static_cast<pointer>(virtual_memory::reserve(get_reserve_size()));
+			if (data_ == nullptr)
+				return false;
+		}
+
+		return commit(count);
+	}
+
+	void shrink(size_type count)
+	{
+		if constexpr (!std::is_trivial<value_type>::value)
+			for (iterator it = begin() + count; it < end(); ++it)
+				std::destroy_at(it);
+
+		size_ = count;
+	}
+
+	// Decommits pages after the last item.
+	bool shrink_to_fit()
+	{
+		return commit(size_);
+	}
+
+	// Committed memory including unused tail.
+	size_t memory_size() const noexcept
+	{
+		return virtual_memory::round_to_pages(capacity_ * sizeof(value_type));
+	}
+
+	// Committed but unused tail memory.
+	size_t memory_slack() const noexcept
+	{
+		return memory_size() - size_ * sizeof(value_type);
+	}
+
+private:
+	size_t get_reserve_size() const noexcept
+	{
+		return virtual_memory::round_to_pages(static_cast<size_t>(max_capacity_) * sizeof(value_type));
+	}
+
+	// Commits or decommits pages, so that whole pages fit count items. Count must be not less than size.
+	bool commit(size_type count)
+	{
+		if (data_ == nullptr)
+			return count == 0;
+
+		const size_t committed = virtual_memory::round_to_pages(capacity_ * sizeof(value_type));
+		size_t required = virtual_memory::round_to_pages(count * sizeof(value_type));
+		if (required > get_reserve_size())
+			required = get_reserve_size();
+
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(data_);
+		if (required > committed)
+		{
+			if (!virtual_memory::commit(bytes + committed, required - committed))
+				return false;
+		}
+		else if (required < committed)
+			virtual_memory::decommit(bytes + required, committed - required);
+
+		const size_t fits = required / sizeof(value_type);
+		capacity_ = fits < max_capacity_ ? static_cast<size_type>(fits) : max_capacity_;
+
+		return true;
+	}
+
+	void copy_from(const virtual_vector& other)
+	{
+		if (other.size_ == 0 || !reserve(other.size_))
+			return;
+
+		copy_construct_n(data_, other.data_, other.size_);
+		size_ = other.size_;
+	}
+
+	void release()
+	{
+		if (data_ != nullptr)
+		{
+			destroy_n(data_, size_);
+			virtual_memory::release(data_, get_reserve_size());
+		}
+	}
+
+	pointer data_;
+	size_type size_;
+	size_type capacity_;
+	size_type max_capacity_;
+};
+} // namespace A3D
+
+#endif // CONTAINER_VIRTUAL_VECTOR_H
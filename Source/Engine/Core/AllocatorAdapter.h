@@ -0,0 +1,56 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_ALLOCATOR_ADAPTER_H
+#define CORE_ALLOCATOR_ADAPTER_H
+
+#include <stddef.h>
+#include <type_traits>
+#include "IAllocator.h"
+
+namespace A3D
+{
+// STL-style allocator over engine allocator interface, so that containers may be placed
+// into frame arena or any other engine allocator.
+template <typename T>
+struct allocator_adapter
+{
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+	using propagate_on_container_move_assignment = std::true_type;
+
+	explicit allocator_adapter(IAllocator* alloc) noexcept : alloc(alloc) {}
+	template <typename U> allocator_adapter(const allocator_adapter<U>& other) noexcept : alloc(other.alloc) {}
+
+	[[nodiscard]] T* allocate(size_t n) noexcept { return static_cast<T*>(alloc->Allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* p, size_t n) noexcept { alloc->Deallocate(p, n * sizeof(T)); }
+
+	[[nodiscard]] T* reallocate(T* p, size_t old_n, size_t new_n) noexcept
+	{
+		return static_cast<T*>(alloc->Reallocate(p, old_n * sizeof(T), new_n * sizeof(T), alignof(T)));
+	}
+
+	template <typename U>
+	bool operator==(const allocator_adapter<U>& other) const noexcept { return alloc == other.alloc; }
+
+	IAllocator* alloc;
+};
+} // namespace A3D
+
+#endif // CORE_ALLOCATOR_ADAPTER_H
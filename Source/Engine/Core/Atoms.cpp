@@ -0,0 +1,51 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Atoms.h"
+
+namespace A3D
+{
+// Capacity of the first segment, table grows past it when levels bring new names.
+static constexpr atom_table::size_type ATOMS_INITIAL_CAPACITY = 16384;
+
+static atom_table& GetAtomTable()
+{
+	static atom_table table(ATOMS_INITIAL_CAPACITY);
+	return table;
+}
+
+atom InternAtom(const char* str)
+{
+	return GetAtomTable().intern(str);
+}
+
+atom FindAtom(const char* str)
+{
+	return GetAtomTable().find(str);
+}
+
+const char* GetAtomString(atom name)
+{
+	return GetAtomTable().c_str(name);
+}
+
+uint64_t GetAtomHash(atom name)
+{
+	return GetAtomTable().hash(name);
+}
+} // namespace A3D
@@ -0,0 +1,35 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_ATOMS_H
+#define CORE_ATOMS_H
+
+#include <stdint.h>
+#include "Container/atom_table.h"
+#include "EngineAPI.h"
+
+namespace A3D
+{
+// Engine-wide table of interned resource and uniform names. Safe to call from any thread.
+ENGINEAPI_EXPORT atom InternAtom(const char* str);
+ENGINEAPI_EXPORT atom FindAtom(const char* str);
+ENGINEAPI_EXPORT const char* GetAtomString(atom name);
+ENGINEAPI_EXPORT uint64_t GetAtomHash(atom name);
+} // namespace A3D
+
+#endif // CORE_ATOMS_H
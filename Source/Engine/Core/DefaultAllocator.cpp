@@ -17,17 +17,88 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include "DefaultAllocator.h"
 
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif // _MSC_VER
+
 namespace A3D
 {
+// MSVC aligned blocks must be released by _aligned_free, so that all blocks are taken from aligned heap there.
+#ifdef _MSC_VER
+void* DefaultAllocator::Allocate(size_t size)
+{
+	return _aligned_malloc(size, DEFAULT_ALIGNMENT);
+}
+
+void* DefaultAllocator::Allocate(size_t size, size_t align)
+{
+	return _aligned_malloc(size, align > DEFAULT_ALIGNMENT ? align : DEFAULT_ALIGNMENT);
+}
+
+void* DefaultAllocator::Reallocate(void* ptr, size_t, size_t new_size, size_t align)
+{
+	if (new_size == 0)
+	{
+		_aligned_free(ptr);
+		return nullptr;
+	}
+	return _aligned_realloc(ptr, new_size, align > DEFAULT_ALIGNMENT ? align : DEFAULT_ALIGNMENT);
+}
+
+void DefaultAllocator::Deallocate(void* ptr)
+{
+	_aligned_free(ptr);
+}
+#else // _MSC_VER
 void* DefaultAllocator::Allocate(size_t size)
 {
 	return malloc(size);
 }
 
+void* DefaultAllocator::Allocate(size_t size, size_t align)
+{
+	if (align <= DEFAULT_ALIGNMENT)
+		return malloc(size);
+
+	void* ret;
+	return posix_memalign(&ret, align, size) == 0 ? ret : nullptr;
+}
+
+void* DefaultAllocator::Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align)
+{
+	if (new_size == 0)
+	{
+		free(ptr);
+		return nullptr;
+	}
+
+	if (align <= DEFAULT_ALIGNMENT)
+		return realloc(ptr, new_size);
+
+	// Realloc does not keep alignment above default one, so that aligned block is moved by copy.
+	void* ret = Allocate(new_size, align);
+	if (ret == nullptr)
+		return nullptr;
+
+	if (ptr != nullptr)
+	{
+		memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+		free(ptr);
+	}
+	return ret;
+}
+
 void DefaultAllocator::Deallocate(void* ptr)
 {
 	free(ptr);
 }
+#endif // _MSC_VER
+
+void DefaultAllocator::Deallocate(void* ptr, size_t)
+{
+	Deallocate(ptr);
+}
 } // namespace A3D
@@ -28,7 +28,13 @@ struct ENGINEAPI_EXPORT DefaultAllocator : public IAllocator
 {
 	void* Allocate(size_t size) override;
 
+	void* Allocate(size_t size, size_t align) override;
+
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
 	void Deallocate(void* ptr) override;
+
+	void Deallocate(void* ptr, size_t size) override;
 };
 } // namespace A3D
 
@@ -0,0 +1,191 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "HugePageAllocator.h"
+#include "ILog.h"
+#include "System/VirtualMemory.h"
+
+namespace A3D
+{
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+HugePageAllocator::HugePageAllocator(IAllocator* parent, size_t threshold) :
+	parent_(parent),
+	threshold_(threshold),
+	stats_{}
+{
+}
+
+HugePageAllocator::~HugePageAllocator()
+{
+	for (const auto& [ptr, block] : blocks_)
+		A3D_ReleaseMemory(ptr, block.mapped_size);
+}
+
+void* HugePageAllocator::Allocate(size_t size)
+{
+	return size < threshold_ ? parent_->Allocate(size) : AllocateHuge(size, DEFAULT_ALIGNMENT);
+}
+
+void* HugePageAllocator::Allocate(size_t size, size_t align)
+{
+	return size < threshold_ || align > HUGE_PAGE_SIZE ? parent_->Allocate(size, align) : AllocateHuge(size, align);
+}
+
+void* HugePageAllocator::Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align)
+{
+	if (ptr == nullptr)
+		return Allocate(new_size, align);
+
+	if (new_size == 0)
+	{
+		Deallocate(ptr);
+		return nullptr;
+	}
+
+	Block block;
+	const bool huge = IsHuge(ptr, block);
+	if (huge)
+	{
+		if (new_size <= block.mapped_size && new_size >= threshold_)
+			return ptr;
+	}
+	else if (new_size < threshold_ || align > HUGE_PAGE_SIZE)
+		return parent_->Reallocate(ptr, old_size, new_size, align);
+
+	void* ret = Allocate(new_size, align);
+	if (ret == nullptr)
+		return nullptr;
+
+	memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+	Deallocate(ptr);
+	return ret;
+}
+
+void HugePageAllocator::Deallocate(void* ptr)
+{
+	Block block;
+	if (IsHuge(ptr, block))
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			blocks_.erase(ptr);
+		}
+		A3D_ReleaseMemory(ptr, block.mapped_size);
+	}
+	else
+		parent_->Deallocate(ptr);
+}
+
+void HugePageAllocator::Deallocate(void* ptr, size_t size)
+{
+	Block block;
+	if (IsHuge(ptr, block))
+		Deallocate(ptr);
+	else
+		parent_->Deallocate(ptr, size);
+}
+
+HugePageAllocator::Stats HugePageAllocator::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+void HugePageAllocator::Report(ILog* log) const
+{
+	static const char* const KIND_NAMES[] = { "hugetlb", "transparent" };
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	size_t mapped = 0;
+	size_t resident = 0;
+	for (const auto& [ptr, block] : blocks_)
+	{
+		const size_t huge = A3D_GetHugePagesResidentSize(ptr, block.mapped_size);
+		log->Info("Huge block %p: %zu bytes, %s, %zu bytes in huge pages.",
+				  ptr,
+				  block.mapped_size,
+				  KIND_NAMES[static_cast<uint8_t>(block.kind)],
+				  huge);
+		mapped += block.mapped_size;
+		resident += huge;
+	}
+
+	log->Info("Huge pages: %u hugetlb blocks, %u transparent blocks, %u fallback blocks allocated. "
+			  "Live blocks take %zu bytes, %zu bytes of them in huge pages.",
+			  stats_.hugetlb_blocks,
+			  stats_.transparent_blocks,
+			  stats_.fallback_blocks,
+			  mapped,
+			  resident);
+}
+
+// Transparent huge pages are taken at page fault, so that block is reported as transparent
+// when kernel accepts advice; use Report to see how much of it was actually backed.
+void* HugePageAllocator::AllocateHuge(size_t size, size_t align)
+{
+	const size_t mapped_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+	HugePageKind kind = HugePageKind::HUGETLB;
+	void* ret = A3D_MapHugePages(mapped_size);
+	if (ret == nullptr)
+	{
+		kind = HugePageKind::TRANSPARENT;
+		ret = A3D_MapAlignedMemory(mapped_size, HUGE_PAGE_SIZE);
+		if (ret != nullptr && !A3D_AdviseHugePages(ret, mapped_size))
+		{
+			A3D_ReleaseMemory(ret, mapped_size);
+			ret = nullptr;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (ret != nullptr && blocks_.try_emplace(ret, Block{ mapped_size, kind }).first != blocks_.end())
+		{
+			if (kind == HugePageKind::HUGETLB)
+				++stats_.hugetlb_blocks;
+			else
+				++stats_.transparent_blocks;
+			stats_.mapped_size += mapped_size;
+			return ret;
+		}
+		++stats_.fallback_blocks;
+	}
+
+	if (ret != nullptr)
+		A3D_ReleaseMemory(ret, mapped_size);
+	return parent_->Allocate(size, align);
+}
+
+// Huge blocks are aligned to huge page, so that other blocks are told apart without lookup.
+bool HugePageAllocator::IsHuge(void* ptr, Block& block) const
+{
+	if ((reinterpret_cast<uintptr_t>(ptr) & (HUGE_PAGE_SIZE - 1)) != 0 || ptr == nullptr)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	const auto it = blocks_.find(ptr);
+	if (it == blocks_.end())
+		return false;
+
+	block = it->second;
+	return true;
+}
+} // namespace A3D
@@ -0,0 +1,100 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_HUGE_PAGE_ALLOCATOR_H
+#define CORE_HUGE_PAGE_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include "Container/flat_map.h"
+#include "EngineAPI.h"
+#include "IAllocator.h"
+
+namespace A3D
+{
+class ILog;
+
+enum class HugePageKind : uint8_t
+{
+	HUGETLB,
+	TRANSPARENT
+};
+
+// Places blocks not less than threshold into 2MB pages: from hugetlbfs pool when it has free pages,
+// otherwise into aligned mapping advised for transparent huge pages. Smaller blocks and blocks
+// huge pages are not supported for are served by parent allocator.
+class ENGINEAPI_EXPORT HugePageAllocator : public IAllocator
+{
+public:
+	static constexpr size_t DEFAULT_THRESHOLD = 2 * 1024 * 1024;
+	static constexpr size_t DISABLED = SIZE_MAX;
+
+	struct Stats
+	{
+		uint32_t hugetlb_blocks;
+		uint32_t transparent_blocks;
+		uint32_t fallback_blocks;
+		size_t mapped_size;
+	};
+
+	explicit HugePageAllocator(IAllocator* parent, size_t threshold = DEFAULT_THRESHOLD);
+	~HugePageAllocator() override;
+
+	HugePageAllocator(const HugePageAllocator&) = delete;
+	void operator=(const HugePageAllocator&) = delete;
+
+	void* Allocate(size_t size) override;
+
+	void* Allocate(size_t size, size_t align) override;
+
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
+	void Deallocate(void* ptr) override;
+
+	void Deallocate(void* ptr, size_t size) override;
+
+	// Blocks allocated before threshold change stay where they are.
+	void SetThreshold(size_t threshold) { threshold_ = threshold; }
+	size_t GetThreshold() const { return threshold_; }
+
+	// Counts blocks allocated since creation, fallback ones were given to parent allocator.
+	Stats GetStats() const;
+
+	// Writes live huge blocks with amount of memory kernel actually backed by huge pages.
+	void Report(ILog* log) const;
+
+private:
+	struct Block
+	{
+		size_t mapped_size;
+		HugePageKind kind;
+	};
+
+	void* AllocateHuge(size_t size, size_t align);
+	bool IsHuge(void* ptr, Block& block) const;
+
+	IAllocator* parent_;
+	size_t threshold_;
+	mutable std::mutex mutex_;
+	flat_map<void*, Block> blocks_;
+	Stats stats_;
+};
+} // namespace A3D
+
+#endif // CORE_HUGE_PAGE_ALLOCATOR_H
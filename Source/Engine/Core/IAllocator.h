@@ -19,6 +19,7 @@
 #ifndef CORE_IALLOCATOR_H
 #define CORE_IALLOCATOR_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include "EngineAPI.h"
 
@@ -26,11 +27,24 @@ namespace A3D
 {
 struct IAllocator
 {
+	// Alignment of blocks returned by Allocate without explicit alignment.
+	static constexpr size_t DEFAULT_ALIGNMENT = alignof(max_align_t);
+
 	virtual ~IAllocator() {}
 
 	virtual void* Allocate(size_t size) = 0;
 
+	// Alignment must be power of two.
+	virtual void* Allocate(size_t size, size_t align) = 0;
+
+	// Resizes block allocated with the same alignment, keeping min(old_size, new_size) first bytes.
+	// Null ptr allocates new block, zero new_size releases it. On failure returns nullptr and keeps block valid.
+	virtual void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) = 0;
+
 	virtual void Deallocate(void* ptr) = 0;
+
+	// Size must be the one block was allocated or last reallocated with.
+	virtual void Deallocate(void* ptr, size_t size) = 0;
 };
 } // namespace A3D
 
@@ -0,0 +1,193 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "LinearAllocator.h"
+
+namespace A3D
+{
+// Overflow allocation data follows its header.
+struct alignas(LinearAllocator::ALIGNMENT) LinearAllocator::OverflowHeader
+{
+	OverflowHeader* next;
+};
+
+static constexpr size_t AlignSize(size_t size, size_t alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+LinearAllocator::LinearAllocator(IAllocator* parent, size_t capacity) :
+	parent_(parent),
+	data_(nullptr),
+	used_(0),
+	capacity_(0),
+	overflow_(nullptr),
+	overflow_size_(0)
+{
+	capacity = AlignSize(capacity, ALIGNMENT);
+	if (capacity > 0)
+	{
+		data_ = static_cast<uint8_t*>(parent_->Allocate(capacity));
+		if (data_ != nullptr)
+			capacity_ = capacity;
+	}
+}
+
+LinearAllocator::~LinearAllocator()
+{
+	ReleaseOverflow();
+	if (data_ != nullptr)
+		parent_->Deallocate(data_);
+}
+
+void* LinearAllocator::Allocate(size_t size)
+{
+	size = AlignSize(size, ALIGNMENT);
+	if (size <= capacity_ - used_)
+	{
+		void* ret = data_ + used_;
+		used_ += size;
+		return ret;
+	}
+
+	return AllocateOverflow(size, ALIGNMENT);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t align)
+{
+	if (align <= ALIGNMENT)
+		return Allocate(size);
+
+	size = AlignSize(size, ALIGNMENT);
+	const uintptr_t top = reinterpret_cast<uintptr_t>(data_ + used_);
+	const size_t padding = AlignSize(top, align) - top;
+	if (data_ != nullptr && padding + size <= capacity_ - used_)
+	{
+		void* ret = data_ + used_ + padding;
+		used_ += padding + size;
+		return ret;
+	}
+
+	return AllocateOverflow(size, align);
+}
+
+void* LinearAllocator::Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align)
+{
+	if (ptr == nullptr)
+		return Allocate(new_size, align);
+
+	if (new_size == 0)
+	{
+		Deallocate(ptr, old_size);
+		return nullptr;
+	}
+
+	if (IsLast(ptr, old_size))
+	{
+		const size_t offset = static_cast<uint8_t*>(ptr) - data_;
+		if (AlignSize(new_size, ALIGNMENT) <= capacity_ - offset)
+		{
+			used_ = offset + AlignSize(new_size, ALIGNMENT);
+			return ptr;
+		}
+	}
+	else if (new_size <= old_size)
+		return ptr;
+
+	void* ret = Allocate(new_size, align);
+	if (ret == nullptr)
+		return nullptr;
+
+	memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+	Deallocate(ptr, old_size);
+	return ret;
+}
+
+void LinearAllocator::Deallocate(void*)
+{
+}
+
+void LinearAllocator::Deallocate(void* ptr, size_t size)
+{
+	if (IsLast(ptr, size))
+		used_ = static_cast<uint8_t*>(ptr) - data_;
+}
+
+void LinearAllocator::Reset()
+{
+	if (overflow_ != nullptr)
+	{
+		const size_t peak = used_ + overflow_size_;
+		ReleaseOverflow();
+
+		uint8_t* data = static_cast<uint8_t*>(parent_->Allocate(peak));
+		if (data != nullptr)
+		{
+			if (data_ != nullptr)
+				parent_->Deallocate(data_);
+			data_ = data;
+			capacity_ = peak;
+		}
+	}
+
+	used_ = 0;
+}
+
+// Parent blocks are aligned to ALIGNMENT, so that larger alignment takes padding after header.
+void* LinearAllocator::AllocateOverflow(size_t size, size_t align)
+{
+	const size_t padding = align - ALIGNMENT;
+	OverflowHeader* header = static_cast<OverflowHeader*>(parent_->Allocate(sizeof(OverflowHeader) + padding + size));
+	if (header == nullptr)
+		return nullptr;
+
+	header->next = overflow_;
+	overflow_ = header;
+	overflow_size_ += padding + size;
+	return reinterpret_cast<void*>(AlignSize(reinterpret_cast<uintptr_t>(header + 1), align));
+}
+
+void LinearAllocator::ReleaseOverflow()
+{
+	while (overflow_ != nullptr)
+	{
+		OverflowHeader* next = overflow_->next;
+		parent_->Deallocate(overflow_);
+		overflow_ = next;
+	}
+	overflow_size_ = 0;
+}
+
+bool LinearAllocator::IsLast(void* ptr, size_t size) const
+{
+	return data_ != nullptr && ptr >= data_ && static_cast<uint8_t*>(ptr) + AlignSize(size, ALIGNMENT) == data_ + used_;
+}
+
+FrameArena::FrameArena(IAllocator* parent, size_t capacity) :
+	arenas_{ { parent, capacity }, { parent, capacity } },
+	current_(0)
+{
+}
+
+void FrameArena::NextFrame()
+{
+	current_ ^= 1;
+	arenas_[current_].Reset();
+}
+} // namespace A3D
@@ -0,0 +1,98 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_LINEAR_ALLOCATOR_H
+#define CORE_LINEAR_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "EngineAPI.h"
+#include "IAllocator.h"
+
+namespace A3D
+{
+// Allocates by bumping pointer inside single block taken from parent allocator.
+// Deallocate does nothing, except for the last allocation with known size: all memory is released at once by Reset.
+// Allocations, that do not fit into block, are served by parent allocator until next Reset,
+// then block is grown to the peak usage, so that steady state costs single pointer bump.
+class ENGINEAPI_EXPORT LinearAllocator : public IAllocator
+{
+public:
+	static constexpr size_t ALIGNMENT = alignof(max_align_t);
+
+	LinearAllocator(IAllocator* parent, size_t capacity);
+	~LinearAllocator() override;
+
+	LinearAllocator(const LinearAllocator&) = delete;
+	void operator=(const LinearAllocator&) = delete;
+
+	void* Allocate(size_t size) override;
+
+	void* Allocate(size_t size, size_t align) override;
+
+	// Last allocation is resized in place.
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
+	void Deallocate(void* ptr) override;
+
+	// Last allocation is rolled back.
+	void Deallocate(void* ptr, size_t size) override;
+
+	// Releases all allocations.
+	void Reset();
+
+	size_t GetUsed() const { return used_ + overflow_size_; }
+	size_t GetCapacity() const { return capacity_; }
+
+private:
+	struct OverflowHeader;
+
+	void* AllocateOverflow(size_t size, size_t align);
+	void ReleaseOverflow();
+	bool IsLast(void* ptr, size_t size) const;
+
+	IAllocator* parent_;
+	uint8_t* data_;
+	size_t used_;
+	size_t capacity_;
+	OverflowHeader* overflow_;
+	size_t overflow_size_;
+};
+
+// Pair of linear allocators swapped every frame. Allocations of the current frame
+// stay valid during the next one, so that they may be used to pass data between frames.
+class ENGINEAPI_EXPORT FrameArena
+{
+public:
+	FrameArena(IAllocator* parent, size_t capacity);
+
+	// Starts new frame: allocations made two frames ago are released.
+	void NextFrame();
+
+	IAllocator* GetCurrent() { return &arenas_[current_]; }
+	IAllocator* GetPrevious() { return &arenas_[current_ ^ 1]; }
+
+	size_t GetUsed() const { return arenas_[current_].GetUsed(); }
+
+private:
+	LinearAllocator arenas_[2];
+	uint8_t current_;
+};
+} // namespace A3D
+
+#endif // CORE_LINEAR_ALLOCATOR_H
@@ -0,0 +1,391 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <bit>
+#include "PoolAllocator.h"
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif // _MSC_VER
+
+namespace A3D
+{
+static constexpr size_t SLAB_HEADER_SIZE = 64;
+static constexpr uint32_t MAGAZINE_SIZE = 32;
+
+static std::atomic<uint32_t> s_next_id = 1;
+
+// Slab header. Blocks are carved from the rest of slab lazily, released blocks are linked into free list.
+struct PoolAllocator::Slab
+{
+	void Link(Slab*& head)
+	{
+		prev = nullptr;
+		next = head;
+		if (head != nullptr)
+			head->prev = this;
+		head = this;
+	}
+
+	void Unlink(Slab*& head)
+	{
+		if (prev != nullptr)
+			prev->next = next;
+		else
+			head = next;
+		if (next != nullptr)
+			next->prev = prev;
+	}
+
+	Slab* prev;
+	Slab* next;
+	void* free_list;
+	uint32_t used;
+	uint32_t carved;
+	uint32_t capacity;
+	uint8_t size_class;
+};
+
+struct PoolAllocator::ThreadCache
+{
+	~ThreadCache()
+	{
+		if (owner != nullptr)
+			owner->ReleaseCache(*this);
+	}
+
+	PoolAllocator* owner = nullptr;
+	uint32_t owner_id = 0;
+	uint32_t counts[SIZE_CLASSES_COUNT] = {};
+	void* blocks[SIZE_CLASSES_COUNT][MAGAZINE_SIZE];
+};
+
+// Alignment must be at least SLAB_SIZE, so that large blocks are told apart from slab ones.
+static void* AllocateAligned(size_t size, size_t align)
+{
+#ifdef _MSC_VER
+	return _aligned_malloc(size, align);
+#else // _MSC_VER
+	void* ret;
+	return posix_memalign(&ret, align, size) == 0 ? ret : nullptr;
+#endif // _MSC_VER
+}
+
+static void FreeAligned(void* ptr)
+{
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else // _MSC_VER
+	free(ptr);
+#endif // _MSC_VER
+}
+
+PoolAllocator::PoolAllocator(bool thread_cache) :
+	classes_{},
+	id_(s_next_id.fetch_add(1, std::memory_order_relaxed)),
+	thread_cache_(thread_cache)
+{
+	static_assert(sizeof(Slab) <= SLAB_HEADER_SIZE);
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	if (thread_cache_)
+		ReleaseThreadCache();
+
+	for (SizeClass& size_class : classes_)
+	{
+		for (Slab* list : { size_class.partial, size_class.full })
+			while (list != nullptr)
+			{
+				Slab* next = list->next;
+				FreeAligned(list);
+				list = next;
+			}
+	}
+}
+
+void* PoolAllocator::Allocate(size_t size)
+{
+	if (size > MAX_BLOCK_SIZE)
+		return AllocateAligned(size, SLAB_SIZE);
+
+	return AllocateBlock(GetSizeClass(size));
+}
+
+// Block at offset of class size multiple is aligned when slab header size and class size are multiples of alignment.
+void* PoolAllocator::Allocate(size_t size, size_t align)
+{
+	if (align <= DEFAULT_ALIGNMENT)
+		return Allocate(size);
+
+	if (size <= MAX_BLOCK_SIZE && align <= SLAB_HEADER_SIZE)
+		for (uint8_t size_class = GetSizeClass(size); size_class < SIZE_CLASSES_COUNT; ++size_class)
+			if (GetClassSize(size_class) % align == 0)
+				return AllocateBlock(size_class);
+
+	return AllocateAligned(size, align > SLAB_SIZE ? align : SLAB_SIZE);
+}
+
+void* PoolAllocator::Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align)
+{
+	if (ptr == nullptr)
+		return Allocate(new_size, align);
+
+	if (new_size == 0)
+	{
+		Deallocate(ptr);
+		return nullptr;
+	}
+
+	// Block is kept when it shrinks less than twice or grows within its class.
+	if ((reinterpret_cast<uintptr_t>(ptr) & (SLAB_SIZE - 1)) == 0)
+	{
+		if (new_size <= old_size && new_size > MAX_BLOCK_SIZE)
+			return ptr;
+	}
+	else
+	{
+		const uint8_t size_class = GetSlab(ptr)->size_class;
+		if (new_size <= GetClassSize(size_class) && GetSizeClass(new_size) + 4 > size_class)
+			return ptr;
+	}
+
+	void* ret = Allocate(new_size, align);
+	if (ret == nullptr)
+		return nullptr;
+
+	memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+	Deallocate(ptr);
+	return ret;
+}
+
+void* PoolAllocator::AllocateBlock(uint8_t size_class)
+{
+	if (thread_cache_)
+	{
+		ThreadCache& cache = GetThreadCache();
+		if (cache.owner_id != id_)
+		{
+			// Cache bound to another allocator at the same address belongs to destroyed one.
+			if (cache.owner != nullptr && cache.owner != this)
+				cache.owner->ReleaseCache(cache);
+			for (uint32_t& count : cache.counts)
+				count = 0;
+			cache.owner = this;
+			cache.owner_id = id_;
+		}
+
+		uint32_t& count = cache.counts[size_class];
+		if (count == 0)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (void* block; count < MAGAZINE_SIZE / 2 && (block = TakeBlock(size_class)) != nullptr; ++count)
+				cache.blocks[size_class][count] = block;
+			if (count == 0)
+				return nullptr;
+		}
+
+		return cache.blocks[size_class][--count];
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return TakeBlock(size_class);
+}
+
+void PoolAllocator::Deallocate(void* ptr)
+{
+	// Slab blocks never start at slab boundary, it is occupied by slab header.
+	if ((reinterpret_cast<uintptr_t>(ptr) & (SLAB_SIZE - 1)) == 0)
+	{
+		FreeAligned(ptr);
+		return;
+	}
+
+	Slab* slab = GetSlab(ptr);
+
+	if (thread_cache_)
+	{
+		ThreadCache& cache = GetThreadCache();
+		if (cache.owner_id == id_)
+		{
+			const uint8_t size_class = slab->size_class;
+			uint32_t& count = cache.counts[size_class];
+			if (count == MAGAZINE_SIZE)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (; count > MAGAZINE_SIZE / 2; --count)
+				{
+					void* block = cache.blocks[size_class][count - 1];
+					ReturnBlock(block, GetSlab(block));
+				}
+			}
+
+			cache.blocks[size_class][count++] = ptr;
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ReturnBlock(ptr, slab);
+}
+
+void PoolAllocator::Deallocate(void* ptr, size_t)
+{
+	Deallocate(ptr);
+}
+
+void PoolAllocator::ReleaseThreadCache()
+{
+	ThreadCache& cache = GetThreadCache();
+	if (cache.owner_id == id_)
+		ReleaseCache(cache);
+}
+
+size_t PoolAllocator::GetSlabsCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	size_t ret = 0;
+	for (const SizeClass& size_class : classes_)
+		ret += size_class.slabs_count;
+	return ret;
+}
+
+// Four classes per power of two, so that block wastes at most quarter of its size.
+uint8_t PoolAllocator::GetSizeClass(size_t size)
+{
+	if (size <= 128)
+		return size == 0 ? 0 : static_cast<uint8_t>((size + 15) / 16 - 1);
+
+	const unsigned log = static_cast<unsigned>(std::bit_width(size - 1));
+	const size_t base = static_cast<size_t>(1) << (log - 1);
+	return static_cast<uint8_t>(8 + (log - 8) * 4 + (size - 1 - base) / (base / 4));
+}
+
+size_t PoolAllocator::GetClassSize(uint8_t size_class)
+{
+	if (size_class < 8)
+		return (static_cast<size_t>(size_class) + 1) * 16;
+
+	const size_t base = static_cast<size_t>(128) << ((size_class - 8) / 4);
+	return base + ((size_class - 8) % 4 + 1) * (base / 4);
+}
+
+PoolAllocator::Slab* PoolAllocator::GetSlab(void* ptr)
+{
+	return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~(SLAB_SIZE - 1));
+}
+
+PoolAllocator::ThreadCache& PoolAllocator::GetThreadCache()
+{
+	static thread_local ThreadCache cache;
+	return cache;
+}
+
+void* PoolAllocator::TakeBlock(uint8_t size_class)
+{
+	Slab* slab = classes_[size_class].partial;
+	if (slab == nullptr)
+	{
+		slab = CreateSlab(size_class);
+		if (slab == nullptr)
+			return nullptr;
+	}
+
+	void* ret;
+	if (slab->free_list != nullptr)
+	{
+		ret = slab->free_list;
+		slab->free_list = *static_cast<void**>(ret);
+	}
+	else
+	{
+		ret = reinterpret_cast<uint8_t*>(slab) + SLAB_HEADER_SIZE + slab->carved * GetClassSize(size_class);
+		++slab->carved;
+	}
+
+	if (++slab->used == slab->capacity)
+	{
+		slab->Unlink(classes_[size_class].partial);
+		slab->Link(classes_[size_class].full);
+	}
+
+	return ret;
+}
+
+void PoolAllocator::ReturnBlock(void* ptr, Slab* slab)
+{
+	SizeClass& size_class = classes_[slab->size_class];
+
+	*static_cast<void**>(ptr) = slab->free_list;
+	slab->free_list = ptr;
+
+	if (slab->used-- == slab->capacity)
+	{
+		slab->Unlink(size_class.full);
+		slab->Link(size_class.partial);
+	}
+
+	if (slab->used == 0 && size_class.slabs_count > 1)
+		ReleaseSlab(slab);
+}
+
+PoolAllocator::Slab* PoolAllocator::CreateSlab(uint8_t size_class)
+{
+	Slab* slab = static_cast<Slab*>(AllocateAligned(SLAB_SIZE, SLAB_SIZE));
+	if (slab == nullptr)
+		return nullptr;
+
+	slab->free_list = nullptr;
+	slab->used = 0;
+	slab->carved = 0;
+	slab->capacity = static_cast<uint32_t>((SLAB_SIZE - SLAB_HEADER_SIZE) / GetClassSize(size_class));
+	slab->size_class = size_class;
+	slab->Link(classes_[size_class].partial);
+	++classes_[size_class].slabs_count;
+
+	return slab;
+}
+
+void PoolAllocator::ReleaseSlab(Slab* slab)
+{
+	SizeClass& size_class = classes_[slab->size_class];
+	slab->Unlink(size_class.partial);
+	--size_class.slabs_count;
+	FreeAligned(slab);
+}
+
+void PoolAllocator::ReleaseCache(ThreadCache& cache)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (uint8_t size_class = 0; size_class < SIZE_CLASSES_COUNT; ++size_class)
+			for (; cache.counts[size_class] > 0; --cache.counts[size_class])
+			{
+				void* block = cache.blocks[size_class][cache.counts[size_class] - 1];
+				ReturnBlock(block, GetSlab(block));
+			}
+	}
+
+	cache.owner = nullptr;
+	cache.owner_id = 0;
+}
+} // namespace A3D
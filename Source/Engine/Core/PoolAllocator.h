@@ -0,0 +1,101 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_POOL_ALLOCATOR_H
+#define CORE_POOL_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include "EngineAPI.h"
+#include "IAllocator.h"
+
+namespace A3D
+{
+// Allocator of small blocks from size classes. Every class takes blocks from its own slabs:
+// aligned chunks of SLAB_SIZE bytes with header in front and intrusive free list of released blocks.
+// Slab is returned to the system when its last block is released, unless it is the last slab of class.
+// Blocks larger than MAX_BLOCK_SIZE are allocated directly with slab alignment,
+// so that Deallocate tells them apart from slab blocks by the pointer alone.
+// Aligned blocks are taken from the first class with size multiple of alignment.
+// With thread cache enabled every thread keeps small magazine of free blocks per class,
+// so that most of calls take no lock. Allocator with thread cache must outlive threads using it,
+// and thread uses cache of single pool allocator at a time.
+class ENGINEAPI_EXPORT PoolAllocator : public IAllocator
+{
+public:
+	static constexpr size_t SLAB_SIZE = 64 * 1024;
+	static constexpr size_t MAX_BLOCK_SIZE = 8192;
+	static constexpr uint8_t SIZE_CLASSES_COUNT = 32;
+
+	explicit PoolAllocator(bool thread_cache = false);
+	~PoolAllocator() override;
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	void operator=(const PoolAllocator&) = delete;
+
+	void* Allocate(size_t size) override;
+
+	void* Allocate(size_t size, size_t align) override;
+
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
+	void Deallocate(void* ptr) override;
+
+	void Deallocate(void* ptr, size_t size) override;
+
+	// Returns blocks cached by calling thread.
+	void ReleaseThreadCache();
+
+	size_t GetSlabsCount() const;
+
+	static uint8_t GetSizeClass(size_t size);
+	static size_t GetClassSize(uint8_t size_class);
+
+private:
+	struct Slab;
+	struct ThreadCache;
+
+	struct SizeClass
+	{
+		Slab* partial;
+		Slab* full;
+		uint32_t slabs_count;
+	};
+
+	static Slab* GetSlab(void* ptr);
+	static ThreadCache& GetThreadCache();
+
+	void* AllocateBlock(uint8_t size_class);
+
+	void* TakeBlock(uint8_t size_class);
+	void ReturnBlock(void* ptr, Slab* slab);
+	Slab* CreateSlab(uint8_t size_class);
+	void ReleaseSlab(Slab* slab);
+	void ReleaseCache(ThreadCache& cache);
+
+	mutable std::mutex mutex_;
+	SizeClass classes_[SIZE_CLASSES_COUNT];
+	const uint32_t id_;
+	const bool thread_cache_;
+
+	friend struct ThreadCache;
+};
+} // namespace A3D
+
+#endif // CORE_POOL_ALLOCATOR_H
@@ -0,0 +1,482 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <memory>
+#include "PoolAllocator.h"
+#include "ThreadCacheAllocator.h"
+
+namespace A3D
+{
+static constexpr size_t HEADER_SIZE = 16;
+static constexpr uint8_t LARGE_CLASS = UINT8_MAX;
+
+static std::atomic<uint32_t> s_next_id = 1;
+
+// Placed right before every block. Offset leads from block back to pointer given by parent allocator.
+struct alignas(HEADER_SIZE) ThreadCacheAllocator::BlockHeader
+{
+	ThreadCache* owner;
+	uint32_t offset;
+	uint8_t size_class;
+};
+
+// Bins are intrusive lists of free blocks owned by single thread.
+// Remote list is filled by other threads and is taken by owner all at once, so it needs no ABA protection.
+struct ThreadCacheAllocator::ThreadCache
+{
+	void* bins[SIZE_CLASSES_COUNT];
+	uint32_t counts[SIZE_CLASSES_COUNT];
+	ThreadCache* next;
+	bool abandoned;
+	alignas(64) std::atomic<void*> remote_free;
+};
+
+struct ThreadCacheAllocator::ThreadBinding
+{
+	~ThreadBinding()
+	{
+		if (owner != nullptr)
+			owner->AbandonCache(cache);
+	}
+
+	ThreadCacheAllocator* owner = nullptr;
+	uint32_t owner_id = 0;
+	ThreadCache* cache = nullptr;
+};
+
+static void*& Next(void* block)
+{
+	return *static_cast<void**>(block);
+}
+
+ThreadCacheAllocator::ThreadCacheAllocator() :
+	ThreadCacheAllocator(nullptr)
+{
+}
+
+ThreadCacheAllocator::ThreadCacheAllocator(IAllocator* parent) :
+	parent_(parent != nullptr ? parent : &default_alloc_),
+	caches_(nullptr),
+	parent_blocks_(0),
+	remote_frees_(0),
+	id_(s_next_id.fetch_add(1, std::memory_order_relaxed))
+{
+	static_assert(sizeof(BlockHeader) == HEADER_SIZE);
+	static_assert(DEFAULT_ALIGNMENT <= HEADER_SIZE);
+
+	for (Depot& depot : depots_)
+	{
+		depot.head = nullptr;
+		depot.count = 0;
+	}
+}
+
+ThreadCacheAllocator::~ThreadCacheAllocator()
+{
+	ThreadBinding& binding = GetBinding();
+	if (binding.owner_id == id_)
+	{
+		binding.owner = nullptr;
+		binding.owner_id = 0;
+		binding.cache = nullptr;
+	}
+
+	for (ThreadCache* cache = caches_; cache != nullptr;)
+	{
+		DrainRemote(*cache);
+		for (uint8_t size_class = 0; size_class < SIZE_CLASSES_COUNT; ++size_class)
+			Flush(*cache, size_class, 0);
+
+		ThreadCache* next = cache->next;
+		std::destroy_at(cache);
+		parent_->Deallocate(cache, sizeof(ThreadCache));
+		cache = next;
+	}
+
+	for (Depot& depot : depots_)
+		while (depot.head != nullptr)
+		{
+			void* next = Next(depot.head);
+			ReleaseSmall(depot.head);
+			depot.head = next;
+		}
+}
+
+void* ThreadCacheAllocator::Allocate(size_t size)
+{
+	if (size > MAX_BLOCK_SIZE)
+		return AllocateLarge(size, DEFAULT_ALIGNMENT);
+
+	const uint8_t size_class = GetSizeClass(size);
+
+	ThreadCache* cache = GetCache();
+	if (cache == nullptr)
+		return AllocateSmall(size_class, nullptr);
+
+	if (cache->counts[size_class] == 0)
+	{
+		DrainRemote(*cache);
+		if (cache->counts[size_class] == 0 && !Refill(*cache, size_class))
+			return nullptr;
+	}
+
+	void* ret = cache->bins[size_class];
+	cache->bins[size_class] = Next(ret);
+	--cache->counts[size_class];
+	return ret;
+}
+
+// Small blocks are aligned by default alignment only, so that stronger alignment goes to parent.
+void* ThreadCacheAllocator::Allocate(size_t size, size_t align)
+{
+	if (align <= DEFAULT_ALIGNMENT)
+		return Allocate(size);
+
+	return AllocateLarge(size, align);
+}
+
+void* ThreadCacheAllocator::Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align)
+{
+	if (ptr == nullptr)
+		return Allocate(new_size, align);
+
+	if (new_size == 0)
+	{
+		Deallocate(ptr);
+		return nullptr;
+	}
+
+	BlockHeader* header = GetHeader(ptr);
+	if (header->size_class == LARGE_CLASS)
+	{
+		// Header is moved by parent together with block contents.
+		const size_t offset = header->offset;
+		const size_t block_align = offset == HEADER_SIZE ? DEFAULT_ALIGNMENT : offset;
+		if (new_size > MAX_BLOCK_SIZE && align <= block_align)
+		{
+			uint8_t* base = static_cast<uint8_t*>(parent_->Reallocate(
+				static_cast<uint8_t*>(ptr) - offset, offset + old_size, offset + new_size, block_align));
+			return base != nullptr ? base + offset : nullptr;
+		}
+	}
+	else if (align <= DEFAULT_ALIGNMENT)
+	{
+		// Block is kept when it shrinks less than twice or grows within its class.
+		const uint8_t size_class = header->size_class;
+		if (new_size <= GetClassSize(size_class) && GetSizeClass(new_size) + 4 > size_class)
+			return ptr;
+	}
+
+	void* ret = Allocate(new_size, align);
+	if (ret == nullptr)
+		return nullptr;
+
+	memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+	Deallocate(ptr);
+	return ret;
+}
+
+void ThreadCacheAllocator::Deallocate(void* ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	BlockHeader* header = GetHeader(ptr);
+	const uint8_t size_class = header->size_class;
+	if (size_class == LARGE_CLASS)
+	{
+		parent_->Deallocate(static_cast<uint8_t*>(ptr) - header->offset);
+		return;
+	}
+
+	// Releasing thread without cache must not create one.
+	ThreadBinding& binding = GetBinding();
+	ThreadCache* cache = binding.owner_id == id_ ? binding.cache : nullptr;
+	ThreadCache* owner = header->owner;
+
+	if (owner != nullptr && owner == cache)
+	{
+		if (cache->counts[size_class] == BIN_CAPACITY)
+			Flush(*cache, size_class, BIN_CAPACITY - BATCH_SIZE);
+
+		Next(ptr) = cache->bins[size_class];
+		cache->bins[size_class] = ptr;
+		++cache->counts[size_class];
+	}
+	else if (owner != nullptr)
+	{
+		void* head = owner->remote_free.load(std::memory_order_relaxed);
+		do
+			Next(ptr) = head;
+		while (!owner->remote_free.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+		remote_frees_.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+		PushDepot(size_class, ptr, ptr, 1);
+}
+
+void ThreadCacheAllocator::Deallocate(void* ptr, size_t)
+{
+	Deallocate(ptr);
+}
+
+void ThreadCacheAllocator::ReleaseThreadCache()
+{
+	ThreadBinding& binding = GetBinding();
+	if (binding.owner_id != id_)
+		return;
+
+	DrainRemote(*binding.cache);
+	for (uint8_t size_class = 0; size_class < SIZE_CLASSES_COUNT; ++size_class)
+		Flush(*binding.cache, size_class, 0);
+}
+
+ThreadCacheAllocator::Stats ThreadCacheAllocator::GetStats() const
+{
+	Stats ret{};
+	ret.parent_blocks = parent_blocks_.load(std::memory_order_relaxed);
+	ret.remote_frees = remote_frees_.load(std::memory_order_relaxed);
+
+	for (const Depot& depot : depots_)
+	{
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		ret.depot_blocks += depot.count;
+	}
+
+	std::lock_guard<std::mutex> lock(caches_mutex_);
+	for (const ThreadCache* cache = caches_; cache != nullptr; cache = cache->next)
+		++ret.caches_count;
+
+	return ret;
+}
+
+uint8_t ThreadCacheAllocator::GetSizeClass(size_t size)
+{
+	return PoolAllocator::GetSizeClass(size);
+}
+
+size_t ThreadCacheAllocator::GetClassSize(uint8_t size_class)
+{
+	return PoolAllocator::GetClassSize(size_class);
+}
+
+ThreadCacheAllocator::ThreadBinding& ThreadCacheAllocator::GetBinding()
+{
+	static thread_local ThreadBinding binding;
+	return binding;
+}
+
+ThreadCacheAllocator::BlockHeader* ThreadCacheAllocator::GetHeader(void* ptr)
+{
+	return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - HEADER_SIZE);
+}
+
+ThreadCacheAllocator::ThreadCache* ThreadCacheAllocator::GetCache()
+{
+	ThreadBinding& binding = GetBinding();
+	if (binding.owner_id == id_)
+		return binding.cache;
+
+	// Binding to another allocator at the same address belongs to destroyed one.
+	if (binding.owner != nullptr && binding.owner != this)
+		binding.owner->AbandonCache(binding.cache);
+
+	binding.cache = AdoptCache();
+	binding.owner = binding.cache != nullptr ? this : nullptr;
+	binding.owner_id = binding.cache != nullptr ? id_ : 0;
+	return binding.cache;
+}
+
+// Caches of finished threads are reused, so that blocks still queued for them are not lost.
+ThreadCacheAllocator::ThreadCache* ThreadCacheAllocator::AdoptCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(caches_mutex_);
+		for (ThreadCache* cache = caches_; cache != nullptr; cache = cache->next)
+			if (cache->abandoned)
+			{
+				cache->abandoned = false;
+				return cache;
+			}
+	}
+
+	ThreadCache* cache = static_cast<ThreadCache*>(parent_->Allocate(sizeof(ThreadCache), alignof(ThreadCache)));
+	if (cache == nullptr)
+		return nullptr;
+
+	std::construct_at(cache);
+
+	std::lock_guard<std::mutex> lock(caches_mutex_);
+	cache->next = caches_;
+	caches_ = cache;
+	return cache;
+}
+
+void ThreadCacheAllocator::AbandonCache(ThreadCache* cache)
+{
+	DrainRemote(*cache);
+	for (uint8_t size_class = 0; size_class < SIZE_CLASSES_COUNT; ++size_class)
+		Flush(*cache, size_class, 0);
+
+	std::lock_guard<std::mutex> lock(caches_mutex_);
+	cache->abandoned = true;
+}
+
+void* ThreadCacheAllocator::AllocateLarge(size_t size, size_t align)
+{
+	const size_t offset = align > HEADER_SIZE ? align : HEADER_SIZE;
+	uint8_t* base = static_cast<uint8_t*>(parent_->Allocate(offset + size, align));
+	if (base == nullptr)
+		return nullptr;
+
+	BlockHeader* header = GetHeader(base + offset);
+	header->owner = nullptr;
+	header->offset = static_cast<uint32_t>(offset);
+	header->size_class = LARGE_CLASS;
+	return base + offset;
+}
+
+void* ThreadCacheAllocator::AllocateSmall(uint8_t size_class, ThreadCache* owner)
+{
+	uint8_t* base = static_cast<uint8_t*>(parent_->Allocate(HEADER_SIZE + GetClassSize(size_class)));
+	if (base == nullptr)
+		return nullptr;
+
+	parent_blocks_.fetch_add(1, std::memory_order_relaxed);
+
+	BlockHeader* header = reinterpret_cast<BlockHeader*>(base);
+	header->owner = owner;
+	header->offset = HEADER_SIZE;
+	header->size_class = size_class;
+	return base + HEADER_SIZE;
+}
+
+void ThreadCacheAllocator::ReleaseSmall(void* ptr)
+{
+	const size_t size = HEADER_SIZE + GetClassSize(GetHeader(ptr)->size_class);
+	parent_->Deallocate(GetHeader(ptr), size);
+	parent_blocks_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool ThreadCacheAllocator::Refill(ThreadCache& cache, uint8_t size_class)
+{
+	void* head;
+	uint32_t count = 0;
+	{
+		Depot& depot = depots_[size_class];
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		head = depot.head;
+		void* tail = nullptr;
+		for (void* block = head; block != nullptr && count < BATCH_SIZE; block = Next(block), ++count)
+			tail = block;
+		if (count > 0)
+		{
+			depot.head = Next(tail);
+			depot.count -= count;
+			Next(tail) = nullptr;
+		}
+	}
+
+	// Blocks change owner only while they are free.
+	for (void* block = head; count > 0 && block != nullptr; block = Next(block))
+		GetHeader(block)->owner = &cache;
+
+	if (count == 0)
+	{
+		head = nullptr;
+		for (; count < BATCH_SIZE; ++count)
+		{
+			void* block = AllocateSmall(size_class, &cache);
+			if (block == nullptr)
+				break;
+			Next(block) = head;
+			head = block;
+		}
+		if (count == 0)
+			return false;
+	}
+
+	cache.bins[size_class] = head;
+	cache.counts[size_class] = count;
+	return true;
+}
+
+void ThreadCacheAllocator::Flush(ThreadCache& cache, uint8_t size_class, uint32_t keep)
+{
+	uint32_t count = cache.counts[size_class];
+	if (count <= keep)
+		return;
+
+	// Most recently released blocks are kept, they are likely still in CPU cache.
+	void** link = &cache.bins[size_class];
+	for (uint32_t i = 0; i < keep; ++i)
+		link = &Next(*link);
+
+	void* head = *link;
+	void* tail = head;
+	for (uint32_t i = keep + 1; i < count; ++i)
+		tail = Next(tail);
+
+	*link = nullptr;
+	cache.counts[size_class] = keep;
+	PushDepot(size_class, head, tail, count - keep);
+}
+
+void ThreadCacheAllocator::DrainRemote(ThreadCache& cache)
+{
+	void* block = cache.remote_free.exchange(nullptr, std::memory_order_acquire);
+	while (block != nullptr)
+	{
+		void* next = Next(block);
+		const uint8_t size_class = GetHeader(block)->size_class;
+		if (cache.counts[size_class] == BIN_CAPACITY)
+			Flush(cache, size_class, BIN_CAPACITY - BATCH_SIZE);
+
+		Next(block) = cache.bins[size_class];
+		cache.bins[size_class] = block;
+		++cache.counts[size_class];
+		block = next;
+	}
+}
+
+// Depot keeps limited amount of blocks per class. Batch, which does not fit whole, is returned to parent
+// outside of lock, so that depot list is never walked under lock.
+void ThreadCacheAllocator::PushDepot(uint8_t size_class, void* head, void* tail, uint32_t count)
+{
+	{
+		Depot& depot = depots_[size_class];
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		if (depot.count + count <= DEPOT_CAPACITY)
+		{
+			Next(tail) = depot.head;
+			depot.head = head;
+			depot.count += count;
+			return;
+		}
+	}
+
+	Next(tail) = nullptr;
+	for (void* surplus = head; surplus != nullptr;)
+	{
+		void* next = Next(surplus);
+		ReleaseSmall(surplus);
+		surplus = next;
+	}
+}
+} // namespace A3D
@@ -0,0 +1,124 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_THREAD_CACHE_ALLOCATOR_H
+#define CORE_THREAD_CACHE_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "DefaultAllocator.h"
+#include "EngineAPI.h"
+#include "IAllocator.h"
+
+namespace A3D
+{
+// Front-end of parent allocator keeping free small blocks in per-thread bins, so that most of calls
+// take neither lock nor parent allocator. Every block has header with its size class and owning cache.
+// Block released by another thread is pushed into lock-free queue of its owner and is taken back
+// when owner runs out of blocks of that class. Overflowing bin returns half of its blocks to central depot
+// in one batch, empty bin takes batch from depot before asking parent for new blocks.
+// Allocator must outlive threads using it, and thread uses cache of single allocator at a time.
+class ENGINEAPI_EXPORT ThreadCacheAllocator : public IAllocator
+{
+public:
+	static constexpr size_t MAX_BLOCK_SIZE = 1024;
+	static constexpr uint8_t SIZE_CLASSES_COUNT = 20;
+	static constexpr uint32_t BIN_CAPACITY = 64;
+	static constexpr uint32_t BATCH_SIZE = BIN_CAPACITY / 2;
+	static constexpr uint32_t DEPOT_CAPACITY = 1024;
+
+	struct Stats
+	{
+		size_t parent_blocks;
+		size_t depot_blocks;
+		size_t remote_frees;
+		uint32_t caches_count;
+	};
+
+	// Uses own DefaultAllocator as parent.
+	ThreadCacheAllocator();
+	explicit ThreadCacheAllocator(IAllocator* parent);
+	~ThreadCacheAllocator() override;
+
+	ThreadCacheAllocator(const ThreadCacheAllocator&) = delete;
+	void operator=(const ThreadCacheAllocator&) = delete;
+
+	void* Allocate(size_t size) override;
+
+	void* Allocate(size_t size, size_t align) override;
+
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
+	void Deallocate(void* ptr) override;
+
+	void Deallocate(void* ptr, size_t size) override;
+
+	// Returns blocks cached by calling thread to depot.
+	void ReleaseThreadCache();
+
+	// Parent blocks are small blocks currently taken from parent allocator, cached ones included.
+	Stats GetStats() const;
+
+	// Same size classes as PoolAllocator, cut at MAX_BLOCK_SIZE.
+	static uint8_t GetSizeClass(size_t size);
+	static size_t GetClassSize(uint8_t size_class);
+
+private:
+	struct BlockHeader;
+	struct ThreadCache;
+	struct ThreadBinding;
+
+	struct alignas(64) Depot
+	{
+		mutable std::mutex mutex;
+		void* head;
+		uint32_t count;
+	};
+
+	static ThreadBinding& GetBinding();
+	static BlockHeader* GetHeader(void* ptr);
+
+	ThreadCache* GetCache();
+	ThreadCache* AdoptCache();
+	void AbandonCache(ThreadCache* cache);
+
+	void* AllocateLarge(size_t size, size_t align);
+	void* AllocateSmall(uint8_t size_class, ThreadCache* owner);
+	void ReleaseSmall(void* ptr);
+
+	bool Refill(ThreadCache& cache, uint8_t size_class);
+	void Flush(ThreadCache& cache, uint8_t size_class, uint32_t keep);
+	void DrainRemote(ThreadCache& cache);
+	void PushDepot(uint8_t size_class, void* head, void* tail, uint32_t count);
+
+	DefaultAllocator default_alloc_;
+	IAllocator* parent_;
+	Depot depots_[SIZE_CLASSES_COUNT];
+	mutable std::mutex caches_mutex_;
+	ThreadCache* caches_;
+	std::atomic<size_t> parent_blocks_;
+	std::atomic<size_t> remote_frees_;
+	const uint32_t id_;
+
+	friend struct ThreadBinding;
+};
+} // namespace A3D
+
+#endif // CORE_THREAD_CACHE_ALLOCATOR_H
@@ -0,0 +1,328 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <bit>
+#include "ILog.h"
+#include "TrackingAllocator.h"
+
+namespace A3D
+{
+// Header lies right before the block. Offset is distance from parent block start to the block.
+struct BlockHeader
+{
+	uint64_t size;
+	uint32_t offset;
+	uint8_t tag;
+};
+
+static constexpr size_t HEADER_SIZE = IAllocator::DEFAULT_ALIGNMENT;
+static_assert(sizeof(BlockHeader) <= HEADER_SIZE);
+
+static std::atomic<uint8_t> s_next_shard = 0;
+
+static const char* const TAG_NAMES[] = { "General", "Server", "Renderer", "Scene", "Resources", "Plugins" };
+static_assert(sizeof(TAG_NAMES) / sizeof(TAG_NAMES[0]) == TrackingAllocator::TAGS_COUNT);
+
+static BlockHeader* GetHeader(void* ptr)
+{
+	return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - HEADER_SIZE);
+}
+
+static size_t GetHeaderOffset(size_t align)
+{
+	return align > HEADER_SIZE ? align : HEADER_SIZE;
+}
+
+static uint8_t GetSizeBucket(size_t size)
+{
+	if (size <= 16)
+		return 0;
+	const unsigned bucket = static_cast<unsigned>(std::bit_width(size - 1)) - 4;
+	return static_cast<uint8_t>(bucket < TrackingAllocator::SIZE_BUCKETS_COUNT ? bucket : TrackingAllocator::SIZE_BUCKETS_COUNT - 1);
+}
+
+TrackingAllocator::TrackingAllocator(IAllocator* parent) :
+	parent_(parent),
+	shards_{},
+	peak_bytes_{},
+	frame_allocations_(0),
+	rate_histogram_{}
+{
+	for (uint8_t tag = 0; tag < TAGS_COUNT; ++tag)
+	{
+		tagged_[tag].owner = this;
+		tagged_[tag].tag = static_cast<MemoryTag>(tag);
+	}
+}
+
+void* TrackingAllocator::Allocate(size_t size)
+{
+	return AllocateTagged(size, DEFAULT_ALIGNMENT, MemoryTag::GENERAL);
+}
+
+void* TrackingAllocator::Allocate(size_t size, size_t align)
+{
+	return AllocateTagged(size, align, MemoryTag::GENERAL);
+}
+
+void* TrackingAllocator::Reallocate(void* ptr, size_t, size_t new_size, size_t align)
+{
+	return ReallocateTagged(ptr, new_size, align, MemoryTag::GENERAL);
+}
+
+void TrackingAllocator::Deallocate(void* ptr)
+{
+	DeallocateTagged(ptr);
+}
+
+void TrackingAllocator::Deallocate(void* ptr, size_t)
+{
+	DeallocateTagged(ptr);
+}
+
+TrackingAllocator::TagStats TrackingAllocator::GetStats(MemoryTag tag) const
+{
+	const uint8_t index = static_cast<uint8_t>(tag);
+
+	TagStats ret{};
+	uint64_t deallocations = 0;
+	int64_t live = 0;
+	for (const Shard& shard : shards_)
+	{
+		ret.allocations += shard.allocations[index].load(std::memory_order_relaxed);
+		deallocations += shard.deallocations[index].load(std::memory_order_relaxed);
+		live += shard.live_bytes[index].load(std::memory_order_relaxed);
+		for (uint8_t bucket = 0; bucket < SIZE_BUCKETS_COUNT; ++bucket)
+			ret.size_histogram[bucket] += shard.size_histogram[index][bucket].load(std::memory_order_relaxed);
+	}
+	ret.live_blocks = static_cast<size_t>(ret.allocations - deallocations);
+	// Shards are read one by one, so that concurrent release may be seen before its allocation.
+	ret.live_bytes = live > 0 ? static_cast<size_t>(live) : 0;
+
+	const size_t peak = peak_bytes_[index].load(std::memory_order_relaxed);
+	const size_t frame_peak = GetFramePeak(index);
+	ret.peak_bytes = peak > frame_peak ? peak : frame_peak;
+	if (ret.peak_bytes < ret.live_bytes)
+		ret.peak_bytes = ret.live_bytes;
+
+	return ret;
+}
+
+void TrackingAllocator::NextFrame()
+{
+	const uint64_t allocations = GetAllocationsCount();
+	const uint64_t count = allocations - frame_allocations_;
+	frame_allocations_ = allocations;
+
+	const unsigned bucket = static_cast<unsigned>(std::bit_width(count));
+	++rate_histogram_[bucket < RATE_BUCKETS_COUNT ? bucket : RATE_BUCKETS_COUNT - 1];
+
+	// High-water marks restart from current live bytes, so that releases of other threads are not piled up.
+	for (uint8_t tag = 0; tag < TAGS_COUNT; ++tag)
+	{
+		const size_t frame_peak = GetFramePeak(tag);
+		if (frame_peak > peak_bytes_[tag].load(std::memory_order_relaxed))
+			peak_bytes_[tag].store(frame_peak, std::memory_order_relaxed);
+		for (Shard& shard : shards_)
+			shard.peak_bytes[tag].store(shard.live_bytes[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+void TrackingAllocator::Report(ILog* log) const
+{
+	char buffer[512];
+
+	for (uint8_t tag = 0; tag < TAGS_COUNT; ++tag)
+	{
+		const TagStats stats = GetStats(static_cast<MemoryTag>(tag));
+		if (stats.allocations == 0)
+			continue;
+
+		log->Info("Memory of %s: %zu bytes in %zu blocks, peak %zu bytes, %llu allocations.",
+				  TAG_NAMES[tag],
+				  stats.live_bytes,
+				  stats.live_blocks,
+				  stats.peak_bytes,
+				  static_cast<unsigned long long>(stats.allocations));
+
+		int length = 0;
+		buffer[0] = '\0';
+		for (uint8_t bucket = 0; bucket < SIZE_BUCKETS_COUNT && length < static_cast<int>(sizeof(buffer)); ++bucket)
+			if (stats.size_histogram[bucket] > 0)
+				length += snprintf(buffer + length,
+								   sizeof(buffer) - length,
+								   " %zu:%llu",
+								   static_cast<size_t>(16) << bucket,
+								   static_cast<unsigned long long>(stats.size_histogram[bucket]));
+		log->Info("Memory of %s by block sizes:%s", TAG_NAMES[tag], buffer);
+	}
+
+	int length = 0;
+	buffer[0] = '\0';
+	for (uint8_t bucket = 0; bucket < RATE_BUCKETS_COUNT && length < static_cast<int>(sizeof(buffer)); ++bucket)
+		if (rate_histogram_[bucket] > 0)
+			length += snprintf(buffer + length,
+							   sizeof(buffer) - length,
+							   " %llu:%llu",
+							   1ull << bucket,
+							   static_cast<unsigned long long>(rate_histogram_[bucket]));
+	if (length > 0)
+		log->Info("Frames by allocations count:%s", buffer);
+}
+
+bool TrackingAllocator::ReportLeaks(ILog* log) const
+{
+	bool ret = true;
+	for (uint8_t tag = 0; tag < TAGS_COUNT; ++tag)
+	{
+		const TagStats stats = GetStats(static_cast<MemoryTag>(tag));
+		if (stats.live_blocks > 0)
+		{
+			log->Error("Memory leak in %s: %zu blocks of %zu bytes are not released.", TAG_NAMES[tag], stats.live_blocks, stats.live_bytes);
+			ret = false;
+		}
+	}
+	return ret;
+}
+
+const char* TrackingAllocator::GetTagName(MemoryTag tag)
+{
+	return TAG_NAMES[static_cast<uint8_t>(tag)];
+}
+
+void* TrackingAllocator::TaggedAllocator::Allocate(size_t size)
+{
+	return owner->AllocateTagged(size, DEFAULT_ALIGNMENT, tag);
+}
+
+void* TrackingAllocator::TaggedAllocator::Allocate(size_t size, size_t align)
+{
+	return owner->AllocateTagged(size, align, tag);
+}
+
+void* TrackingAllocator::TaggedAllocator::Reallocate(void* ptr, size_t, size_t new_size, size_t align)
+{
+	return owner->ReallocateTagged(ptr, new_size, align, tag);
+}
+
+void TrackingAllocator::TaggedAllocator::Deallocate(void* ptr)
+{
+	owner->DeallocateTagged(ptr);
+}
+
+void TrackingAllocator::TaggedAllocator::Deallocate(void* ptr, size_t)
+{
+	owner->DeallocateTagged(ptr);
+}
+
+void* TrackingAllocator::AllocateTagged(size_t size, size_t align, MemoryTag tag)
+{
+	const size_t offset = GetHeaderOffset(align);
+	uint8_t* block = static_cast<uint8_t*>(parent_->Allocate(offset + size, align));
+	if (block == nullptr)
+		return nullptr;
+
+	void* ret = block + offset;
+	*GetHeader(ret) = { size, static_cast<uint32_t>(offset), static_cast<uint8_t>(tag) };
+	CountAllocation(size, static_cast<uint8_t>(tag));
+	return ret;
+}
+
+// Block keeps its tag, whichever allocator reallocates it.
+void* TrackingAllocator::ReallocateTagged(void* ptr, size_t new_size, size_t align, MemoryTag tag)
+{
+	if (ptr == nullptr)
+		return AllocateTagged(new_size, align, tag);
+
+	if (new_size == 0)
+	{
+		DeallocateTagged(ptr);
+		return nullptr;
+	}
+
+	const BlockHeader header = *GetHeader(ptr);
+	uint8_t* block = static_cast<uint8_t*>(parent_->Reallocate(static_cast<uint8_t*>(ptr) - header.offset,
+															  header.offset + header.size,
+															  header.offset + new_size,
+															  align));
+	if (block == nullptr)
+		return nullptr;
+
+	void* ret = block + header.offset;
+	GetHeader(ret)->size = new_size;
+	CountDeallocation(header.size, header.tag);
+	CountAllocation(new_size, header.tag);
+	return ret;
+}
+
+void TrackingAllocator::DeallocateTagged(void* ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	const BlockHeader header = *GetHeader(ptr);
+	CountDeallocation(header.size, header.tag);
+	parent_->Deallocate(static_cast<uint8_t*>(ptr) - header.offset, header.offset + header.size);
+}
+
+void TrackingAllocator::CountAllocation(size_t size, uint8_t tag)
+{
+	Shard& shard = GetShard();
+	shard.allocations[tag].fetch_add(1, std::memory_order_relaxed);
+	shard.size_histogram[tag][GetSizeBucket(size)].fetch_add(1, std::memory_order_relaxed);
+
+	// Shard is rarely shared by threads, so that raising its high-water mark seldom retries.
+	const int64_t live = shard.live_bytes[tag].fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+	int64_t peak = shard.peak_bytes[tag].load(std::memory_order_relaxed);
+	while (live > peak && !shard.peak_bytes[tag].compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		;
+}
+
+void TrackingAllocator::CountDeallocation(size_t size, uint8_t tag)
+{
+	Shard& shard = GetShard();
+	shard.deallocations[tag].fetch_add(1, std::memory_order_relaxed);
+	shard.live_bytes[tag].fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+uint64_t TrackingAllocator::GetAllocationsCount() const
+{
+	uint64_t ret = 0;
+	for (const Shard& shard : shards_)
+		for (const std::atomic<uint64_t>& allocations : shard.allocations)
+			ret += allocations.load(std::memory_order_relaxed);
+	return ret;
+}
+
+// Sum of shard high-water marks is not less than any live bytes sum reached since the last frame boundary.
+size_t TrackingAllocator::GetFramePeak(uint8_t tag) const
+{
+	int64_t ret = 0;
+	for (const Shard& shard : shards_)
+		ret += shard.peak_bytes[tag].load(std::memory_order_relaxed);
+	return ret > 0 ? static_cast<size_t>(ret) : 0;
+}
+
+// Threads are spread over shards round robin, so that counters of different threads rarely share cache line.
+TrackingAllocator::Shard& TrackingAllocator::GetShard()
+{
+	static thread_local const uint8_t index = s_next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+	return shards_[index];
+}
+} // namespace A3D
@@ -0,0 +1,144 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_TRACKING_ALLOCATOR_H
+#define CORE_TRACKING_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "EngineAPI.h"
+#include "IAllocator.h"
+
+namespace A3D
+{
+class ILog;
+
+enum class MemoryTag : uint8_t
+{
+	GENERAL,
+	SERVER,
+	RENDERER,
+	SCENE,
+	RESOURCES,
+	PLUGINS,
+	COUNT
+};
+
+// Decorator counting memory of every subsystem. Subsystem takes its own tagged allocator,
+// allocations through tracking allocator itself are tagged as general. Every block is prefixed
+// with header keeping its size and tag, so that blocks may be released through any tagged allocator.
+// Counters are atomic and split into per-thread shards, so that tracking takes no lock and threads
+// do not share cache lines. Live bytes are signed deltas of every shard, summed when stats are read.
+// Peak is taken from per-shard high-water marks, which are folded and restarted at frame boundaries:
+// it is exact for single thread and may overstate by bytes released by other threads within a frame.
+class ENGINEAPI_EXPORT TrackingAllocator : public IAllocator
+{
+public:
+	static constexpr uint8_t TAGS_COUNT = static_cast<uint8_t>(MemoryTag::COUNT);
+	static constexpr uint8_t SIZE_BUCKETS_COUNT = 24;
+	static constexpr uint8_t RATE_BUCKETS_COUNT = 16;
+	static constexpr uint8_t SHARDS_COUNT = 16;
+
+	struct TagStats
+	{
+		size_t live_bytes;
+		size_t peak_bytes;
+		size_t live_blocks;
+		uint64_t allocations;
+		// Bucket N counts blocks up to 16 << N bytes, the last one counts all larger blocks.
+		uint64_t size_histogram[SIZE_BUCKETS_COUNT];
+	};
+
+	explicit TrackingAllocator(IAllocator* parent);
+
+	TrackingAllocator(const TrackingAllocator&) = delete;
+	void operator=(const TrackingAllocator&) = delete;
+
+	void* Allocate(size_t size) override;
+
+	void* Allocate(size_t size, size_t align) override;
+
+	void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+
+	void Deallocate(void* ptr) override;
+
+	void Deallocate(void* ptr, size_t size) override;
+
+	IAllocator* GetAllocator(MemoryTag tag) { return &tagged_[static_cast<uint8_t>(tag)]; }
+
+	TagStats GetStats(MemoryTag tag) const;
+
+	// Samples allocations count of the finished frame into rate histogram and folds peaks of shards.
+	// Call it from single thread.
+	void NextFrame();
+
+	// Bucket N counts frames with less than 1 << N allocations, the last one counts all busier frames.
+	uint64_t GetRateHistogram(uint8_t bucket) const { return rate_histogram_[bucket]; }
+
+	void Report(ILog* log) const;
+
+	// Returns false when some blocks are not released.
+	bool ReportLeaks(ILog* log) const;
+
+	static const char* GetTagName(MemoryTag tag);
+
+private:
+	class TaggedAllocator : public IAllocator
+	{
+	public:
+		void* Allocate(size_t size) override;
+		void* Allocate(size_t size, size_t align) override;
+		void* Reallocate(void* ptr, size_t old_size, size_t new_size, size_t align) override;
+		void Deallocate(void* ptr) override;
+		void Deallocate(void* ptr, size_t size) override;
+
+		TrackingAllocator* owner;
+		MemoryTag tag;
+	};
+
+	struct alignas(64) Shard
+	{
+		std::atomic<uint64_t> allocations[TAGS_COUNT];
+		std::atomic<uint64_t> deallocations[TAGS_COUNT];
+		std::atomic<uint64_t> size_histogram[TAGS_COUNT][SIZE_BUCKETS_COUNT];
+		std::atomic<int64_t> live_bytes[TAGS_COUNT];
+		// The highest live bytes of shard since the last frame boundary.
+		std::atomic<int64_t> peak_bytes[TAGS_COUNT];
+	};
+
+	void* AllocateTagged(size_t size, size_t align, MemoryTag tag);
+	void* ReallocateTagged(void* ptr, size_t new_size, size_t align, MemoryTag tag);
+	void DeallocateTagged(void* ptr);
+	void CountAllocation(size_t size, uint8_t tag);
+	void CountDeallocation(size_t size, uint8_t tag);
+	uint64_t GetAllocationsCount() const;
+	size_t GetFramePeak(uint8_t tag) const;
+	Shard& GetShard();
+
+	IAllocator* parent_;
+	TaggedAllocator tagged_[TAGS_COUNT];
+	Shard shards_[SHARDS_COUNT];
+	// Peak of finished frames, written by NextFrame only.
+	std::atomic<size_t> peak_bytes_[TAGS_COUNT];
+	uint64_t frame_allocations_;
+	uint64_t rate_histogram_[RATE_BUCKETS_COUNT];
+};
+} // namespace A3D
+
+#endif // CORE_TRACKING_ALLOCATOR_H
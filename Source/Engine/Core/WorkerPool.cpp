@@ -0,0 +1,114 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "WorkerPool.h"
+
+namespace A3D
+{
+WorkerPool::WorkerPool(uint32_t workers_count) :
+	task_(nullptr),
+	data_(nullptr),
+	tasks_count_(0),
+	workers_count_(workers_count),
+	busy_count_(0),
+	generation_(0),
+	stop_(false),
+	next_task_(0)
+{
+	if (workers_count_ == 0)
+	{
+		const uint32_t hardware_threads = std::thread::hardware_concurrency();
+		workers_count_ = hardware_threads > 1 ? hardware_threads - 1 : 0;
+	}
+
+	if (workers_count_ > 0)
+	{
+		workers_.reset(new std::thread[workers_count_]);
+		for (uint32_t i = 0; i < workers_count_; ++i)
+			workers_[i] = std::thread(&WorkerPool::WorkerMain, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	start_.notify_all();
+
+	for (uint32_t i = 0; i < workers_count_; ++i)
+		workers_[i].join();
+}
+
+void WorkerPool::Run(uint32_t tasks_count, Task task, void* data)
+{
+	// Single task is not worth waking workers up.
+	if (workers_count_ == 0 || tasks_count <= 1)
+	{
+		for (uint32_t i = 0; i < tasks_count; ++i)
+			task(data, i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = task;
+		data_ = data;
+		tasks_count_ = tasks_count;
+		busy_count_ = workers_count_;
+		next_task_.store(0, std::memory_order_relaxed);
+		++generation_;
+	}
+	start_.notify_all();
+
+	Execute();
+
+	// Every worker joins every batch, so that none of them may still see this batch when the next one starts.
+	std::unique_lock<std::mutex> lock(mutex_);
+	finish_.wait(lock, [this] { return busy_count_ == 0; });
+}
+
+void WorkerPool::WorkerMain()
+{
+	uint32_t generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			start_.wait(lock, [this, generation] { return stop_ || generation_ != generation; });
+			if (stop_)
+				return;
+			generation = generation_;
+		}
+
+		Execute();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (--busy_count_ == 0)
+			finish_.notify_one();
+	}
+}
+
+void WorkerPool::Execute()
+{
+	for (uint32_t task = next_task_.fetch_add(1, std::memory_order_relaxed); task < tasks_count_;
+		 task = next_task_.fetch_add(1, std::memory_order_relaxed))
+		task_(data_, task);
+}
+} // namespace A3D
@@ -0,0 +1,72 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_WORKER_POOL_H
+#define CORE_WORKER_POOL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "EngineAPI.h"
+
+namespace A3D
+{
+// Fixed set of threads running batches of indexed tasks. Calling thread takes part in every batch,
+// tasks are taken one by one by atomic counter, so that faster threads take more of them.
+// Batches may be neither nested nor run from several threads at once.
+class ENGINEAPI_EXPORT WorkerPool
+{
+public:
+	using Task = void (*)(void* data, uint32_t task);
+
+	// Zero workers count takes one worker per hardware thread besides calling one.
+	explicit WorkerPool(uint32_t workers_count = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	void operator=(const WorkerPool&) = delete;
+
+	// Calls task for every index in [0, tasks_count) and returns when all of them are finished.
+	void Run(uint32_t tasks_count, Task task, void* data);
+
+	// Workers and calling thread.
+	uint32_t GetThreadsCount() const noexcept { return workers_count_ + 1; }
+
+private:
+	void WorkerMain();
+	void Execute();
+
+	std::unique_ptr<std::thread[]> workers_;
+	std::mutex mutex_;
+	std::condition_variable start_;
+	std::condition_variable finish_;
+	Task task_;
+	void* data_;
+	uint32_t tasks_count_;
+	uint32_t workers_count_;
+	uint32_t busy_count_;
+	uint32_t generation_;
+	bool stop_;
+	alignas(64) std::atomic<uint32_t> next_task_;
+};
+} // namespace A3D
+
+#endif // CORE_WORKER_POOL_H
@@ -23,10 +23,17 @@
 
 namespace A3D
 {
+static constexpr size_t FRAME_ARENA_SIZE = 1024 * 1024;
+
 Application::Application() :
+	huge_alloc_(&alloc_, HugePageAllocator::DISABLED),
+	tracker_(&huge_alloc_),
+	frame_arena_(&alloc_, FRAME_ARENA_SIZE),
 	plugins_(&alloc_, &log_),
 	server_(nullptr),
-	client_(nullptr)
+	client_(nullptr),
+	track_memory_(false),
+	huge_pages_(false)
 {
 }
 
@@ -66,6 +73,9 @@ bool Application::ParseArgs(StartupOptions& options, int argc, char** argv)
 					case 'h':
 						options.flags |= FLAG_HEADLESS;
 						break;
+					case 'm':
+						options.flags |= FLAG_TRACK_MEMORY;
+						break;
 					default:
 						log_.Error("Invalid startup argument: \"%s\".", *arg);
 						return false;
@@ -73,6 +83,10 @@ bool Application::ParseArgs(StartupOptions& options, int argc, char** argv)
 				}
 				else if (!strcmp(argchr, "headless"))
 					options.flags |= FLAG_HEADLESS;
+				else if (!strcmp(argchr, "track-memory"))
+					options.flags |= FLAG_TRACK_MEMORY;
+				else if (!strcmp(argchr, "huge-pages"))
+					options.flags |= FLAG_HUGE_PAGES;
 				else
 				{
 					log_.Error("Invalid startup argument: \"%s\".", *arg);
@@ -87,9 +101,14 @@ bool Application::ParseArgs(StartupOptions& options, int argc, char** argv)
 
 bool Application::Initialize(const char* window_title, const StartupOptions& options)
 {
-	server_ = new ServerEngine(&alloc_, &log_);
+	track_memory_ = (options.flags & FLAG_TRACK_MEMORY) != 0;
+	huge_pages_ = (options.flags & FLAG_HUGE_PAGES) != 0;
+	if (huge_pages_)
+		huge_alloc_.SetThreshold(HugePageAllocator::DEFAULT_THRESHOLD);
+
+	server_ = new ServerEngine(GetAllocator(MemoryTag::SERVER), &log_);
 	if ((options.flags & FLAG_HEADLESS) == 0)
-		client_ = new ClientEngine(&alloc_, &log_);
+		client_ = new ClientEngine(GetAllocator(MemoryTag::RENDERER), &log_);
 
 	if (!server_->Initialize())
 		return false;
@@ -103,6 +122,11 @@ bool Application::Initialize(const char* window_title, const StartupOptions& opt
 
 void Application::Shutdown()
 {
+	if (huge_pages_)
+	{
+		huge_alloc_.Report(&log_);
+		huge_pages_ = false;
+	}
 	if (client_)
 	{
 		client_->Shutdown();
@@ -115,6 +139,12 @@ void Application::Shutdown()
 		delete server_;
 		server_ = nullptr;
 	}
+	if (track_memory_)
+	{
+		tracker_.Report(&log_);
+		tracker_.ReportLeaks(&log_);
+		track_memory_ = false;
+	}
 }
 
 bool Application::MainLoop()
@@ -123,6 +153,10 @@ bool Application::MainLoop()
 	{
 		while (true)
 		{
+			frame_arena_.NextFrame();
+			if (track_memory_)
+				tracker_.NextFrame();
+
 			plugins_.PreUpdate(0);
 			if (!server_->PreUpdate())
 				return false;
@@ -144,6 +178,10 @@ bool Application::MainLoop()
 	}
 	else if (server_ != nullptr)
 	{
+		frame_arena_.NextFrame();
+		if (track_memory_)
+			tracker_.NextFrame();
+
 		if (!server_->PreUpdate())
 			return false;
 		if (!server_->Update())
@@ -155,6 +193,12 @@ bool Application::MainLoop()
 	return true;
 }
 
+// Tracked subsystems get tagged allocators only when tracking is enabled, so that it costs nothing otherwise.
+IAllocator* Application::GetAllocator(MemoryTag tag)
+{
+	return track_memory_ ? tracker_.GetAllocator(tag) : &huge_alloc_;
+}
+
 bool Application::LoadMainPlugin(const char* filename)
 {
 	return plugins_.Load(filename);
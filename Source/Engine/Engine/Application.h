@@ -21,6 +21,12 @@
 
 #include "Core/DefaultAllocator.h"
 #include "Core/DefaultLog.h"
+#include "Core/HugePageAllocator.h"
+#include "Core/LinearAllocator.h"
+#include "Core/PoolAllocator.h"
+#include "Core/ThreadCacheAllocator.h"
+#include "Core/TrackingAllocator.h"
+#include "EngineConfig.h"
 #include "EngineAPI.h"
 #include "PluginStorage.h"
 
@@ -39,10 +45,15 @@ public:
 
 	bool LoadMainPlugin(const char* filename);
 
+	// Scratch memory: allocations of main loop iteration live until the end of the next one.
+	FrameArena& GetFrameArena() { return frame_arena_; }
+
 private:
 	enum StartupFlags : uint8_t
 	{
-		FLAG_HEADLESS = 0x1
+		FLAG_HEADLESS = 0x1,
+		FLAG_TRACK_MEMORY = 0x2,
+		FLAG_HUGE_PAGES = 0x4
 	};
 
 	struct StartupOptions
@@ -55,11 +66,24 @@ private:
 	void Shutdown();
 	bool MainLoop();
 
+	IAllocator* GetAllocator(MemoryTag tag);
+
+#if defined(APOKALYPSE_POOL_ALLOCATOR)
+	PoolAllocator alloc_;
+#elif defined(APOKALYPSE_THREAD_CACHE)
+	ThreadCacheAllocator alloc_;
+#else
 	DefaultAllocator alloc_;
+#endif
+	HugePageAllocator huge_alloc_;
+	TrackingAllocator tracker_;
 	DefaultLog log_;
+	FrameArena frame_arena_;
 	PluginStorage plugins_;
 	ServerEngine* server_;
 	ClientEngine* client_;
+	bool track_memory_;
+	bool huge_pages_;
 };
 } // namespace A3D
 
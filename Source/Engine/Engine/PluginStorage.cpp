@@ -35,18 +35,17 @@ PluginStorage::PluginStorage(IAllocator* alloc, ILog* log) :
 
 PluginStorage::~PluginStorage()
 {
-	for (std::unique_ptr<IPlugin>& plugin : plugins_)
+	for (std::unique_ptr<IPlugin>& plugin : plugins_.column<std::unique_ptr<IPlugin>>())
+	{
 		plugin->Shutdown();
-	plugins_.clear();
+		plugin.reset();
+	}
 
-	for (void* lib : libraries_)
+	for (void* lib : plugins_.column<void*>())
 		A3D_CloseLibrary(lib);
-	libraries_.clear();
 
 	by_name_.clear();
-	indices_.clear();
-	filenames_.clear();
-	handles_.clear();
+	plugins_.clear();
 }
 
 bool PluginStorage::Load(const char* filename)
@@ -65,13 +64,8 @@ bool PluginStorage::Load(const char* filename)
 	if (!LoadAndCreate(&lib, plugin, real_filename))
 		return false;
 
-	const PluginIndex index = plugins_.insert(std::move(plugin));
-	libraries_.insert(lib);
-	filenames_.emplace(real_filename);
-
-	const PluginHandle handle = indices_.insert(index);
+	const PluginHandle handle = plugins_.insert(std::move(plugin), lib, real_filename);
 	by_name_.emplace(real_filename, handle);
-	handles_.insert(handle);
 
 	return true;
 }
@@ -88,58 +82,49 @@ void PluginStorage::Release(const char* filename)
 	const PluginHandle handle = by_name_it->second;
 	by_name_.erase(by_name_it);
 
-	const PluginIndex index = indices_[handle];
-	indices_.erase(handle);
+	plugins_.get<std::unique_ptr<IPlugin>>(handle)->Shutdown();
+	plugins_.get<std::unique_ptr<IPlugin>>(handle).reset();
+	A3D_CloseLibrary(plugins_.get<void*>(handle));
 
-	plugins_[index]->Shutdown();
-	plugins_.erase(index);
-
-	A3D_CloseLibrary(libraries_[index]);
-	libraries_.erase(index);
-
-	filenames_.erase(index);
-
-	const PluginIndex rebound_index = handles_.erase(index);
-	if (rebound_index != plugins_.INVALID_KEY)
-		indices_[handles_[rebound_index]] = index;
+	plugins_.erase(handle);
 }
 
 bool PluginStorage::ReloadAll()
 {
-	for (std::unique_ptr<IPlugin>& plugin : plugins_)
+	const dense_map<PluginHandle, string> filenames = plugins_.column<string>();
+
+	for (std::unique_ptr<IPlugin>& plugin : plugins_.column<std::unique_ptr<IPlugin>>())
+	{
 		plugin->Shutdown();
-	plugins_.clear();
+		plugin.reset();
+	}
 
-	for (void* lib : libraries_)
+	for (void* lib : plugins_.column<void*>())
 		A3D_CloseLibrary(lib);
-	libraries_.clear();
 
 	by_name_.clear();
-	indices_.clear();
-	handles_.clear();
+	plugins_.clear();
 
 	void* lib;
 	std::unique_ptr<IPlugin> plugin;
-	PluginIndex index;
 	PluginHandle handle;
-	for (string& name : filenames_)
+	for (const string& name : filenames)
 		if (LoadAndCreate(&lib, plugin, name.c_str()))
 		{
-			index = plugins_.emplace(std::move(plugin));
-			libraries_.insert(lib);
-
-			handle = indices_.insert(index);
-
+			handle = plugins_.insert(std::move(plugin), lib, name);
 			by_name_.emplace(name, handle);
-			handles_.insert(handle);
 		}
 		else
 		{
-			for (std::unique_ptr<IPlugin>& _plugin : plugins_)
+			for (std::unique_ptr<IPlugin>& _plugin : plugins_.column<std::unique_ptr<IPlugin>>())
+			{
 				_plugin->Shutdown();
-			plugins_.clear();
-			for (void* _lib : libraries_)
+				_plugin.reset();
+			}
+			for (void* _lib : plugins_.column<void*>())
 				A3D_CloseLibrary(_lib);
+			by_name_.clear();
+			plugins_.clear();
 			return false;
 		}
 
@@ -186,7 +171,7 @@ bool PluginStorage::LoadAndCreate(void** library, std::unique_ptr<IPlugin>& plug
 bool PluginStorage::PreUpdate(float elapsed_time)
 {
 	bool res = true;
-	for (std::unique_ptr<IPlugin>& plugin : plugins_)
+	for (std::unique_ptr<IPlugin>& plugin : plugins_.column<std::unique_ptr<IPlugin>>())
 		res = res && plugin->PreUpdate(elapsed_time);
 	return res;
 }
@@ -194,7 +179,7 @@ bool PluginStorage::PreUpdate(float elapsed_time)
 bool PluginStorage::Update(float elapsed_time)
 {
 	bool res = true;
-	for (std::unique_ptr<IPlugin>& plugin : plugins_)
+	for (std::unique_ptr<IPlugin>& plugin : plugins_.column<std::unique_ptr<IPlugin>>())
 		res = res && plugin->Update(elapsed_time);
 	return res;
 }
@@ -202,7 +187,7 @@ bool PluginStorage::Update(float elapsed_time)
 bool PluginStorage::PostUpdate(float elapsed_time)
 {
 	bool res = true;
-	for (std::unique_ptr<IPlugin>& plugin : plugins_)
+	for (std::unique_ptr<IPlugin>& plugin : plugins_.column<std::unique_ptr<IPlugin>>())
 		res = res && plugin->PostUpdate(elapsed_time);
 	return res;
 }
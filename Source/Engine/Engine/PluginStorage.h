@@ -20,10 +20,10 @@
 #define ENGINE_PLUGIN_STORAGE_H
 
 #include <memory>
-#include <unordered_map>
-#include "Container/dense_map.h"
-#include "Container/sparse_map.h"
+#include "Container/flat_map.h"
+#include "Container/slot_map.h"
 #include "Container/string.h"
+#include "Container/string_hash.h"
 #include "EngineAPI.h"
 #include "IPlugin.h"
 
@@ -32,8 +32,7 @@ namespace A3D
 class IAllocator;
 class ILog;
 
-using PluginHandle = uint16_t;
-using PluginIndex = uint16_t;
+using PluginHandle = uint32_t;
 
 class ENGINEAPI_EXPORT PluginStorage
 {
@@ -52,12 +51,8 @@ public:
 private:
 	bool LoadAndCreate(void** library, std::unique_ptr<IPlugin>& plugin, const char* filename);
 
-	std::unordered_map<string, PluginHandle> by_name_;
-	sparse_map<PluginHandle, PluginIndex> indices_;
-	dense_map<PluginIndex, std::unique_ptr<IPlugin>> plugins_;
-	dense_map<PluginIndex, void*> libraries_;
-	dense_map<PluginIndex, string> filenames_;
-	dense_map<PluginIndex, PluginHandle> handles_;
+	flat_map<string, PluginHandle, string_hasher, std::equal_to<>> by_name_;
+	slot_map<PluginHandle, std::unique_ptr<IPlugin>, void*, string> plugins_;
 
 	IAllocator* alloc_;
 	ILog* log_;
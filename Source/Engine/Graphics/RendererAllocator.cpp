@@ -25,53 +25,53 @@
 
 namespace A3D
 {
+// Bgfx does not pass block size to realloc, so that it is stored right before block.
+// Header takes whole alignment, so that block stays aligned.
+static size_t GetHeaderSize(size_t align)
+{
+	return align > IAllocator::DEFAULT_ALIGNMENT ? align : IAllocator::DEFAULT_ALIGNMENT;
+}
+
+static size_t& GetBlockSize(void* ptr)
+{
+	return static_cast<size_t*>(ptr)[-1];
+}
+
 void* RendererAllocator::realloc(void* _ptr,
 								size_t _size,
 								size_t _align,
 								const char* _file,
 								uint32_t _line)
 {
-	if (0 == _size)
-	{
-		if (NULL != _ptr)
-		{
-			if (BX_CONFIG_ALLOCATOR_NATURAL_ALIGNMENT >= _align)
-			{
-				alloc_->Deallocate(_ptr);
-				return NULL;
-			}
+	BX_UNUSED(_file, _line);
 
-#if BX_COMPILER_MSVC
-			BX_UNUSED(_file, _line);
-			_aligned_free(_ptr);
-#else
-			alignedFree(this, _ptr, _align, bx::Location(_file, _line));
-#endif // BX_
-		}
+	if (_align < BX_CONFIG_ALLOCATOR_NATURAL_ALIGNMENT)
+		_align = BX_CONFIG_ALLOCATOR_NATURAL_ALIGNMENT;
+	const size_t header_size = GetHeaderSize(_align);
 
+	if (NULL == _ptr && 0 == _size)
 		return NULL;
-	}
-	else if (NULL == _ptr)
+
+	uint8_t* block = NULL;
+	size_t block_size = 0;
+	if (NULL != _ptr)
 	{
-		if (BX_CONFIG_ALLOCATOR_NATURAL_ALIGNMENT >= _align)
-			return alloc_->Allocate(_size);
+		block = static_cast<uint8_t*>(_ptr) - header_size;
+		block_size = header_size + GetBlockSize(_ptr);
+	}
 
-#if BX_COMPILER_MSVC
-		BX_UNUSED(_file, _line);
-		return _aligned_malloc(_size, _align);
-#else
-		return alignedAlloc(this, _size, _align, bx::Location(_file, _line));
-#endif // BX_
+	if (0 == _size)
+	{
+		alloc_->Deallocate(block, block_size);
+		return NULL;
 	}
 
-	if (BX_CONFIG_ALLOCATOR_NATURAL_ALIGNMENT >= _align)
-		return ::realloc(_ptr, _size);
+	block = static_cast<uint8_t*>(alloc_->Reallocate(block, block_size, header_size + _size, _align));
+	if (NULL == block)
+		return NULL;
 
-#if BX_COMPILER_MSVC
-	BX_UNUSED(_file, _line);
-	return _aligned_realloc(_ptr, _size, _align);
-#else
-	return alignedRealloc(this, _ptr, _size, _align, bx::Location(_file, _line));
-#endif // BX_
+	void* ret = block + header_size;
+	GetBlockSize(ret) = _size;
+	return ret;
 }
 } // namespace A3D
@@ -0,0 +1,184 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include "VirtualMemory.h"
+
+#ifdef __WIN32__
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+size_t A3D_GetPageSize()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwPageSize;
+}
+
+void* A3D_ReserveMemory(size_t size)
+{
+	return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool A3D_CommitMemory(void* ptr, size_t size)
+{
+	return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void A3D_DecommitMemory(void* ptr, size_t size)
+{
+	VirtualFree(ptr, size, MEM_DECOMMIT);
+}
+
+void A3D_ReleaseMemory(void* ptr, size_t size)
+{
+	(void)size;
+	VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+void* A3D_MapHugePages(size_t size)
+{
+	(void)size;
+	return NULL;
+}
+
+void* A3D_MapAlignedMemory(size_t size, size_t align)
+{
+	(void)size;
+	(void)align;
+	return NULL;
+}
+
+bool A3D_AdviseHugePages(void* ptr, size_t size)
+{
+	(void)ptr;
+	(void)size;
+	return false;
+}
+
+size_t A3D_GetHugePagesResidentSize(const void* ptr, size_t size)
+{
+	(void)ptr;
+	(void)size;
+	return 0;
+}
+#else // __WIN32__
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+size_t A3D_GetPageSize()
+{
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+void* A3D_ReserveMemory(size_t size)
+{
+	void* ret = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return ret != MAP_FAILED ? ret : NULL;
+}
+
+bool A3D_CommitMemory(void* ptr, size_t size)
+{
+	return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void A3D_DecommitMemory(void* ptr, size_t size)
+{
+	madvise(ptr, size, MADV_DONTNEED);
+	mprotect(ptr, size, PROT_NONE);
+}
+
+void A3D_ReleaseMemory(void* ptr, size_t size)
+{
+	munmap(ptr, size);
+}
+
+void* A3D_MapHugePages(size_t size)
+{
+#if defined(__linux__) && defined(MAP_HUGETLB)
+	void* ret = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	return ret != MAP_FAILED ? ret : NULL;
+#else // __linux__ && MAP_HUGETLB
+	(void)size;
+	return NULL;
+#endif // __linux__ && MAP_HUGETLB
+}
+
+// Unused head and tail of the oversized mapping are given back.
+void* A3D_MapAlignedMemory(size_t size, size_t align)
+{
+	const size_t mapped = size + align;
+	uint8_t* ptr = (uint8_t*)mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == MAP_FAILED)
+		return NULL;
+
+	uint8_t* ret = (uint8_t*)(((uintptr_t)ptr + align - 1) & ~(align - 1));
+	if (ret > ptr)
+		munmap(ptr, ret - ptr);
+	if (ret + size < ptr + mapped)
+		munmap(ret + size, ptr + mapped - ret - size);
+	return ret;
+}
+
+bool A3D_AdviseHugePages(void* ptr, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	return madvise(ptr, size, MADV_HUGEPAGE) == 0;
+#else // __linux__ && MADV_HUGEPAGE
+	(void)ptr;
+	(void)size;
+	return false;
+#endif // __linux__ && MADV_HUGEPAGE
+}
+
+// Reads /proc/self/smaps. Mappings merged with neighbours are accounted whole,
+// result is clamped to range size.
+size_t A3D_GetHugePagesResidentSize(const void* ptr, size_t size)
+{
+#ifdef __linux__
+	FILE* file = fopen("/proc/self/smaps", "r");
+	if (file == NULL)
+		return 0;
+
+	const uintptr_t begin = (uintptr_t)ptr;
+	const uintptr_t end = begin + size;
+	bool overlaps = false;
+	size_t ret = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		unsigned long map_begin, map_end, kb;
+		if (sscanf(line, "%lx-%lx ", &map_begin, &map_end) == 2)
+			overlaps = map_begin < end && map_end > begin;
+		else if (overlaps &&
+				 (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1 ||
+				  sscanf(line, "Private_Hugetlb: %lu kB", &kb) == 1))
+			ret += (size_t)kb * 1024;
+	}
+	fclose(file);
+
+	return ret < size ? ret : size;
+#else // __linux__
+	(void)ptr;
+	(void)size;
+	return 0;
+#endif // __linux__
+}
+#endif // __WIN32__
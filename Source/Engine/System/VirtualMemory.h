@@ -0,0 +1,53 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYSTEM_VIRTUAL_MEMORY_H
+#define SYSTEM_VIRTUAL_MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "EngineAPI.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+// Reserved address range takes no physical memory until it is committed, decommitted pages give
+// physical memory back but keep addresses reserved. Sizes and addresses passed to commit and
+// decommit must be multiples of page size. Functions returning pointers return NULL on failure.
+ENGINEAPI_EXPORT size_t A3D_GetPageSize();
+ENGINEAPI_EXPORT void* A3D_ReserveMemory(size_t size);
+ENGINEAPI_EXPORT bool A3D_CommitMemory(void* ptr, size_t size);
+ENGINEAPI_EXPORT void A3D_DecommitMemory(void* ptr, size_t size);
+ENGINEAPI_EXPORT void A3D_ReleaseMemory(void* ptr, size_t size);
+
+// Huge pages are supported on Linux only: either from preallocated hugetlbfs pool,
+// or as transparent huge pages advised for aligned anonymous mapping.
+ENGINEAPI_EXPORT void* A3D_MapHugePages(size_t size);
+// Maps committed size bytes aligned to align, which must be multiple of page size.
+ENGINEAPI_EXPORT void* A3D_MapAlignedMemory(size_t size, size_t align);
+ENGINEAPI_EXPORT bool A3D_AdviseHugePages(void* ptr, size_t size);
+// Bytes of range actually backed by huge pages, for diagnostics only.
+ENGINEAPI_EXPORT size_t A3D_GetHugePagesResidentSize(const void* ptr, size_t size);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // SYSTEM_VIRTUAL_MEMORY_H
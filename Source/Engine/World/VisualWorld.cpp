@@ -40,23 +40,12 @@ ViewportHandle VisualWorld::CreateViewport()
 {
 	Camera camera{ GLM_MAT4_IDENTITY, GLM_MAT4_IDENTITY };
 	ViewportRect size{};
-	const ViewportIndex index = viewport_cameras_.emplace(camera);
-	viewport_sizes_.insert(size);
-	const ViewportHandle handle = { viewport_indices_.insert(index) };
-	viewport_handles_.insert(handle);
-	return handle;
+	return { viewports_.insert(camera, size) };
 }
 
 void VisualWorld::RemoveViewport(ViewportHandle viewport)
 {
-	const ViewportIndex index = viewport_indices_[viewport.id];
-	viewport_indices_.erase(viewport.id);
-
-	const ViewportIndex rebound_index = viewport_cameras_.erase(index);
-	viewport_sizes_.erase(index);
-	viewport_handles_.erase(index);
-	if (rebound_index != viewport_cameras_.INVALID_KEY)
-		viewport_indices_[viewport_handles_[index].id] = index;
+	viewports_.erase(viewport.id);
 }
 
 /*void CreateVisualWorld(VisualWorld& world)
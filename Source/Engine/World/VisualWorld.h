@@ -28,6 +28,7 @@
 #include "Common/Model.h"
 #include "Common/Viewport.h"
 #include "Container/dense_map.h"
+#include "Container/slot_map.h"
 #include "Container/sparse_map.h"
 #include "Container/vector.h"
 
@@ -42,7 +43,7 @@ struct RenderableHandle
 };
 
 using ViewportIndex = uint16_t;
-using ViewportHandleType = uint16_t;
+using ViewportHandleType = uint32_t;
 
 struct ViewportHandle
 {
@@ -73,37 +74,34 @@ public:
 
 	void RemoveViewport(ViewportHandle viewport);
 
+	bool IsViewportExists(ViewportHandle viewport) const noexcept
+	{
+		return viewports_.contains(viewport.id);
+	}
+
 	Camera& GetViewportCamera(ViewportHandle viewport)
 	{
-		return viewport_cameras_[viewport_indices_[viewport.id]];
+		return viewports_.get<Camera>(viewport.id);
 	}
 
 	ViewportRect& GetViewportSize(ViewportHandle viewport)
 	{
-		return viewport_sizes_[viewport_indices_[viewport.id]];
+		return viewports_.get<ViewportRect>(viewport.id);
 	}
 
 	const Camera& GetViewportCamera(ViewportHandle viewport) const
 	{
-		return viewport_cameras_[viewport_indices_[viewport.id]];
+		return viewports_.get<Camera>(viewport.id);
 	}
 
 	const ViewportRect& GetViewportSize(ViewportHandle viewport) const
 	{
-		return viewport_sizes_[viewport_indices_[viewport.id]];
+		return viewports_.get<ViewportRect>(viewport.id);
 	}
 
 private:
-	sparse_map<RenderableHandleType, RenderableIndex> renderable_indices_;
-	dense_map<RenderableIndex, MeshGroup> renderable_meshes_;
-	dense_map<RenderableIndex, Material> renderable_materials_;
-	dense_map<RenderableIndex, GlobalTransform> global_transforms_;
-	dense_map<RenderableIndex, RenderableHandle> renderable_handles_;
-
-	sparse_map<ViewportHandleType, ViewportIndex> viewport_indices_;
-	dense_map<ViewportIndex, Camera> viewport_cameras_;
-	dense_map<ViewportIndex, ViewportRect> viewport_sizes_;
-	dense_map<ViewportIndex, ViewportHandle> viewport_handles_;
+	slot_map<RenderableHandleType, MeshGroup, Material, GlobalTransform> renderables_;
+	slot_map<ViewportHandleType, Camera, ViewportRect> viewports_;
 };
 
 /*using ViewportIndex = uint16_t;
@@ -19,12 +19,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unordered_map>
 #include "Common/Technique.h"
-#include "Container/dense_map.h"
-#include "Container/sparse_map.h"
-#include "Container/string.h"
-#include "Container/string_hash.h"
+#include "Container/flat_map.h"
+#include "Container/small_vector.h"
+#include "Container/slot_map.h"
+#include "Core/Atoms.h"
 #include "Core/EngineLog.h"
 #include "IO/File.h"
 #include "Material.h"
@@ -38,9 +37,8 @@
 
 namespace A3D
 {
-using MaterialHandleType = uint16_t;
+using MaterialHandleType = uint32_t;
 using RefsCount = uint16_t;
-using ResourceIndex = uint16_t;
 
 // TODO: Make appropriate allocation/deallocation.
 struct UniformPair
@@ -49,17 +47,13 @@ struct UniformPair
 	char* data;
 };
 
+// Most of materials have only few parameters, so they are kept in place.
+using UniformsList = small_vector<uint8_t, UniformPair, 4>;
+
 struct MaterialCache
 {
-	std::unordered_map<string_hash, MaterialHandleType> by_name;
-	sparse_map<MaterialHandleType, ResourceIndex> indices;
-
-	dense_map<ResourceIndex, Technique> techniques;
-	dense_map<ResourceIndex, RefsCount> refs;
-	dense_map<ResourceIndex, string> filenames;
-	dense_map<ResourceIndex, MaterialHandleType> handles;
-
-	std::unordered_multimap<MaterialHandleType, UniformPair> uniforms;
+	flat_map<atom, MaterialHandleType> by_name;
+	slot_map<MaterialHandleType, Technique, RefsCount, atom, UniformsList> materials;
 };
 
 static MaterialCache s_cache;
@@ -78,7 +72,7 @@ static void ParseUniformParameter(void* data, const char* str, bgfx::UniformType
 	}
 }
 
-static bool LoadMaterialFile(Material& material, const char* filename)
+static bool LoadMaterialFile(Material& material, const char* filename, atom name)
 {
 	File file;
 	if (!OpenFileRead(file, filename))
@@ -143,15 +137,10 @@ static bool LoadMaterialFile(Material& material, const char* filename)
 		return false;
 	}
 
-	const ResourceIndex index = s_cache.handles.size();
-	material.handle = s_cache.indices.insert(index);
-
-	s_cache.by_name.emplace(filename, material.handle);
-	s_cache.techniques.insert(technique);
-	s_cache.handles.insert(material.handle);
-	s_cache.refs.insert(1);
-	s_cache.filenames.insert(filename);
+	material.handle = s_cache.materials.insert(technique, RefsCount(1), name, UniformsList());
+	s_cache.by_name.emplace(name, material.handle);
 
+	UniformsList& uniforms = s_cache.materials.get<UniformsList>(material.handle);
 	const char* name_str;
 	const char* value_str;
 	UniformPair uniform_value;
@@ -183,7 +172,7 @@ static bool LoadMaterialFile(Material& material, const char* filename)
 		uniform_value.data = (char*)malloc(GetUniformSize(uniform_value.uniform));
 		ParseUniformParameter(uniform_value.data, value_str, GetUniformType(uniform_value.uniform));
 
-		s_cache.uniforms.emplace(material.handle, uniform_value);
+		uniforms.push_back(uniform_value);
 	}
 
 	LogInfo("Material \"%s\" loaded.", filename);
@@ -192,58 +181,55 @@ static bool LoadMaterialFile(Material& material, const char* filename)
 
 bool GetMaterial(Material& material, const char* filename)
 {
-	const string_hash filename_hash = filename;
-	const auto it = s_cache.by_name.find(filename_hash);
+	const atom name = InternAtom(filename);
+	if (!name.is_valid())
+	{
+		LogFatal("Could not load material \"%s\": out of memory for name.", filename);
+		return false;
+	}
+
+	const auto it = s_cache.by_name.find(name);
 	if (it != s_cache.by_name.end())
 	{
 		material.handle = it->second;
-		++s_cache.refs[it->second];
+		++s_cache.materials.get<RefsCount>(it->second);
 		return true;
 	}
 	else
-		return LoadMaterialFile(material, filename);
+		return LoadMaterialFile(material, filename, name);
 }
 
 void ReleaseMaterial(Material material)
 {
-	const ResourceIndex index = s_cache.indices[material.handle];
-	if (--s_cache.refs[index] == 0)
+	if (--s_cache.materials.get<RefsCount>(material.handle) == 0)
 	{
-		ReleaseTechnique(s_cache.techniques[index]);
-
-		s_cache.by_name.erase(s_cache.filenames[index]);
-		s_cache.indices.erase(material.handle);
-		s_cache.uniforms.erase(material.handle);
+		ReleaseTechnique(s_cache.materials.get<Technique>(material.handle));
+		s_cache.by_name.erase(s_cache.materials.get<atom>(material.handle));
 
-		const ResourceIndex rebound = s_cache.handles.erase(index);
-		s_cache.techniques.erase(index);
-		s_cache.refs.erase(index);
-		s_cache.filenames.erase(index);
+		for (UniformPair& uniform : s_cache.materials.get<UniformsList>(material.handle))
+			free(uniform.data);
 
-		if (rebound != s_cache.handles.INVALID_KEY)
-			s_cache.indices[s_cache.handles[index]] = index;
+		s_cache.materials.erase(material.handle);
 	}
 }
 
 bgfx::ProgramHandle UseMaterial(Material material)
 {
-	const ResourceIndex index = s_cache.indices[material.handle];
+	const decltype(s_cache.materials)::index_type index = s_cache.materials.get_index(material.handle);
 
-	auto [begin, end] = s_cache.uniforms.equal_range(index);
-	for (; begin != end; ++begin)
-		bgfx::setUniform(begin->second.uniform.handle, begin->second.data, 1);
+	for (const UniformPair& uniform : s_cache.materials.column<UniformsList>()[index])
+		bgfx::setUniform(uniform.uniform.handle, uniform.data, 1);
 
-	return GetTechniqueProgram(s_cache.techniques[index]);
+	return GetTechniqueProgram(s_cache.materials.column<Technique>()[index]);
 }
 
 bgfx::ProgramHandle UseMaterial(Material material, bgfx::Encoder* queue)
 {
-	const ResourceIndex index = s_cache.indices[material.handle];
+	const decltype(s_cache.materials)::index_type index = s_cache.materials.get_index(material.handle);
 
-	auto [begin, end] = s_cache.uniforms.equal_range(index);
-	for (; begin != end; ++begin)
-		queue->setUniform(begin->second.uniform.handle, begin->second.data, 1);
+	for (const UniformPair& uniform : s_cache.materials.column<UniformsList>()[index])
+		queue->setUniform(uniform.uniform.handle, uniform.data, 1);
 
-	return GetTechniqueProgram(s_cache.techniques[index]);
+	return GetTechniqueProgram(s_cache.materials.column<Technique>()[index]);
 }
 } // namespace A3D
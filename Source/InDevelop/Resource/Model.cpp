@@ -22,12 +22,11 @@
 #include <bx/file.h>
 #include <bx/readerwriter.h>
 #include <meshoptimizer/src/meshoptimizer.h>
-#include <unordered_map>
 #include "Common/Geometry.h"
 #include "Common/Model.h"
 #include "Container/dense_map.h"
-#include "Container/string.h"
-#include "Container/string_hash.h"
+#include "Container/flat_map.h"
+#include "Core/Atoms.h"
 #include "Core/EngineLog.h"
 #include "Model.h"
 
@@ -49,11 +48,11 @@ using RefsType = uint32_t;
 
 struct MeshCache
 {
-	std::unordered_map<string_hash, ModelIndex> ids_models;
+	flat_map<atom, ModelIndex> ids_models;
 
 	dense_map<ModelIndex, Model> models;
 	dense_map<ModelIndex, RefsType> refs;
-	dense_map<ModelIndex, string> filenames;
+	dense_map<ModelIndex, atom> names;
 };
 
 static MeshCache s_cache;
@@ -256,7 +255,14 @@ static bool LoadModelFile(Model& model, const char* filename)
 
 bool GetModel(Model& model, const char* filename)
 {
-	const auto it = s_cache.ids_models.find(filename);
+	const atom name = InternAtom(filename);
+	if (!name.is_valid())
+	{
+		LogFatal("Failed to load mesh file \"%s\": out of memory for name.", filename);
+		return false;
+	}
+
+	const auto it = s_cache.ids_models.find(name);
 	if (it != s_cache.ids_models.end())
 	{
 		++s_cache.refs[it->second];
@@ -265,10 +271,10 @@ bool GetModel(Model& model, const char* filename)
 	}
 	else if (LoadModelFile(model, filename))
 	{
-		s_cache.ids_models.emplace(filename, s_cache.models.size());
+		s_cache.ids_models.emplace(name, s_cache.models.size());
 		s_cache.models.insert(model);
 		s_cache.refs.insert(1);
-		s_cache.filenames.insert(filename);
+		s_cache.names.insert(name);
 		return true;
 	}
 	else
@@ -277,18 +283,18 @@ bool GetModel(Model& model, const char* filename)
 
 void ReleaseModel(const char* filename)
 {
-	const auto it = s_cache.ids_models.find(filename);
+	const auto it = s_cache.ids_models.find(FindAtom(filename));
 	if (--s_cache.refs[it->second] == 0)
 	{
-		s_cache.ids_models.erase(filename);
-
 		const ModelIndex index = it->second;
+		s_cache.ids_models.erase(it);
+
 		const ModelIndex rebound = s_cache.models.erase(index);
 		s_cache.refs.erase(index);
-		s_cache.filenames.erase(index);
+		s_cache.names.erase(index);
 
 		if (rebound != s_cache.models.INVALID_KEY)
-			s_cache.ids_models[s_cache.filenames[index]] = index;
+			s_cache.ids_models.find(s_cache.names[index])->second = index;
 	}
 }
 } // namespace A3D
@@ -18,10 +18,9 @@
 
 #include <stdio.h>
 #include <stdint.h>
-#include <unordered_map>
 #include "Container/dense_map.h"
-#include "Container/string.h"
-#include "Container/string_hash.h"
+#include "Container/flat_map.h"
+#include "Core/Atoms.h"
 #include "Core/EngineLog.h"
 #include "Package.h"
 #include "System/FileSystem.h"
@@ -56,18 +55,18 @@ struct FileBodyMeta
 
 struct PackageCache
 {
-	std::unordered_map<string_hash, PackageIndex> ids;
+	flat_map<atom, PackageIndex> ids;
 
 	dense_map<PackageIndex, vector<FilenameIndex, FilenameIndex>> files;
-	dense_map<PackageIndex, string> filenames;
+	dense_map<PackageIndex, atom> names;
 };
 
 struct PackageFileCache
 {
-	std::unordered_map<string_hash, FilenameIndex> ids;
+	flat_map<atom, FilenameIndex> ids;
 
 	dense_map<FilenameIndex, PackageIndex> packages;
-	dense_map<FilenameIndex, string> filenames;
+	dense_map<FilenameIndex, atom> names;
 	dense_map<FilenameIndex, uint32_t> offsets;
 	dense_map<FilenameIndex, uint32_t> sizes;
 };
@@ -77,8 +76,14 @@ static PackageFileCache g_filename_cache;
 
 bool AddPackage(const char* filename)
 {
-	const string_hash filename_hash(filename);
-	const auto it = g_package_cache.ids.find(filename_hash);
+	const atom name = InternAtom(filename);
+	if (!name.is_valid())
+	{
+		LogFatal("Failed to add package file \"%s\": out of memory for name.", filename);
+		return false;
+	}
+
+	const auto it = g_package_cache.ids.find(name);
 	if (it != g_package_cache.ids.end())
 		return true;
 
@@ -102,12 +107,21 @@ bool AddPackage(const char* filename)
 
 	const PackageIndex package_index = g_package_cache.files.size();
 
+	// Index is grown once for all package files instead of rehashing while they are added.
+	if (!g_filename_cache.ids.reserve(g_filename_cache.ids.size() + ph.files_count))
+	{
+		LogFatal("Failed to add package file \"%s\": out of memory.", filename);
+		fclose(file);
+		return false;
+	}
+
 	vector<FilenameIndex, FilenameIndex> files;
 	char file_path[BUFFER_SIZE];
 	struct FileNameMeta fnm;
 	struct FileBodyMeta fbm;
 	uint32_t header_pos;
 	PackageIndex file_index;
+	atom file_name;
 	for (unsigned i = 0; i < ph.files_count; ++i)
 	{
 		fread(&fnm, sizeof(fnm), 1, file);
@@ -126,20 +140,28 @@ bool AddPackage(const char* filename)
 		file_path[fnm.size] = '\0';
 		fseek(file, (long)header_pos, SEEK_SET);
 
-		file_index = g_filename_cache.filenames.size();
+		file_index = g_filename_cache.names.size();
 		files.push_back(file_index);
 
-		g_filename_cache.ids.emplace(file_path, g_filename_cache.filenames.size());
+		file_name = InternAtom(file_path);
+		if (!file_name.is_valid())
+		{
+			LogFatal("Could not load package file \"%s\": out of memory for containing file name.", filename);
+			fclose(file);
+			return false;
+		}
+
+		g_filename_cache.ids.emplace(file_name, file_index);
 		g_filename_cache.packages.insert(package_index);
-		g_filename_cache.filenames.insert(file_path);
+		g_filename_cache.names.insert(file_name);
 		g_filename_cache.sizes.insert(fbm.size);
 		g_filename_cache.offsets.insert(fbm.offset);
 	}
 
 	fclose(file);
 
-	g_package_cache.ids.emplace(filename_hash, package_index);
-	g_package_cache.filenames.insert(filename);
+	g_package_cache.ids.emplace(name, package_index);
+	g_package_cache.names.insert(name);
 	g_package_cache.files.emplace(std::move(files));
 
 	LogInfo("Package file \"%s\" is successfully loaded.", filename);
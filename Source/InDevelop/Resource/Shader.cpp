@@ -17,10 +17,9 @@
 */
 
 #include <bgfx/bgfx.h>
-#include <unordered_map>
 #include "Container/dense_map.h"
-#include "Container/string.h"
-#include "Container/string_hash.h"
+#include "Container/flat_map.h"
+#include "Core/Atoms.h"
 #include "Core/EngineLog.h"
 #include "IO/File.h"
 #include "Shader.h"
@@ -31,18 +30,19 @@
 namespace A3D
 {
 using RefsCount = uint16_t;
-using ResourceIndex = uint16_t;
 using ShaderHandleType = decltype(bgfx::ShaderHandle::idx);
+// There are never more live shaders than bgfx handles, so that index is as wide as handle.
+using ResourceIndex = ShaderHandleType;
 using TimerType = uint8_t;
 
 struct ShaderCache
 {
-	std::unordered_map<string_hash, ShaderHandleType> by_name;
-	std::unordered_map<ShaderHandleType, ResourceIndex> indices;
+	flat_map<atom, ShaderHandleType> by_name;
+	flat_map<ShaderHandleType, ResourceIndex> indices;
 
 	dense_map<ResourceIndex, ShaderHandleType> shaders;
 	dense_map<ResourceIndex, TimerType> timers;
-	dense_map<ResourceIndex, string> filenames;
+	dense_map<ResourceIndex, atom> names;
 };
 
 static ShaderCache s_cache;
@@ -94,22 +94,28 @@ static bool LoadShaderFile(Shader& shader, const char* filename)
 
 bool GetShader(Shader& shader, const char* filename)
 {
-	const string_hash filename_hash = filename;
-	const auto it = s_cache.by_name.find(filename_hash);
+	const atom name = InternAtom(filename);
+	if (!name.is_valid())
+	{
+		LogFatal("Could not load shader \"%s\": out of memory for name.", filename);
+		return false;
+	}
+
+	const auto it = s_cache.by_name.find(name);
 	if (it != s_cache.by_name.end())
 	{
-		s_cache.timers[s_cache.indices[it->second]] = SHADER_TIMER;
+		s_cache.timers[s_cache.indices.find(it->second)->second] = SHADER_TIMER;
 		shader.handle.idx = it->second;
 		return true;
 	}
 	else if (LoadShaderFile(shader, filename))
 	{
-		s_cache.by_name.emplace(filename, shader.handle.idx);
+		s_cache.by_name.emplace(name, shader.handle.idx);
 		s_cache.indices.emplace(shader.handle.idx, s_cache.shaders.size());
 
 		s_cache.shaders.insert(shader.handle.idx);
 		s_cache.timers.insert(SHADER_TIMER);
-		s_cache.filenames.insert(filename);
+		s_cache.names.insert(name);
 
 		return true;
 	}
@@ -134,15 +140,15 @@ void UpdateShaderCache()
 			handle.idx = s_cache.shaders[index];
 			bgfx::destroy(handle);
 
-			s_cache.by_name.erase(s_cache.filenames[index]);
+			s_cache.by_name.erase(s_cache.names[index]);
 			s_cache.indices.erase(handle.idx);
 
 			rebound = s_cache.shaders.erase(index);
 			s_cache.timers.erase(index);
-			s_cache.filenames.erase(index);
+			s_cache.names.erase(index);
 
 			if (rebound != s_cache.shaders.INVALID_KEY)
-				s_cache.indices[s_cache.shaders[index]] = index;
+				s_cache.indices.find(s_cache.shaders[index])->second = index;
 		}
 	}
 }
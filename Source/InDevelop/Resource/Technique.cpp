@@ -17,11 +17,10 @@
 */
 
 #include <string.h>
-#include <unordered_map>
 #include "Container/dense_map.h"
-#include "Container/sparse_map.h"
-#include "Container/string.h"
-#include "Container/string_hash.h"
+#include "Container/flat_map.h"
+#include "Container/slot_map.h"
+#include "Core/Atoms.h"
 #include "Core/EngineLog.h"
 #include "IO/File.h"
 #include "Shader.h"
@@ -36,29 +35,25 @@
 namespace A3D
 {
 using RefsCount = uint16_t;
-using ResourceIndex = uint16_t;
 using UniformHandleType = decltype(bgfx::UniformHandle::idx);
+// There are never more live uniforms than bgfx handles, so that index is as wide as handle.
+using ResourceIndex = UniformHandleType;
 using UniformType = bgfx::UniformType::Enum;
 
 struct TechniqueCache
 {
-	std::unordered_map<string_hash, TechniqueHandle> by_name;
-	sparse_map<TechniqueHandle, ResourceIndex> indices;
-
-	dense_map<ResourceIndex, bgfx::ProgramHandle> programs;
-	dense_map<ResourceIndex, RefsCount> refs;
-	dense_map<ResourceIndex, string> filenames;
-	dense_map<ResourceIndex, TechniqueHandle> handles;
+	flat_map<atom, TechniqueHandle> by_name;
+	slot_map<TechniqueHandle, bgfx::ProgramHandle, RefsCount, atom> techniques;
 };
 
 struct UniformStorage
 {
-	std::unordered_map<string_hash, Uniform> by_name;
+	flat_map<atom, Uniform> by_name;
 
 	// TODO: Change to sparse map.
-	std::unordered_map<UniformHandleType, ResourceIndex> indices;
+	flat_map<UniformHandleType, ResourceIndex> indices;
 
-	dense_map<ResourceIndex, string> names;
+	dense_map<ResourceIndex, atom> names;
 	dense_map<ResourceIndex, UniformType> types;
 
 	// TODO: Implement techniques containing uniforms container.
@@ -83,7 +78,7 @@ inline static UniformType GetUniformType(const char* type)
 	return UniformType::End;
 }
 
-static bool LoadTechniqueFile(Technique technique, const char* filename)
+static bool LoadTechniqueFile(Technique technique, const char* filename, atom name)
 {
 	File file;
 	if (!OpenFileRead(file, filename))
@@ -143,8 +138,6 @@ static bool LoadTechniqueFile(Technique technique, const char* filename)
 	}
 	strcpy(fragment_filename, attrib->value());
 
-	const ResourceIndex index = s_cache.handles.size();
-
 	rapidxml::xml_node<>* node;
 	const char* name_str;
 	const char* type_str;
@@ -179,10 +172,18 @@ static bool LoadTechniqueFile(Technique technique, const char* filename)
 			return false;
 		}
 
-		auto it = s_uniforms.by_name.find(name_str);
+		const atom uniform_name = InternAtom(name_str);
+		if (!uniform_name.is_valid())
+		{
+			LogFatal("Could not load render technique \"%s\": out of memory for uniform name.", filename);
+			free(text);
+			return false;
+		}
+
+		auto it = s_uniforms.by_name.find(uniform_name);
 		if (it != s_uniforms.by_name.end())
 		{
-			const ResourceIndex index = s_uniforms.indices[it->second.handle.idx];
+			const ResourceIndex index = s_uniforms.indices.find(it->second.handle.idx)->second;
 
 			if (type != s_uniforms.types[index]);
 			{
@@ -205,9 +206,9 @@ static bool LoadTechniqueFile(Technique technique, const char* filename)
 
 			uniform_index = s_uniforms.names.size();
 
-			s_uniforms.by_name.emplace(name_str, uniform);
+			s_uniforms.by_name.emplace(uniform_name, uniform);
 			s_uniforms.indices.emplace(uniform.handle.idx, uniform_index);
-			s_uniforms.names.emplace(name_str);
+			s_uniforms.names.emplace(uniform_name);
 			s_uniforms.types.emplace(type);
 		}
 	}
@@ -237,13 +238,8 @@ static bool LoadTechniqueFile(Technique technique, const char* filename)
 		return false;
 	}
 
-	technique.handle = s_cache.indices.insert(index);
-
-	s_cache.by_name.emplace(filename, technique.handle);
-	s_cache.programs.insert(program);
-	s_cache.refs.insert(1);
-	s_cache.filenames.emplace(filename);
-	s_cache.handles.insert(technique.handle);
+	technique.handle = s_cache.techniques.insert(program, RefsCount(1), name);
+	s_cache.by_name.emplace(name, technique.handle);
 
 	LogInfo("Render technique \"%s\" loaded.", filename);
 	return true;
@@ -251,41 +247,37 @@ static bool LoadTechniqueFile(Technique technique, const char* filename)
 
 bool GetTechnique(Technique& technique, const char* filename)
 {
-	const string_hash filename_hash = filename;
-	const auto it = s_cache.by_name.find(filename_hash);
+	const atom name = InternAtom(filename);
+	if (!name.is_valid())
+	{
+		LogFatal("Could not load render technique \"%s\": out of memory for name.", filename);
+		return false;
+	}
+
+	const auto it = s_cache.by_name.find(name);
 	if (it != s_cache.by_name.end())
 	{
 		technique.handle = it->second;
-		++s_cache.refs[it->second];
+		++s_cache.techniques.get<RefsCount>(it->second);
 		return true;
 	}
 	else
-		return LoadTechniqueFile(technique, filename);
+		return LoadTechniqueFile(technique, filename, name);
 }
 
 void ReleaseTechnique(Technique technique)
 {
-	const ResourceIndex index = s_cache.indices[technique.handle];
-	if (--s_cache.refs[index] == 0)
+	if (--s_cache.techniques.get<RefsCount>(technique.handle) == 0)
 	{
-		bgfx::destroy(s_cache.programs[index]);
-
-		s_cache.by_name.erase(s_cache.filenames[index]);
-		s_cache.indices.erase(technique.handle);
-
-		const ResourceIndex rebound = s_cache.programs.erase(index);
-		s_cache.refs.erase(index);
-		s_cache.filenames.erase(index);
-		s_cache.handles.erase(index);
-
-		if (rebound != s_cache.handles.INVALID_KEY)
-			s_cache.indices[s_cache.handles[index]] = index;
+		bgfx::destroy(s_cache.techniques.get<bgfx::ProgramHandle>(technique.handle));
+		s_cache.by_name.erase(s_cache.techniques.get<atom>(technique.handle));
+		s_cache.techniques.erase(technique.handle);
 	}
 }
 
 bgfx::ProgramHandle GetTechniqueProgram(Technique technique)
 {
-	return s_cache.programs[s_cache.indices[technique.handle]];
+	return s_cache.techniques.get<bgfx::ProgramHandle>(technique.handle);
 }
 
 
@@ -293,7 +285,7 @@ bgfx::ProgramHandle GetTechniqueProgram(Technique technique)
 
 Uniform GetUniform(const char* name)
 {
-	const auto it = s_uniforms.by_name.find(name);
+	const auto it = s_uniforms.by_name.find(FindAtom(name));
 	if (it != s_uniforms.by_name.end())
 		return it->second;
 	else
@@ -482,9 +482,10 @@ void TransformTree::DebugPrint()
 	printf("  External identifiers:\n");
 	printf("    Size:\t%u\n", ids_.size());
 	printf("    Handle\tGeneration\tPosition\n");
-	for (unsigned i = 0; i < ids_.capacity(); ++i)
-		if (ids_.contains(i))
-			printf("    %u\t\t%u\t\t%u\n", i, ids_[i].generation, ids_[i].position);
+	ids_.for_each_occupied([](NodeHandleId id, const InternalNodeKey& key)
+	{
+		printf("    %u\t\t%u\t\t%u\n", id, key.generation, key.position);
+	});
 }
 #endif // NDEBUG
 } // namespace A3D
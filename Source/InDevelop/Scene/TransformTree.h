@@ -24,6 +24,7 @@
 #include "Common/Geometry.h"
 #include "Container/sparse_map.h"
 #include "Container/vector.h"
+#include "Container/virtual_vector.h"
 
 namespace A3D
 {
@@ -177,21 +178,25 @@ private:
 		PositionIndex prev;
 	};
 
+	// Node columns reserve address space for all positions, so that growing generation never moves nodes.
+	template <typename T>
+	using NodeArray = virtual_vector<PositionIndex, T>;
+
 	struct Generation
 	{
-		vector<PositionIndex, GlobalTransform> global_transforms;
-		vector<PositionIndex, Box> bounding_boxes;
-		vector<PositionIndex, Sphere> bounding_spheres;
-		vector<PositionIndex, PositionIndex> first_children;
-		vector<PositionIndex, NodeHandleId> external_handles;
+		NodeArray<GlobalTransform> global_transforms;
+		NodeArray<Box> bounding_boxes;
+		NodeArray<Sphere> bounding_spheres;
+		NodeArray<PositionIndex> first_children;
+		NodeArray<NodeHandleId> external_handles;
 		PositionIndex first_garbage;
 	};
 
 	struct GenerationInherited
 	{
-		vector<PositionIndex, LocalTransform> local_transforms;
-		vector<PositionIndex, PositionIndex> parents;
-		vector<PositionIndex, Siblings> siblings;
+		NodeArray<LocalTransform> local_transforms;
+		NodeArray<PositionIndex> parents;
+		NodeArray<Siblings> siblings;
 	};
 
 	void RemoveRootNode(Generation& generation, InternalNodeKey key);
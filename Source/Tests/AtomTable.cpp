@@ -0,0 +1,178 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Container/atom_table.h"
+#include "DebugAllocator.inl"
+
+using debug_atom_table = A3D::basic_atom_table<DebugAllocator<uint8_t>>;
+
+static constexpr const char TEST_STRING[] = "Data/Materials/stone.mat";
+static constexpr const char TEST_STRING_OTHER[] = "Data/Materials/wood.mat";
+
+TEST_SUITE("Atom Table")
+{
+	TEST_CASE("Default atom")
+	{
+		const A3D::atom name;
+		REQUIRE(!name.is_valid());
+		REQUIRE(name.id() == A3D::atom::INVALID_ID);
+	}
+
+	TEST_CASE("Intern")
+	{{
+		debug_atom_table table(16);
+		const A3D::atom name = table.intern(TEST_STRING);
+		REQUIRE(name.is_valid());
+		REQUIRE(table.size() == 1);
+		REQUIRE(!strcmp(table.c_str(name), TEST_STRING));
+		REQUIRE(table.length(name) == strlen(TEST_STRING));
+		REQUIRE(table.hash(name) == A3D::hash_string(TEST_STRING));
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Intern same string")
+	{{
+		debug_atom_table table(16);
+		char buffer[sizeof(TEST_STRING)];
+		strcpy(buffer, TEST_STRING);
+
+		const A3D::atom name = table.intern(TEST_STRING);
+		REQUIRE(table.intern(buffer) == name);
+		REQUIRE(table.size() == 1);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Intern different strings")
+	{{
+		debug_atom_table table(16);
+		const A3D::atom name = table.intern(TEST_STRING);
+		const A3D::atom other = table.intern(TEST_STRING_OTHER);
+		REQUIRE(name != other);
+		REQUIRE(!strcmp(table.c_str(name), TEST_STRING));
+		REQUIRE(!strcmp(table.c_str(other), TEST_STRING_OTHER));
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Find")
+	{{
+		debug_atom_table table(16);
+		REQUIRE(!table.find(TEST_STRING).is_valid());
+
+		const A3D::atom name = table.intern(TEST_STRING);
+		REQUIRE(table.find(TEST_STRING) == name);
+		REQUIRE(!table.find(TEST_STRING_OTHER).is_valid());
+		REQUIRE(table.size() == 1);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Prefix is different string")
+	{{
+		debug_atom_table table(16);
+		const A3D::atom name = table.intern(TEST_STRING, 4);
+		REQUIRE(table.intern(TEST_STRING) != name);
+		REQUIRE(table.find(TEST_STRING, 4) == name);
+		REQUIRE(!strcmp(table.c_str(name), "Data"));
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Grow table")
+	{{
+		debug_atom_table table(4);
+		A3D::atom names[100];
+		char buffer[16];
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "name_%u", i);
+			names[i] = table.intern(buffer);
+			REQUIRE(names[i].is_valid());
+			REQUIRE(names[i].id() < table.max_id());
+		}
+		REQUIRE(table.size() == 100);
+		REQUIRE(table.capacity() >= 100);
+
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "name_%u", i);
+			REQUIRE(table.intern(buffer) == names[i]);
+			REQUIRE(table.find(buffer) == names[i]);
+			REQUIRE(!strcmp(table.c_str(names[i]), buffer));
+			for (unsigned j = 0; j < i; ++j)
+				REQUIRE(names[i] != names[j]);
+		}
+		REQUIRE(table.size() == 100);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Invalid atom string")
+	{{
+		debug_atom_table table(4);
+		table.intern("Data");
+		REQUIRE(!strcmp(table.c_str(A3D::atom()), ""));
+		REQUIRE(!strcmp(table.c_str(A3D::atom(table.max_id() + 1000)), ""));
+		REQUIRE(table.length(A3D::atom()) == 0);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Concurrent intern")
+	{
+		constexpr unsigned THREADS = 8;
+		constexpr unsigned NAMES = 4096;
+
+		// Table starts small, so that threads also race for appending segments.
+		A3D::atom_table table(16);
+		std::vector<A3D::atom> results[THREADS];
+		std::vector<std::thread> threads;
+		std::atomic<bool> start = false;
+		for (unsigned t = 0; t < THREADS; ++t)
+			threads.emplace_back([&, t]()
+			{
+				char buffer[32];
+				results[t].resize(NAMES);
+				while (!start.load())
+					;
+				// Threads walk names in different order, so that they race for the same slots.
+				for (unsigned i = 0; i < NAMES; ++i)
+				{
+					const unsigned index = (i * (t * 2 + 1)) % NAMES;
+					snprintf(buffer, sizeof(buffer), "u_name_%u", index);
+					results[t][index] = table.intern(buffer);
+				}
+			});
+		start = true;
+		for (std::thread& thread : threads)
+			thread.join();
+
+		char buffer[32];
+		for (unsigned i = 0; i < NAMES; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "u_name_%u", i);
+			const A3D::atom name = results[0][i];
+			REQUIRE(name.is_valid());
+			REQUIRE(!strcmp(table.c_str(name), buffer));
+			REQUIRE(table.find(buffer) == name);
+			for (unsigned t = 1; t < THREADS; ++t)
+				REQUIRE(results[t][i] == name);
+		}
+	}
+}
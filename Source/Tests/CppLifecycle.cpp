@@ -237,4 +237,82 @@ TEST_SUITE("Database Table")
 		REQUIRE(s_copy_assigners == 0);
 		REQUIRE(s_move_assigners == ARRAY_SIZE);
 	}
+
+	TEST_CASE("Trivially relocatable trait")
+	{
+		struct relocatable_test { int* ptr; };
+		static_assert(A3D::is_trivially_relocatable_v<int>);
+		static_assert(A3D::is_trivially_relocatable_v<relocatable_test>);
+		static_assert(!A3D::is_trivially_relocatable_v<test>);
+	}
+
+	TEST_CASE("Relocate range")
+	{
+		clean();
+		uint8_t mem1[sizeof(test) * ARRAY_SIZE];
+		uint8_t mem2[sizeof(test) * ARRAY_SIZE];
+		test* p1 = reinterpret_cast<test*>(mem1);
+		test* p2 = reinterpret_cast<test*>(mem2);
+		A3D::relocate_n(p1, p2, ARRAY_SIZE);
+		REQUIRE(s_default_constructors == 0);
+		REQUIRE(s_destructors == ARRAY_SIZE);
+		REQUIRE(s_copy_constructors == 0);
+		REQUIRE(s_move_constructors == ARRAY_SIZE);
+		REQUIRE(s_copy_assigners == 0);
+		REQUIRE(s_move_assigners == 0);
+	}
+
+	TEST_CASE("Default constructor range trivial")
+	{
+		int values[ARRAY_SIZE];
+		memset(values, 0xff, sizeof(values));
+		A3D::construct_n(values, ARRAY_SIZE);
+		for (int value : values)
+			REQUIRE(value == 0);
+	}
+
+	TEST_CASE("Constructor range with value")
+	{
+		int values[ARRAY_SIZE];
+		A3D::construct_n(values, ARRAY_SIZE, 7);
+		for (int value : values)
+			REQUIRE(value == 7);
+	}
+
+	TEST_CASE("Copy constructor range trivially copyable")
+	{
+		// User constructors do not prevent bulk copy.
+		struct vec3
+		{
+			vec3() = default;
+			vec3(float v) : x(v), y(v), z(v) {}
+			float x, y, z;
+		};
+		static_assert(std::is_trivially_copyable_v<vec3>);
+
+		vec3 src[ARRAY_SIZE];
+		for (unsigned i = 0; i < ARRAY_SIZE; ++i)
+			src[i] = vec3(static_cast<float>(i));
+
+		uint8_t mem[sizeof(vec3) * ARRAY_SIZE];
+		vec3* dst = reinterpret_cast<vec3*>(mem);
+		A3D::copy_construct_n(dst, src, ARRAY_SIZE);
+		for (unsigned i = 0; i < ARRAY_SIZE; ++i)
+			REQUIRE(dst[i].z == static_cast<float>(i));
+
+		A3D::move_construct_n(dst, src + 1, src + ARRAY_SIZE);
+		REQUIRE(dst[0].x == 1.0f);
+		REQUIRE(dst[ARRAY_SIZE - 2].x == static_cast<float>(ARRAY_SIZE - 1));
+	}
+
+	TEST_CASE("Move assigner range overlapping")
+	{
+		int values[ARRAY_SIZE];
+		for (int i = 0; i < ARRAY_SIZE; ++i)
+			values[i] = i;
+
+		A3D::move_assign_n(values, values + 1, ARRAY_SIZE - 1);
+		for (int i = 0; i < ARRAY_SIZE - 1; ++i)
+			REQUIRE(values[i] == i + 1);
+	}
 }
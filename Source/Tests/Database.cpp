@@ -21,8 +21,53 @@
 #include <doctest/doctest.h>
 #include "Container/meta/database.h"
 #include "Container/meta/database_builder.h"
+#include "Core/WorkerPool.h"
 #include "DebugAllocator.inl"
 
+struct position {};
+struct name {};
+struct network_id {};
+struct material {};
+struct distance {};
+
+// Owns heap memory, so that rows are relocated by move constructors.
+struct counted
+{
+	counted() : value(new int(0)) {}
+	counted(counted&& other) noexcept : value(other.value) { other.value = nullptr; }
+	~counted() { delete value; }
+	void operator=(counted&& other) noexcept
+	{
+		delete value;
+		value = other.value;
+		other.value = nullptr;
+	}
+
+	int* value;
+};
+
+// Fails allocations of Failing type only, so that the rest of database keeps working.
+template <typename T, typename Failing>
+struct failing_allocator
+{
+	using value_type = T;
+
+	failing_allocator() = default;
+	template <typename U> failing_allocator(const failing_allocator<U, Failing>&) {}
+
+	T* allocate(size_t size)
+	{
+		if constexpr (std::is_same_v<T, Failing>)
+			return nullptr;
+		else
+			return static_cast<T*>(malloc(size * sizeof(T)));
+	}
+
+	void deallocate(T* ptr, size_t) { free(ptr); }
+
+	bool operator==(const failing_allocator&) const noexcept { return true; }
+};
+
 TEST_SUITE("Database Table")
 {
 	TEST_CASE("Idle empty columns")
@@ -36,4 +81,354 @@ TEST_SUITE("Database Table")
 		>::build;
 		db_t db;
 	}
+
+	TEST_CASE("Insert and grow")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>::data<position, float>::data<name, counted>::build;
+			db_t db;
+			REQUIRE(db.empty());
+			REQUIRE(db_t::data_table::memory_size(db_t::chunk_rows) <= db_t::chunk_bytes);
+
+			constexpr uint32_t COUNT = db_t::chunk_rows * 3 + 1;
+			const float* first = nullptr;
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				auto [key, it] = db.insert();
+				REQUIRE(key == i);
+				it.get<position>() = static_cast<float>(i);
+				*it.get<name>().value = static_cast<int>(i);
+				if (i == 0)
+					first = &it.get<position>();
+			}
+			REQUIRE(db.size() == COUNT);
+			REQUIRE(db.chunks_count() == 4);
+			REQUIRE(db.capacity() == db_t::chunk_rows * 4);
+			REQUIRE(db.chunk_size(0) == db_t::chunk_rows);
+			REQUIRE(db.chunk_size(3) == 1);
+
+			// Columns of every chunk start at cache line.
+			for (uint32_t chunk = 0; chunk < db.chunks_count(); ++chunk)
+			{
+				REQUIRE(db.column<position>(chunk).size() == db.chunk_size(chunk));
+				REQUIRE(reinterpret_cast<uintptr_t>(db.column<position>(chunk).data()) % A3D::db::column_alignment == 0);
+				REQUIRE(reinterpret_cast<uintptr_t>(db.column<name>(chunk).data()) % A3D::db::column_alignment == 0);
+			}
+			REQUIRE(db.column<position>(1)[0] == static_cast<float>(db_t::chunk_rows));
+
+			// Growth never moves existing rows.
+			REQUIRE(&db.front<position>() == first);
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				REQUIRE(db.at<position>(i) == static_cast<float>(i));
+				REQUIRE(*db.at<name>(i).value == static_cast<int>(i));
+				REQUIRE(db.at<A3D::db::primary_key>(i) == i);
+			}
+			REQUIRE(db.front<position>() == 0.0f);
+			REQUIRE(db.back<position>() == static_cast<float>(COUNT - 1));
+
+			uint32_t count = 0;
+			for (uint32_t chunk = 0; chunk < db.chunks_count(); ++chunk)
+				for (auto it = db.begin<position>(chunk); it != db.end<position>(chunk); ++it)
+					REQUIRE(it.get<position>() == static_cast<float>(count++));
+			REQUIRE(count == COUNT);
+
+			count = 0;
+			db.for_each<position, name>([&count](float& pos, counted& n)
+			{
+				REQUIRE(pos == static_cast<float>(count));
+				REQUIRE(*n.value == static_cast<int>(count));
+				++count;
+			});
+			REQUIRE(count == COUNT);
+
+			// Emptied chunk goes into the pool and is reused by the next insert.
+			db.erase(COUNT - 1);
+			REQUIRE(db.chunks_count() == 3);
+			REQUIRE(db.capacity() == db_t::chunk_rows * 4);
+			const size_t memory_size = db.memory_size();
+			db.insert();
+			REQUIRE(db.chunks_count() == 4);
+			REQUIRE(db.memory_size() == memory_size);
+			db.erase(COUNT - 1);
+
+			REQUIRE(db.shrink_to_fit());
+			REQUIRE(db.capacity() == db_t::chunk_rows * 3);
+			REQUIRE(*db.back<name>().value == static_cast<int>(COUNT - 2));
+
+			db.clear();
+			REQUIRE(db.empty());
+			REQUIRE(db.chunks_count() == 0);
+			REQUIRE(db.capacity() == db_t::chunk_rows * 3);
+			REQUIRE(db.shrink_to_fit());
+			REQUIRE(db.capacity() == 0);
+
+			REQUIRE(db.reserve(db_t::chunk_rows + 1));
+			REQUIRE(db.capacity() == db_t::chunk_rows * 2);
+			REQUIRE(db.chunks_count() == 0);
+		}
+	}
+
+	TEST_CASE("Erase across chunks")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>::data<position, float>::data<name, counted>::build;
+			db_t db;
+
+			constexpr uint32_t COUNT = db_t::chunk_rows * 2 + 10;
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				auto [key, it] = db.insert();
+				it.get<position>() = static_cast<float>(key);
+				*it.get<name>().value = static_cast<int>(key);
+			}
+
+			// Last row of the last chunk fills hole in the first one.
+			db.erase(5);
+			REQUIRE(db.get_row(COUNT - 1) == 5);
+			REQUIRE(db.at<position>(COUNT - 1) == static_cast<float>(COUNT - 1));
+
+			// Erase of whole tail chunk returns it into the pool.
+			for (uint32_t key = db_t::chunk_rows * 2; key < COUNT - 1; ++key)
+				db.erase(key);
+			REQUIRE(db.size() == db_t::chunk_rows * 2);
+			REQUIRE(db.chunks_count() == 2);
+
+			for (uint32_t key = 0; key < db_t::chunk_rows * 2; ++key)
+				if (key != 5)
+				{
+					REQUIRE(db.contains(key));
+					REQUIRE(db.at<position>(key) == static_cast<float>(key));
+					REQUIRE(*db.at<name>(key).value == static_cast<int>(key));
+					REQUIRE(db.at<A3D::db::primary_key>(key) == key);
+				}
+			REQUIRE(*db.at<name>(COUNT - 1).value == static_cast<int>(COUNT - 1));
+
+			// Freed keys are taken from the lowest one.
+			auto [key, it] = db.insert();
+			REQUIRE(key == 5);
+		}
+	}
+
+	TEST_CASE("Erase")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>::data<position, float>::data<name, counted>::build;
+			db_t db;
+
+			constexpr uint32_t COUNT = 100;
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				auto [key, it] = db.insert();
+				it.get<position>() = static_cast<float>(key);
+				*it.get<name>().value = static_cast<int>(key);
+			}
+
+			// Last row is moved into the hole, keys of other rows stay valid.
+			db.erase(10);
+			REQUIRE(db.size() == COUNT - 1);
+			REQUIRE(!db.contains(10));
+			REQUIRE(db.get_row(COUNT - 1) == 10);
+			for (uint32_t key = 0; key < COUNT; ++key)
+				if (key != 10)
+				{
+					REQUIRE(db.contains(key));
+					REQUIRE(db.at<position>(key) == static_cast<float>(key));
+					REQUIRE(*db.at<name>(key).value == static_cast<int>(key));
+				}
+
+			db.erase(COUNT - 1);
+			REQUIRE(db.size() == COUNT - 2);
+
+			// Released keys are reused.
+			auto [key, it] = db.insert();
+			REQUIRE(key == 10);
+			REQUIRE(db.get_row(10) == COUNT - 2);
+		}
+	}
+
+	TEST_CASE("Erase batch")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>::data<position, float>::data<name, counted>::build;
+			db_t db;
+
+			constexpr uint32_t COUNT = 100;
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				auto [key, it] = db.insert();
+				it.get<position>() = static_cast<float>(key);
+				*it.get<name>().value = static_cast<int>(key);
+			}
+
+			// Erased rows both in the middle and in the tail.
+			uint32_t keys[] = { 98, 3, 50, 99, 0, 97, 20 };
+			constexpr uint32_t ERASED = sizeof(keys) / sizeof(keys[0]);
+			bool erased[COUNT] = {};
+			for (uint32_t key : keys)
+				erased[key] = true;
+
+			db.erase_batch(keys, ERASED);
+			REQUIRE(db.size() == COUNT - ERASED);
+
+			for (uint32_t key = 0; key < COUNT; ++key)
+			{
+				REQUIRE(db.contains(key) == !erased[key]);
+				if (!erased[key])
+				{
+					REQUIRE(db.get_row(key) < db.size());
+					REQUIRE(db.at<position>(key) == static_cast<float>(key));
+					REQUIRE(*db.at<name>(key).value == static_cast<int>(key));
+					REQUIRE(db.at<A3D::db::primary_key>(key) == key);
+				}
+			}
+
+			db.clear();
+			REQUIRE(db.empty());
+			REQUIRE(!db.contains(1));
+		}
+	}
+
+	TEST_CASE("Secondary indices")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>
+				::data<position, float>
+				::secondary_key<uint32_t, network_id, A3D::db::hashed_unique>
+				::secondary_key<uint32_t, material, A3D::db::hashed_multi>
+				::secondary_key<int, distance, A3D::db::sorted>
+				::build;
+			db_t db;
+
+			constexpr uint32_t COUNT = db_t::chunk_rows + 50;
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				auto [key, it] = db.insert(1000 + i, i % 4, static_cast<int>(COUNT - i));
+				REQUIRE(key == i);
+				REQUIRE(it.get<network_id>() == 1000 + i);
+			}
+
+			// Unique index rejects duplicate value, database stays untouched.
+			REQUIRE(db.insert(1000u, 0u, 0).first == db_t::invalid_key);
+			REQUIRE(db.size() == COUNT);
+
+			REQUIRE(db.find<network_id>(1005) == 5);
+			REQUIRE(db.find<network_id>(999) == db_t::invalid_key);
+			const size_t material_1 = db.equal_range<material>(1).size();
+			REQUIRE(material_1 == (COUNT + 2) / 4);
+			for (uint32_t key : db.equal_range<material>(3))
+				REQUIRE(key % 4 == 3);
+			REQUIRE(db.find<distance>(static_cast<int>(COUNT)) == 0);
+
+			// Range is ordered by value: distances 1..10 belong to the last ten keys in reverse.
+			auto near = db.range<distance>(1, 11);
+			REQUIRE(near.size() == 10);
+			for (uint32_t i = 0; i < near.size(); ++i)
+				REQUIRE(near[i] == COUNT - 1 - i);
+
+			// Erase moves rows, indices keep pointing to keys.
+			db.erase(0);
+			db.erase(1);
+			REQUIRE(db.find<network_id>(1000) == db_t::invalid_key);
+			REQUIRE(db.find<network_id>(1000 + COUNT - 1) == COUNT - 1);
+			REQUIRE(db.equal_range<material>(1).size() == material_1 - 1);
+			REQUIRE(db.range<distance>(static_cast<int>(COUNT - 1), static_cast<int>(COUNT + 1)).empty());
+
+			const size_t material_0 = db.equal_range<material>(0).size();
+			uint32_t keys[] = { 2, 3, 4 };
+			db.erase_batch(keys, 3);
+			REQUIRE(db.equal_range<material>(0).size() == material_0 - 1);
+			REQUIRE(db.find<distance>(static_cast<int>(COUNT - 3)) == db_t::invalid_key);
+
+			// Update moves key inside index, unique conflict keeps old value.
+			const size_t material_2 = db.equal_range<material>(2).size();
+			REQUIRE(db.update<material>(10, 7u));
+			REQUIRE(db.at<material>(10) == 7);
+			REQUIRE(db.equal_range<material>(7).size() == 1);
+			REQUIRE(db.equal_range<material>(2).size() == material_2 - 1);
+			REQUIRE(!db.update<network_id>(10, 1011u));
+			REQUIRE(db.at<network_id>(10) == 1010);
+			REQUIRE(db.find<network_id>(1011) == 11);
+			REQUIRE(db.update<network_id>(10, 5000u));
+			REQUIRE(db.find<network_id>(5000) == 10);
+			REQUIRE(db.find<network_id>(1010) == db_t::invalid_key);
+			REQUIRE(db.update<distance>(10, -1));
+			REQUIRE(db.range<distance>(-10, 0).size() == 1);
+			REQUIRE(db.update<position>(10, 2.0f));
+
+			db.clear();
+			REQUIRE(db.find<network_id>(5000) == db_t::invalid_key);
+			REQUIRE(db.equal_range<material>(7).empty());
+			REQUIRE(db.insert(1000u, 0u, 0).first == 0);
+		}
+	}
+
+	TEST_CASE("Parallel for each")
+	{
+		{
+			using db_t = A3D::db::database_builder<uint32_t>::data<position, float>::data<name, counted>::build;
+			db_t db;
+			A3D::WorkerPool pool(3);
+
+			db.parallel_for_each<position>(pool, [](float& pos) { pos = -1.0f; });
+
+			constexpr uint32_t COUNT = db_t::chunk_rows * 5 + 7;
+			for (uint32_t i = 0; i < COUNT; ++i)
+				db.insert().second.get<position>() = 0.1f * static_cast<float>(i);
+
+			db.parallel_for_each<position, name>(pool, [](float& pos, counted& n)
+			{
+				*n.value = static_cast<int>(pos * 10.0f + 0.5f);
+				pos *= 2.0f;
+			}, 10);
+
+			for (uint32_t i = 0; i < COUNT; ++i)
+			{
+				REQUIRE(*db.at<name>(i).value == static_cast<int>(i));
+				REQUIRE(db.at<position>(i) == 0.2f * static_cast<float>(i));
+			}
+
+			// Sum of floats depends on order of additions only, so that it is the same for any threads count.
+			const auto sum = [](float& partial, const float& pos) { partial += pos; };
+			const auto add = [](float result, float partial) { return result + partial; };
+			A3D::WorkerPool single(1);
+			const float expected = db.parallel_reduce<position>(single, 0.0f, sum, add, 16);
+			for (uint32_t run = 0; run < 20; ++run)
+				REQUIRE(db.parallel_reduce<position>(pool, 0.0f, sum, add, 16) == expected);
+
+			const uint32_t rows = db.parallel_reduce<name>(pool, 0u, [](uint32_t& count, counted&) { ++count; },
+				[](uint32_t result, uint32_t count) { return result + count; });
+			REQUIRE(rows == COUNT);
+		}
+	}
+
+	TEST_CASE("Parallel reduce without partials")
+	{
+		using db_t = A3D::db::database_builder<uint32_t,
+			A3D::meta::types_list_builder<>,
+			A3D::meta::types_list_builder<>,
+			A3D::meta::types_list_builder<>,
+			A3D::meta::types_list_builder<>,
+			A3D::meta::types_list_builder<>,
+			failing_allocator<uint8_t, double>>::data<position, float>::build;
+		db_t db;
+		A3D::WorkerPool pool(3);
+
+		constexpr uint32_t COUNT = db_t::chunk_rows * 2 + 7;
+		for (uint32_t i = 0; i < COUNT; ++i)
+			db.insert().second.get<position>() = 0.1f * static_cast<float>(i);
+
+		// Tasks are folded in the same order as partials would be, so that float sum matches exactly.
+		const auto sum = [](double& partial, const float& pos) { partial += pos; };
+		const auto add = [](double result, double partial) { return result + partial; };
+		double expected = 0.0;
+		for (uint32_t first = 0; first < COUNT; first += 16)
+		{
+			double partial = 0.0;
+			for (uint32_t i = first; i < std::min(first + 16, COUNT); ++i)
+				partial += db.at<position>(i);
+			expected += partial;
+		}
+		REQUIRE(db.parallel_reduce<position>(pool, 0.0, sum, add, 16) == expected);
+	}
 }
@@ -149,4 +149,39 @@ TEST_SUITE("Database Table")
 		table.destroy_n(1);
 		free(mem);
 	}
+
+	TEST_CASE("Aligned padded columns")
+	{
+		static constexpr size_t ITEMS_COUNT = 13;
+		using types_t = A3D::meta::types_list_builder<char, double, float>::type;
+		using table_t = A3D::db::database_table<types_t, uint32_t>;
+		table_t table;
+
+		// Misaligned memory block, columns are aligned inside it anyway.
+		const size_t size = table_t::memory_size(ITEMS_COUNT);
+		uint8_t* block = (uint8_t*)malloc(size + 1);
+		uint8_t* mem = block + 1;
+		uint8_t* mem_end = table.allocate(mem, ITEMS_COUNT);
+		REQUIRE(mem_end <= mem + size);
+
+		auto chars = table.column<char, types_t>(ITEMS_COUNT);
+		auto doubles = table.column<double, types_t>(ITEMS_COUNT);
+		auto floats = table.column<float, types_t>(ITEMS_COUNT);
+		REQUIRE(chars.size() == ITEMS_COUNT);
+		REQUIRE(reinterpret_cast<uintptr_t>(chars.data()) % A3D::db::column_alignment == 0);
+		REQUIRE(reinterpret_cast<uintptr_t>(doubles.data()) % A3D::db::column_alignment == 0);
+		REQUIRE(reinterpret_cast<uintptr_t>(floats.data()) % A3D::db::column_alignment == 0);
+
+		// Every column is padded to whole cache lines, so that the last vector load stays inside the block.
+		REQUIRE(reinterpret_cast<uint8_t*>(doubles.data()) - reinterpret_cast<uint8_t*>(chars.data()) == 64);
+		REQUIRE(reinterpret_cast<uint8_t*>(floats.data()) - reinterpret_cast<uint8_t*>(doubles.data()) == 128);
+		REQUIRE(mem_end - reinterpret_cast<uint8_t*>(floats.data()) == 64);
+
+		table.create_n(ITEMS_COUNT);
+		for (size_t i = 0; i < ITEMS_COUNT; ++i)
+			floats[i] = static_cast<float>(i);
+		REQUIRE(table.at<float, types_t>(ITEMS_COUNT - 1) == static_cast<float>(ITEMS_COUNT - 1));
+		table.destroy_n(ITEMS_COUNT);
+		free(block);
+	}
 }
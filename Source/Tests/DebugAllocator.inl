@@ -53,6 +53,34 @@ struct DebugAllocator : DebugAllocatorBase
 	bool operator==(const DebugAllocator&) const noexcept { return true; }
 };
 
+struct DebugReallocatorBase
+{
+	static size_t s_reallocs;
+};
+
+size_t DebugReallocatorBase::s_reallocs = 0;
+
+template <typename T>
+struct DebugReallocator : DebugAllocator<T>, DebugReallocatorBase
+{
+	DebugReallocator() = default;
+	template <typename U> DebugReallocator(const DebugReallocator<U>&) {}
+
+	T* reallocate(T* ptr, size_t, size_t new_size)
+	{
+		auto it = DebugAllocatorBase::s_allocs.find(ptr);
+		REQUIRE_MESSAGE((it != DebugAllocatorBase::s_allocs.end()) == true, "Memory leaks detected: Reallocate not allocated memory.");
+		REQUIRE_MESSAGE(it->second == 1, "Memory leaks detected: Reallocate already released memory.");
+		--it->second;
+		T* ret = (T*)realloc(ptr, new_size * sizeof(T));
+		DebugAllocatorBase::s_allocs[ret] = 1;
+		++s_reallocs;
+		return ret;
+	}
+
+	bool operator==(const DebugReallocator&) const noexcept { return true; }
+};
+
 void CheckMemoryLeaks()
 {
 	for (auto it = DebugAllocatorBase::s_allocs.begin(); it != DebugAllocatorBase::s_allocs.end();)
@@ -0,0 +1,55 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <string.h>
+#include <doctest/doctest.h>
+#include "Core/DefaultAllocator.h"
+
+TEST_SUITE("Default Allocator")
+{
+	TEST_CASE("Aligned")
+	{
+		A3D::DefaultAllocator alloc;
+		for (size_t align : { 8, 16, 64, 4096 })
+		{
+			void* block = alloc.Allocate(100, align);
+			REQUIRE(block != nullptr);
+			REQUIRE(reinterpret_cast<uintptr_t>(block) % align == 0);
+			alloc.Deallocate(block, 100);
+		}
+	}
+
+	TEST_CASE("Reallocate")
+	{
+		A3D::DefaultAllocator alloc;
+		for (size_t align : { 16, 256 })
+		{
+			uint8_t* block = static_cast<uint8_t*>(alloc.Reallocate(nullptr, 0, 10, align));
+			REQUIRE(block != nullptr);
+			memset(block, 3, 10);
+
+			block = static_cast<uint8_t*>(alloc.Reallocate(block, 10, 100000, align));
+			REQUIRE(block != nullptr);
+			REQUIRE(reinterpret_cast<uintptr_t>(block) % align == 0);
+			REQUIRE(block[9] == 3);
+
+			REQUIRE(alloc.Reallocate(block, 100000, 0, align) == nullptr);
+		}
+	}
+}
@@ -506,3 +506,87 @@ TEST_SUITE("Dense Map (Non-POD)")
 			REQUIRE(dm2[i] == TEST_STRINGS[i]);
 	} CheckMemoryLeaks(); }
 }
+
+TEST_SUITE("Dense Map (batch erase)")
+{
+	using dense_map_large = A3D::dense_map<uint16_t, uint16_t, DebugAllocator<uint16_t>>;
+
+	TEST_CASE("Erase batch")
+	{{
+		dense_map_large dm;
+		for (uint16_t i = 0; i < 100; ++i)
+			dm.insert(i);
+
+		uint16_t keys[] = { 97, 3, 50, 99, 0, 42, 98, 10 };
+		constexpr uint16_t count = sizeof(keys) / sizeof(keys[0]);
+		dense_map_large::remap_entry remap[count];
+		const uint16_t remap_size = dm.erase_batch(keys, count, remap);
+		REQUIRE(dm.size() == 100 - count);
+		REQUIRE(remap_size == 5);
+
+		bool present[100] = {};
+		for (uint16_t value : dm)
+		{
+			REQUIRE(present[value] == false);
+			present[value] = true;
+		}
+		for (uint16_t i = 0; i < 100; ++i)
+			REQUIRE(present[i] == (i != 97 && i != 3 && i != 50 && i != 99 && i != 0 && i != 42 && i != 98 && i != 10));
+
+		for (uint16_t i = 0; i < remap_size; ++i)
+			REQUIRE(dm[remap[i].to] == remap[i].from);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Erase batch tail")
+	{{
+		dense_map_large dm;
+		for (uint16_t i = 0; i < 10; ++i)
+			dm.insert(i);
+
+		uint16_t keys[] = { 9, 7, 8 };
+		dense_map_large::remap_entry remap[3];
+		REQUIRE(dm.erase_batch(keys, 3, remap) == 0);
+		REQUIRE(dm.size() == 7);
+		for (uint16_t i = 0; i < 7; ++i)
+			REQUIRE(dm[i] == i);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Erase batch all")
+	{{
+		dense_map_large dm;
+		for (uint16_t i = 0; i < 10; ++i)
+			dm.insert(i);
+
+		uint16_t keys[] = { 5, 1, 9, 0, 2, 8, 3, 7, 4, 6 };
+		dense_map_large::remap_entry remap[10];
+		REQUIRE(dm.erase_batch(keys, 10, remap) == 0);
+		REQUIRE(dm.empty());
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Apply remap")
+	{{
+		using dense_map_strings = A3D::dense_map<uint16_t, no_pod_type, DebugAllocator<no_pod_type>>;
+		dense_map_large handles;
+		dense_map_strings strings;
+		uint16_t indices[64];
+		for (uint16_t i = 0; i < 64; ++i)
+		{
+			indices[i] = handles.insert(i);
+			strings.insert(TEST_STRINGS[i % 5]);
+		}
+
+		uint16_t keys[] = { 1, 63, 20, 21, 40 };
+		dense_map_large::remap_entry remap[5];
+		const uint16_t remap_size = handles.erase_batch(keys, 5, remap);
+		strings.apply_remap(remap, remap_size, 5);
+		for (uint16_t i = 0; i < remap_size; ++i)
+			indices[handles[remap[i].to]] = remap[i].to;
+
+		REQUIRE(strings.size() == handles.size());
+		for (uint16_t i = 0; i < handles.size(); ++i)
+		{
+			REQUIRE(indices[handles[i]] == i);
+			REQUIRE(strings[i] == TEST_STRINGS[handles[i] % 5]);
+		}
+	} CheckMemoryLeaks(); }
+}
@@ -0,0 +1,294 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <string.h>
+#include <string>
+#include <doctest/doctest.h>
+#include "Container/flat_map.h"
+#include "Container/string_hash.h"
+#include "DebugAllocator.inl"
+
+static constexpr const char* TEST_STRINGS[] = { "Alpha", "Betha", "Gamma", "Delta", "Etha" };
+
+using no_pod_type = std::basic_string<char, std::char_traits<char>, DebugAllocator<char>>;
+using flat_map = A3D::flat_map<uint32_t, uint32_t, std::hash<uint32_t>, std::equal_to<uint32_t>, DebugAllocator<std::pair<uint32_t, uint32_t>>>;
+using flat_map_no_pod = A3D::flat_map<uint32_t, no_pod_type, std::hash<uint32_t>, std::equal_to<uint32_t>, DebugAllocator<std::pair<uint32_t, no_pod_type>>>;
+using flat_map_string = A3D::flat_map<A3D::string, uint32_t, A3D::string_hasher, std::equal_to<>>;
+
+TEST_SUITE("Flat Map")
+{
+	TEST_CASE("Idle")
+	{{
+		flat_map fm;
+		REQUIRE(fm.empty());
+		REQUIRE(fm.size() == 0);
+		REQUIRE(fm.capacity() == 0);
+		REQUIRE(fm.find(1) == fm.end());
+		REQUIRE(fm.begin() == fm.end());
+		REQUIRE(fm.erase(1) == 0);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Emplace")
+	{{
+		flat_map fm;
+		const auto [it, inserted] = fm.emplace(5u, 50u);
+		REQUIRE(inserted);
+		REQUIRE(it->first == 5);
+		REQUIRE(it->second == 50);
+		REQUIRE(fm.size() == 1);
+		REQUIRE(fm.capacity() == flat_map::GROUP_WIDTH);
+		REQUIRE(fm.contains(5));
+		REQUIRE(!fm.contains(6));
+		REQUIRE(fm.find(5)->second == 50);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Emplace existing")
+	{{
+		flat_map fm;
+		fm.emplace(5u, 50u);
+		const auto [it, inserted] = fm.emplace(5u, 60u);
+		REQUIRE(!inserted);
+		REQUIRE(it->second == 50);
+		REQUIRE(fm.size() == 1);
+
+		REQUIRE(fm.insert_or_assign(5u, 60u));
+		REQUIRE(fm.find(5)->second == 60);
+		REQUIRE(fm.size() == 1);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Grow")
+	{{
+		constexpr uint32_t COUNT = 10000;
+
+		flat_map fm;
+		for (uint32_t i = 0; i < COUNT; ++i)
+			REQUIRE(fm.emplace(i, i * 2).second);
+		REQUIRE(fm.size() == COUNT);
+		REQUIRE(fm.size() <= fm.capacity() - fm.capacity() / 8);
+
+		for (uint32_t i = 0; i < COUNT; ++i)
+		{
+			const auto it = fm.find(i);
+			REQUIRE(it != fm.end());
+			REQUIRE(it->second == i * 2);
+		}
+		REQUIRE(fm.find(COUNT) == fm.end());
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Clustered keys")
+	{{
+		// Identity hash of aligned keys has equal low bits.
+		flat_map fm;
+		for (uint32_t i = 0; i < 1000; ++i)
+			fm.emplace(i << 12, i);
+		for (uint32_t i = 0; i < 1000; ++i)
+			REQUIRE(fm.find(i << 12)->second == i);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Erase")
+	{{
+		flat_map fm;
+		for (uint32_t i = 0; i < 100; ++i)
+			fm.emplace(i, i);
+
+		for (uint32_t i = 0; i < 100; i += 2)
+			REQUIRE(fm.erase(i) == 1);
+		REQUIRE(fm.erase(0) == 0);
+		REQUIRE(fm.size() == 50);
+
+		for (uint32_t i = 0; i < 100; ++i)
+			REQUIRE(fm.contains(i) == (i % 2 == 1));
+
+		fm.erase(fm.find(1));
+		REQUIRE(!fm.contains(1));
+		REQUIRE(fm.size() == 49);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Erase and insert keeps capacity")
+	{{
+		flat_map fm;
+		fm.reserve(100);
+		const size_t capacity = fm.capacity();
+
+		// Deleted slots are reused or cleaned up without growth.
+		for (uint32_t i = 0; i < 100000; ++i)
+		{
+			REQUIRE(fm.emplace(i, i).second);
+			if (i >= 50)
+				REQUIRE(fm.erase(i - 50) == 1);
+		}
+		REQUIRE(fm.size() == 50);
+		REQUIRE(fm.capacity() == capacity);
+		for (uint32_t i = 100000 - 50; i < 100000; ++i)
+			REQUIRE(fm.contains(i));
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Reserve")
+	{{
+		flat_map fm;
+		REQUIRE(fm.reserve(1000));
+		const size_t capacity = fm.capacity();
+		for (uint32_t i = 0; i < 1000; ++i)
+			fm.emplace(i, i);
+		REQUIRE(fm.capacity() == capacity);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Iterate")
+	{{
+		flat_map fm;
+		uint32_t expected = 0;
+		for (uint32_t i = 0; i < 1000; ++i)
+		{
+			fm.emplace(i, i);
+			expected += i;
+		}
+
+		uint32_t sum = 0;
+		size_t count = 0;
+		for (const auto& item : fm)
+		{
+			REQUIRE(item.first == item.second);
+			sum += item.second;
+			++count;
+		}
+		REQUIRE(count == 1000);
+		REQUIRE(sum == expected);
+
+		const flat_map& cfm = fm;
+		flat_map::const_iterator it = fm.begin();
+		REQUIRE(it == cfm.begin());
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Clear")
+	{{
+		flat_map fm;
+		for (uint32_t i = 0; i < 100; ++i)
+			fm.emplace(i, i);
+		const size_t capacity = fm.capacity();
+
+		fm.clear();
+		REQUIRE(fm.empty());
+		REQUIRE(fm.capacity() == capacity);
+		REQUIRE(fm.begin() == fm.end());
+		REQUIRE(!fm.contains(1));
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy constructor")
+	{{
+		flat_map fm1;
+		for (uint32_t i = 0; i < 100; ++i)
+			fm1.emplace(i, i + 1);
+
+		flat_map fm2(fm1);
+		REQUIRE(fm2.size() == 100);
+		for (uint32_t i = 0; i < 100; ++i)
+			REQUIRE(fm2.find(i)->second == i + 1);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Move constructor")
+	{{
+		flat_map fm1;
+		for (uint32_t i = 0; i < 100; ++i)
+			fm1.emplace(i, i + 1);
+
+		flat_map fm2(std::move(fm1));
+		REQUIRE(fm1.empty());
+		REQUIRE(fm1.capacity() == 0);
+		REQUIRE(fm2.size() == 100);
+		REQUIRE(fm2.find(99)->second == 100);
+	}
+	CheckMemoryLeaks(); }
+}
+
+TEST_SUITE("Flat Map (non-POD)")
+{
+	TEST_CASE("Emplace and grow")
+	{{
+		flat_map_no_pod fm;
+		for (uint32_t i = 0; i < 1000; ++i)
+			fm.emplace(i, TEST_STRINGS[i % 5]);
+		for (uint32_t i = 0; i < 1000; ++i)
+			REQUIRE(fm.find(i)->second == TEST_STRINGS[i % 5]);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Erase")
+	{{
+		flat_map_no_pod fm;
+		for (uint32_t i = 0; i < 5; ++i)
+			fm.emplace(i, TEST_STRINGS[i]);
+		REQUIRE(fm.erase(2) == 1);
+		REQUIRE(!fm.contains(2));
+		REQUIRE(fm.find(3)->second == TEST_STRINGS[3]);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy and clear")
+	{{
+		flat_map_no_pod fm1;
+		for (uint32_t i = 0; i < 5; ++i)
+			fm1.emplace(i, TEST_STRINGS[i]);
+
+		flat_map_no_pod fm2(fm1);
+		fm1.clear();
+		REQUIRE(fm2.size() == 5);
+		REQUIRE(fm2.find(4)->second == TEST_STRINGS[4]);
+	}
+	CheckMemoryLeaks(); }
+}
+
+TEST_SUITE("Flat Map (heterogeneous lookup)")
+{
+	TEST_CASE("Find by const char")
+	{
+		flat_map_string fm;
+		for (uint32_t i = 0; i < 5; ++i)
+			fm.emplace(A3D::string(TEST_STRINGS[i]), i);
+
+		for (uint32_t i = 0; i < 5; ++i)
+		{
+			char buffer[16];
+			strcpy(buffer, TEST_STRINGS[i]);
+			const auto it = fm.find(static_cast<const char*>(buffer));
+			REQUIRE(it != fm.end());
+			REQUIRE(it->second == i);
+		}
+		REQUIRE(!fm.contains("Omega"));
+		REQUIRE(fm.erase("Gamma") == 1);
+		REQUIRE(!fm.contains("Gamma"));
+	}
+
+	TEST_CASE("Emplace by const char")
+	{
+		flat_map_string fm;
+		REQUIRE(fm.emplace("Alpha", 1u).second);
+		REQUIRE(!fm.emplace("Alpha", 2u).second);
+		REQUIRE(fm.find(A3D::string("Alpha"))->second == 1);
+	}
+}
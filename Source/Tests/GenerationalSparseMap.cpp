@@ -0,0 +1,150 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "Container/generational_sparse_map.h"
+#include "DebugAllocator.inl"
+
+static constexpr uint8_t TEST_NUMBERS[] = { 0x55, 0x33, 0x77, 0xF, 0x66 };
+
+using sparse_map = A3D::generational_sparse_map<uint16_t, uint8_t, 4, uint32_t, DebugAllocator<uint8_t>>;
+
+TEST_SUITE("Generational Sparse Map")
+{
+	TEST_CASE("Idle")
+	{{
+		sparse_map sm;
+		REQUIRE(sm.size() == 0);
+		REQUIRE(sm.contains(0) == false);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Insert 5")
+	{{
+		sparse_map sm;
+		uint16_t keys[5];
+		for (unsigned i = 0; i < 5; ++i)
+			keys[i] = sm.insert(TEST_NUMBERS[i]);
+		REQUIRE(sm.size() == 5);
+		for (unsigned i = 0; i < 5; ++i)
+		{
+			REQUIRE(keys[i] == i);
+			REQUIRE(sm.contains(keys[i]));
+			REQUIRE(sm[keys[i]] == TEST_NUMBERS[i]);
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Stale key")
+	{{
+		sparse_map sm;
+		const uint16_t old_key = sm.insert(TEST_NUMBERS[0]);
+		sm.erase(old_key);
+		REQUIRE(sm.contains(old_key) == false);
+
+		const uint16_t new_key = sm.insert(TEST_NUMBERS[1]);
+		REQUIRE(sparse_map::get_index(new_key) == sparse_map::get_index(old_key));
+		REQUIRE(new_key != old_key);
+		REQUIRE(sm.contains(new_key) == true);
+		REQUIRE(sm.contains(old_key) == false);
+		REQUIRE(sm[new_key] == TEST_NUMBERS[1]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Generation wrap")
+	{{
+		sparse_map sm;
+		uint16_t key = sm.insert(TEST_NUMBERS[0]);
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			sm.erase(key);
+			key = sm.insert(TEST_NUMBERS[0]);
+		}
+		REQUIRE(key == 0);
+		REQUIRE(sm.contains(key));
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Clear")
+	{{
+		sparse_map sm;
+		uint16_t keys[5];
+		for (unsigned i = 0; i < 5; ++i)
+			keys[i] = sm.insert(TEST_NUMBERS[i]);
+		sm.erase(keys[2]);
+
+		sm.clear();
+		REQUIRE(sm.size() == 0);
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(sm.contains(keys[i]) == false);
+
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(sm.contains(sm.insert(TEST_NUMBERS[i])));
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(sm.contains(keys[i]) == false);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit")
+	{{
+		sparse_map sm;
+		uint16_t keys[100];
+		for (unsigned i = 0; i < 100; ++i)
+			keys[i] = sm.insert(TEST_NUMBERS[i % 5]);
+		for (unsigned i = 40; i < 100; ++i)
+			sm.erase(keys[i]);
+		REQUIRE(sm.shrink_to_fit());
+		for (unsigned i = 40; i < 100; ++i)
+			REQUIRE(sm.contains(keys[i]) == false);
+		for (unsigned i = 40; i < 100; ++i)
+			REQUIRE(sm.insert(TEST_NUMBERS[0]) != keys[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Index limit")
+	{{
+		sparse_map sm;
+		REQUIRE(sm.reserve(sparse_map::INDEX_MASK + 1) == false);
+		for (unsigned i = 0; i < sparse_map::INDEX_MASK; ++i)
+			REQUIRE(sm.insert(TEST_NUMBERS[0]) == i);
+		REQUIRE(sm.insert(TEST_NUMBERS[0]) == sparse_map::INVALID_KEY);
+		REQUIRE(sm.size() == sparse_map::INDEX_MASK);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Default layout")
+	{
+		using narrow_map = A3D::generational_sparse_map<uint16_t, uint8_t>;
+		using wide_map = A3D::generational_sparse_map<uint32_t, uint8_t>;
+		REQUIRE(narrow_map::GENERATION_BITS == 4);
+		REQUIRE(narrow_map::MAX_SIZE == 4095);
+		REQUIRE(wide_map::GENERATION_BITS == 8);
+		REQUIRE(wide_map::MAX_SIZE == 0xFFFFFF);
+	}
+
+	TEST_CASE("Wide generation wrap")
+	{{
+		A3D::generational_sparse_map<uint32_t, uint8_t, 8, uint32_t, DebugAllocator<uint8_t>> sm;
+		const uint32_t stale_key = sm.insert(TEST_NUMBERS[0]);
+		uint32_t key = stale_key;
+		for (unsigned i = 0; i < 255; ++i)
+		{
+			sm.erase(key);
+			key = sm.insert(TEST_NUMBERS[0]);
+			REQUIRE(sm.contains(stale_key) == false);
+		}
+		sm.erase(key);
+		key = sm.insert(TEST_NUMBERS[0]);
+		REQUIRE(key == stale_key);
+		REQUIRE(sm.contains(stale_key));
+	} CheckMemoryLeaks(); }
+}
@@ -0,0 +1,130 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "Container/dense_map.h"
+#include "Container/growth_policy.h"
+#include "Container/sparse_map.h"
+#include "Container/vector.h"
+#include "DebugAllocator.inl"
+
+TEST_SUITE("Growth Policy")
+{
+	TEST_CASE("Linear")
+	{
+		using policy = A3D::growth_linear<16>;
+		REQUIRE(policy::grow<uint32_t>(0, 1, 4) == 16);
+		REQUIRE(policy::grow<uint32_t>(16, 17, 4) == 32);
+		REQUIRE(policy::grow<uint32_t>(16, 100, 4) == 100);
+	}
+
+	TEST_CASE("Geometric")
+	{
+		using policy = A3D::growth_geometric<2, 1, 8>;
+		REQUIRE(policy::grow<uint32_t>(0, 1, 4) == 8);
+		REQUIRE(policy::grow<uint32_t>(8, 9, 4) == 16);
+		REQUIRE(policy::grow<uint32_t>(1000, 1001, 4) == 2000);
+		REQUIRE(A3D::growth_x1_5::grow<uint32_t>(1000, 1001, 4) == 1500);
+	}
+
+	TEST_CASE("Paged")
+	{
+		using policy = A3D::growth_paged<4096>;
+		REQUIRE(policy::grow<uint32_t>(0, 1, 4) == 1024);
+		REQUIRE(policy::grow<uint32_t>(1024, 1025, 4) == 2048);
+		REQUIRE(policy::grow<uint32_t>(0, 1, 64) == 64);
+		REQUIRE(policy::grow<uint32_t>(0, 1, 3000) == 1);
+		REQUIRE(policy::grow<uint32_t>(1, 2, 3000) == 2);
+	}
+
+	TEST_CASE("Saturation")
+	{
+		REQUIRE(A3D::growth_x2::grow<uint8_t>(200, 201, 1) == 255);
+		REQUIRE(A3D::growth_linear<64>::grow<uint8_t>(240, 241, 1) == 255);
+		REQUIRE(A3D::growth_paged<4096>::grow<uint16_t>(0xff00, 0xff01, 1) == 0xffff);
+	}
+
+	TEST_CASE("Vector amortized growth")
+	{{
+		A3D::vector<uint32_t, uint32_t, DebugAllocator<uint32_t>, A3D::growth_x2> vec;
+		unsigned reallocations = 0;
+		uint32_t capacity = vec.capacity();
+		for (uint32_t i = 0; i < 50000; ++i)
+		{
+			REQUIRE(vec.push_back(i));
+			if (vec.capacity() != capacity)
+			{
+				capacity = vec.capacity();
+				++reallocations;
+			}
+		}
+		REQUIRE(reallocations < 16);
+		REQUIRE(vec.memory_slack() == (vec.capacity() - vec.size()) * sizeof(uint32_t));
+		for (uint32_t i = 0; i < 50000; ++i)
+			REQUIRE(vec[i] == i);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Vector linear growth")
+	{{
+		A3D::vector<uint8_t, uint8_t, DebugAllocator<uint8_t>, A3D::growth_linear<4>> vec;
+		vec.push_back(1);
+		REQUIRE(vec.capacity() == 4);
+		for (uint8_t i = 0; i < 4; ++i)
+			vec.push_back(i);
+		REQUIRE(vec.capacity() == 8);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Vector full key range")
+	{{
+		A3D::vector<uint8_t, uint8_t, DebugAllocator<uint8_t>> vec;
+		for (unsigned i = 0; i < 255; ++i)
+			REQUIRE(vec.push_back(static_cast<uint8_t>(i)));
+		REQUIRE(vec.capacity() == 255);
+		REQUIRE(vec.push_back(0) == false);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Dense map growth")
+	{{
+		A3D::dense_map<uint16_t, uint16_t, DebugAllocator<uint16_t>, A3D::growth_x2> dm;
+		for (uint16_t i = 0; i < 1000; ++i)
+			REQUIRE(dm.insert(i) == i);
+		REQUIRE(dm.capacity() == 1024);
+		REQUIRE(dm.memory_slack() == 24 * sizeof(uint16_t));
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Sparse map growth")
+	{{
+		A3D::sparse_map<uint16_t, uint16_t, uint32_t, DebugAllocator<uint16_t>, A3D::growth_x2> sm;
+		for (uint16_t i = 0; i < 1000; ++i)
+			REQUIRE(sm.insert(i) == i);
+		REQUIRE(sm.capacity() % 32 == 0);
+		REQUIRE(sm.capacity() >= 1000);
+		REQUIRE(sm.memory_slack() == (sm.capacity() - sm.size()) * sizeof(uint16_t));
+		for (uint16_t i = 0; i < 1000; ++i)
+			REQUIRE(sm[i] == i);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Sparse map full key range")
+	{{
+		A3D::sparse_map<uint8_t, uint8_t, uint32_t, DebugAllocator<uint8_t>> sm;
+		for (unsigned i = 0; i < 224; ++i)
+			REQUIRE(sm.insert(static_cast<uint8_t>(i)) == i);
+		REQUIRE(sm.insert(0) == sm.INVALID_KEY);
+	} CheckMemoryLeaks(); }
+}
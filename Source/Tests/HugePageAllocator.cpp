@@ -0,0 +1,128 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <doctest/doctest.h>
+#include "Core/DefaultAllocator.h"
+#include "Core/HugePageAllocator.h"
+#include "Core/ILog.h"
+
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Parent allocator counting live blocks. Sized deallocation is forwarded to unsized one by default allocator.
+struct CountingAllocator : A3D::DefaultAllocator
+{
+	void* Allocate(size_t size) override
+	{
+		++allocs;
+		return DefaultAllocator::Allocate(size);
+	}
+
+	void* Allocate(size_t size, size_t align) override
+	{
+		++allocs;
+		return DefaultAllocator::Allocate(size, align);
+	}
+
+	void Deallocate(void* ptr) override
+	{
+		--allocs;
+		DefaultAllocator::Deallocate(ptr);
+	}
+
+	int allocs = 0;
+};
+
+// Log counting messages instead of writing them.
+class CountingLog : public A3D::ILog
+{
+public:
+	CountingLog() : ILog(Level::TRACE) {}
+
+	int infos = 0;
+
+protected:
+	void Write(const char*, Level level) override
+	{
+		if (level == Level::INFO)
+			++infos;
+	}
+};
+
+TEST_SUITE("Huge Page Allocator")
+{
+	TEST_CASE("Small blocks")
+	{
+		CountingAllocator parent;
+		A3D::HugePageAllocator alloc(&parent);
+		void* block = alloc.Allocate(100);
+		REQUIRE(block != nullptr);
+		REQUIRE(parent.allocs == 1);
+		alloc.Deallocate(block);
+		REQUIRE(parent.allocs == 0);
+
+		const A3D::HugePageAllocator::Stats stats = alloc.GetStats();
+		REQUIRE(stats.hugetlb_blocks + stats.transparent_blocks + stats.fallback_blocks == 0);
+	}
+
+	// Huge pages may be unavailable, then blocks fall back to parent allocator.
+	TEST_CASE("Huge blocks")
+	{
+		CountingAllocator parent;
+		A3D::HugePageAllocator alloc(&parent);
+		uint8_t* block = static_cast<uint8_t*>(alloc.Allocate(3 * 1024 * 1024));
+		REQUIRE(block != nullptr);
+		memset(block, 1, 3 * 1024 * 1024);
+
+		const A3D::HugePageAllocator::Stats stats = alloc.GetStats();
+		REQUIRE(stats.hugetlb_blocks + stats.transparent_blocks + stats.fallback_blocks == 1);
+		if (stats.fallback_blocks == 0)
+		{
+			REQUIRE(parent.allocs == 0);
+			REQUIRE(reinterpret_cast<uintptr_t>(block) % HUGE_PAGE_SIZE == 0);
+			REQUIRE(stats.mapped_size == 2 * HUGE_PAGE_SIZE);
+		}
+
+		CountingLog log;
+		alloc.Report(&log);
+		REQUIRE(log.infos == 1 + (stats.fallback_blocks == 0));
+
+		block = static_cast<uint8_t*>(alloc.Reallocate(block, 3 * 1024 * 1024, 100, 16));
+		REQUIRE(block != nullptr);
+		REQUIRE(block[99] == 1);
+		REQUIRE(parent.allocs == 1);
+
+		alloc.Deallocate(block, 100);
+		REQUIRE(parent.allocs == 0);
+	}
+
+	TEST_CASE("Threshold")
+	{
+		CountingAllocator parent;
+		A3D::HugePageAllocator alloc(&parent, A3D::HugePageAllocator::DISABLED);
+		void* block = alloc.Allocate(4 * HUGE_PAGE_SIZE);
+		REQUIRE(block != nullptr);
+		REQUIRE(parent.allocs == 1);
+
+		alloc.SetThreshold(A3D::HugePageAllocator::DEFAULT_THRESHOLD);
+		alloc.Deallocate(block);
+		REQUIRE(parent.allocs == 0);
+	}
+}
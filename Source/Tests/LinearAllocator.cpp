@@ -0,0 +1,212 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <doctest/doctest.h>
+#include "Container/vector.h"
+#include "Core/AllocatorAdapter.h"
+#include "Core/LinearAllocator.h"
+
+// Parent allocator counting live blocks.
+struct CountingAllocator : A3D::IAllocator
+{
+	void* Allocate(size_t size) override
+	{
+		++allocs;
+		return malloc(size);
+	}
+
+	void* Allocate(size_t size, size_t align) override
+	{
+		++allocs;
+		return aligned_alloc(align, (size + align - 1) & ~(align - 1));
+	}
+
+	void* Reallocate(void* ptr, size_t, size_t new_size, size_t) override
+	{
+		allocs += (ptr == nullptr) - (new_size == 0);
+		return realloc(ptr, new_size);
+	}
+
+	void Deallocate(void* ptr) override
+	{
+		--allocs;
+		free(ptr);
+	}
+
+	void Deallocate(void* ptr, size_t) override { Deallocate(ptr); }
+
+	int allocs = 0;
+};
+
+TEST_SUITE("Linear Allocator")
+{
+	TEST_CASE("Bump")
+	{
+		CountingAllocator parent;
+		{
+			A3D::LinearAllocator alloc(&parent, 1024);
+			REQUIRE(parent.allocs == 1);
+			REQUIRE(alloc.GetCapacity() == 1024);
+
+			uint8_t* first = static_cast<uint8_t*>(alloc.Allocate(10));
+			uint8_t* second = static_cast<uint8_t*>(alloc.Allocate(10));
+			REQUIRE(first != nullptr);
+			REQUIRE(second == first + A3D::LinearAllocator::ALIGNMENT);
+			REQUIRE(reinterpret_cast<uintptr_t>(second) % A3D::LinearAllocator::ALIGNMENT == 0);
+			REQUIRE(alloc.GetUsed() == 2 * A3D::LinearAllocator::ALIGNMENT);
+			REQUIRE(parent.allocs == 1);
+
+			alloc.Deallocate(first);
+			REQUIRE(alloc.GetUsed() == 2 * A3D::LinearAllocator::ALIGNMENT);
+		}
+		REQUIRE(parent.allocs == 0);
+	}
+
+	TEST_CASE("Reset")
+	{
+		CountingAllocator parent;
+		A3D::LinearAllocator alloc(&parent, 1024);
+		void* first = alloc.Allocate(100);
+		alloc.Allocate(100);
+
+		alloc.Reset();
+		REQUIRE(alloc.GetUsed() == 0);
+		REQUIRE(alloc.Allocate(100) == first);
+	}
+
+	TEST_CASE("Overflow")
+	{
+		CountingAllocator parent;
+		{
+			A3D::LinearAllocator alloc(&parent, 256);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(parent.allocs == 3);
+			REQUIRE(alloc.GetUsed() >= 600);
+
+			// Block is grown to the peak usage, so that the same frame fits into it.
+			alloc.Reset();
+			REQUIRE(parent.allocs == 1);
+			REQUIRE(alloc.GetCapacity() >= 600);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(alloc.Allocate(200) != nullptr);
+			REQUIRE(parent.allocs == 1);
+		}
+		REQUIRE(parent.allocs == 0);
+	}
+
+	TEST_CASE("Aligned")
+	{
+		CountingAllocator parent;
+		{
+			A3D::LinearAllocator alloc(&parent, 1024);
+			REQUIRE(alloc.Allocate(8) != nullptr);
+			void* aligned = alloc.Allocate(100, 256);
+			REQUIRE(aligned != nullptr);
+			REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+
+			void* overflow = alloc.Allocate(2000, 512);
+			REQUIRE(overflow != nullptr);
+			REQUIRE(reinterpret_cast<uintptr_t>(overflow) % 512 == 0);
+			memset(overflow, 0, 2000);
+			REQUIRE(parent.allocs == 2);
+		}
+		REQUIRE(parent.allocs == 0);
+	}
+
+	TEST_CASE("Reallocate last")
+	{
+		CountingAllocator parent;
+		A3D::LinearAllocator alloc(&parent, 2048);
+		alloc.Allocate(16);
+		uint8_t* last = static_cast<uint8_t*>(alloc.Allocate(16));
+		last[15] = 42;
+
+		REQUIRE(alloc.Reallocate(last, 16, 500, A3D::LinearAllocator::ALIGNMENT) == last);
+		REQUIRE(alloc.GetUsed() == A3D::LinearAllocator::ALIGNMENT + 512);
+
+		// Not last allocation is moved.
+		alloc.Allocate(16);
+		uint8_t* moved = static_cast<uint8_t*>(alloc.Reallocate(last, 500, 510, A3D::LinearAllocator::ALIGNMENT));
+		REQUIRE(moved != last);
+		REQUIRE(moved[15] == 42);
+
+		alloc.Deallocate(moved, 510);
+		REQUIRE(alloc.GetUsed() == 2 * A3D::LinearAllocator::ALIGNMENT + 512);
+		REQUIRE(parent.allocs == 1);
+	}
+
+	TEST_CASE("Empty")
+	{
+		CountingAllocator parent;
+		{
+			A3D::LinearAllocator alloc(&parent, 0);
+			REQUIRE(alloc.Allocate(16) != nullptr);
+			alloc.Reset();
+			REQUIRE(alloc.GetCapacity() == 16);
+		}
+		REQUIRE(parent.allocs == 0);
+	}
+
+	TEST_CASE("Allocator adapter")
+	{
+		CountingAllocator parent;
+		A3D::LinearAllocator alloc(&parent, 4096);
+		{
+			A3D::vector<uint32_t, uint32_t, A3D::allocator_adapter<uint32_t>> v{ A3D::allocator_adapter<uint32_t>(&alloc) };
+			for (uint32_t i = 0; i < 100; ++i)
+				REQUIRE(v.push_back(i));
+			REQUIRE(v[99] == 99);
+		}
+		// Vector storage is the last allocation, so that it is grown in place and rolled back.
+		REQUIRE(parent.allocs == 1);
+		REQUIRE(alloc.GetUsed() == 0);
+	}
+}
+
+TEST_SUITE("Frame Arena")
+{
+	TEST_CASE("Double buffering")
+	{
+		CountingAllocator parent;
+		{
+			A3D::FrameArena arena(&parent, 1024);
+
+			uint32_t* value = static_cast<uint32_t*>(arena.GetCurrent()->Allocate(sizeof(uint32_t)));
+			*value = 0xDEADBEEF;
+			REQUIRE(arena.GetUsed() > 0);
+
+			// Previous frame data stays valid.
+			arena.NextFrame();
+			REQUIRE(arena.GetUsed() == 0);
+			uint32_t* other = static_cast<uint32_t*>(arena.GetCurrent()->Allocate(sizeof(uint32_t)));
+			REQUIRE(other != value);
+			REQUIRE(*value == 0xDEADBEEF);
+
+			// Two frames later the memory is reused.
+			arena.NextFrame();
+			REQUIRE(arena.GetCurrent()->Allocate(sizeof(uint32_t)) == value);
+		}
+		REQUIRE(parent.allocs == 0);
+	}
+}
@@ -0,0 +1,182 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <doctest/doctest.h>
+#include "Container/vector.h"
+#include "Core/PoolAllocator.h"
+
+TEST_SUITE("Pool Allocator")
+{
+	TEST_CASE("Size classes")
+	{
+		using A3D::PoolAllocator;
+
+		REQUIRE(PoolAllocator::GetSizeClass(0) == 0);
+		REQUIRE(PoolAllocator::GetSizeClass(1) == 0);
+		REQUIRE(PoolAllocator::GetSizeClass(16) == 0);
+		REQUIRE(PoolAllocator::GetSizeClass(17) == 1);
+		REQUIRE(PoolAllocator::GetSizeClass(128) == 7);
+		REQUIRE(PoolAllocator::GetSizeClass(129) == 8);
+		REQUIRE(PoolAllocator::GetSizeClass(PoolAllocator::MAX_BLOCK_SIZE) == PoolAllocator::SIZE_CLASSES_COUNT - 1);
+		REQUIRE(PoolAllocator::GetClassSize(PoolAllocator::SIZE_CLASSES_COUNT - 1) == PoolAllocator::MAX_BLOCK_SIZE);
+
+		for (size_t size = 1; size <= PoolAllocator::MAX_BLOCK_SIZE; ++size)
+		{
+			const uint8_t size_class = PoolAllocator::GetSizeClass(size);
+			const size_t class_size = PoolAllocator::GetClassSize(size_class);
+			REQUIRE(class_size >= size);
+			REQUIRE(class_size % 16 == 0);
+			REQUIRE(class_size - size < class_size / 4 + 16);
+			if (size_class > 0)
+				REQUIRE(PoolAllocator::GetClassSize(size_class - 1) < size);
+		}
+	}
+
+	TEST_CASE("Reuse")
+	{
+		A3D::PoolAllocator alloc;
+		void* first = alloc.Allocate(24);
+		void* second = alloc.Allocate(24);
+		REQUIRE(first != nullptr);
+		REQUIRE(second != nullptr);
+		REQUIRE(first != second);
+		REQUIRE(reinterpret_cast<uintptr_t>(first) % 16 == 0);
+
+		alloc.Deallocate(first);
+		REQUIRE(alloc.Allocate(20) == first);
+		REQUIRE(alloc.GetSlabsCount() == 1);
+
+		alloc.Deallocate(first);
+		alloc.Deallocate(second);
+	}
+
+	TEST_CASE("Slab release")
+	{
+		A3D::PoolAllocator alloc;
+		const size_t count = 3 * A3D::PoolAllocator::SLAB_SIZE / 64;
+
+		A3D::vector<size_t, void*> blocks;
+		for (size_t i = 0; i < count; ++i)
+		{
+			void* block = alloc.Allocate(64);
+			REQUIRE(block != nullptr);
+			memset(block, static_cast<int>(i), 64);
+			REQUIRE(blocks.push_back(block));
+		}
+		REQUIRE(alloc.GetSlabsCount() >= 3);
+
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(*static_cast<uint8_t*>(blocks[i]) == static_cast<uint8_t>(i));
+
+		for (void* block : blocks)
+			alloc.Deallocate(block);
+		REQUIRE(alloc.GetSlabsCount() == 1);
+	}
+
+	TEST_CASE("Large blocks")
+	{
+		A3D::PoolAllocator alloc;
+		void* block = alloc.Allocate(A3D::PoolAllocator::MAX_BLOCK_SIZE + 1);
+		REQUIRE(block != nullptr);
+		memset(block, 0, A3D::PoolAllocator::MAX_BLOCK_SIZE + 1);
+		REQUIRE(alloc.GetSlabsCount() == 0);
+		alloc.Deallocate(block);
+	}
+
+	TEST_CASE("Aligned")
+	{
+		A3D::PoolAllocator alloc;
+		for (size_t align : { 32, 64, 128, 4096 })
+			for (size_t size : { 1, 40, 100, 1000, 10000 })
+			{
+				void* block = alloc.Allocate(size, align);
+				REQUIRE(block != nullptr);
+				REQUIRE(reinterpret_cast<uintptr_t>(block) % align == 0);
+				memset(block, 0, size);
+				alloc.Deallocate(block, size);
+			}
+	}
+
+	TEST_CASE("Reallocate")
+	{
+		A3D::PoolAllocator alloc;
+		uint8_t* block = static_cast<uint8_t*>(alloc.Reallocate(nullptr, 0, 20, 16));
+		REQUIRE(block != nullptr);
+		memset(block, 7, 20);
+
+		// Grows within size class in place.
+		REQUIRE(alloc.Reallocate(block, 20, 32, 16) == block);
+
+		uint8_t* moved = static_cast<uint8_t*>(alloc.Reallocate(block, 32, 20000, 16));
+		REQUIRE(moved != nullptr);
+		REQUIRE(moved[19] == 7);
+		memset(moved, 8, 20000);
+
+		uint8_t* shrunk = static_cast<uint8_t*>(alloc.Reallocate(moved, 20000, 100, 16));
+		REQUIRE(shrunk != nullptr);
+		REQUIRE(shrunk[99] == 8);
+
+		REQUIRE(alloc.Reallocate(shrunk, 100, 0, 16) == nullptr);
+	}
+
+	TEST_CASE("Thread cache")
+	{
+		A3D::PoolAllocator alloc(true);
+		void* first = alloc.Allocate(32);
+		REQUIRE(first != nullptr);
+		alloc.Deallocate(first);
+		REQUIRE(alloc.Allocate(32) == first);
+		alloc.Deallocate(first);
+
+		alloc.ReleaseThreadCache();
+		REQUIRE(alloc.GetSlabsCount() == 1);
+	}
+
+	TEST_CASE("Multiple threads")
+	{
+		A3D::PoolAllocator alloc(true);
+		constexpr unsigned THREADS = 4;
+		constexpr unsigned BLOCKS = 1000;
+
+		std::thread threads[THREADS];
+		for (unsigned t = 0; t < THREADS; ++t)
+			threads[t] = std::thread(
+				[&alloc, t]
+				{
+					void* blocks[BLOCKS];
+					for (unsigned round = 0; round < 10; ++round)
+					{
+						for (unsigned i = 0; i < BLOCKS; ++i)
+						{
+							const size_t size = 8 + (i * 37 + t) % 1000;
+							blocks[i] = alloc.Allocate(size);
+							memset(blocks[i], static_cast<int>(t), size);
+						}
+						for (unsigned i = 0; i < BLOCKS; ++i)
+							alloc.Deallocate(blocks[i]);
+					}
+					alloc.ReleaseThreadCache();
+				});
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+}
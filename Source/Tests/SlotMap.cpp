@@ -0,0 +1,147 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <string>
+#include <doctest/doctest.h>
+#include "Container/slot_map.h"
+
+static constexpr uint8_t TEST_NUMBERS[] = { 0x55, 0x33, 0x77, 0xF, 0x66 };
+static constexpr const char* TEST_STRINGS[] = { "Alpha", "Betha", "Gamma", "Delta", "Etha" };
+
+using slot_map = A3D::slot_map<uint16_t, uint8_t, std::string>;
+
+TEST_SUITE("Slot Map")
+{
+	TEST_CASE("Idle")
+	{
+		slot_map sm;
+		REQUIRE(sm.empty() == true);
+		REQUIRE(sm.size() == 0);
+		REQUIRE(sm.contains(0) == false);
+	}
+
+	TEST_CASE("Insert 5")
+	{
+		slot_map sm;
+		uint16_t handles[5];
+		for (unsigned i = 0; i < 5; ++i)
+			handles[i] = sm.insert(TEST_NUMBERS[i], TEST_STRINGS[i]);
+		REQUIRE(sm.size() == 5);
+
+		for (unsigned i = 0; i < 5; ++i)
+		{
+			REQUIRE(sm.contains(handles[i]));
+			REQUIRE(sm.get<0>(handles[i]) == TEST_NUMBERS[i]);
+			REQUIRE(sm.get<std::string>(handles[i]) == TEST_STRINGS[i]);
+			REQUIRE(sm.get_handle(sm.get_index(handles[i])) == handles[i]);
+		}
+	}
+
+	TEST_CASE("Erase")
+	{
+		slot_map sm;
+		uint16_t handles[5];
+		for (unsigned i = 0; i < 5; ++i)
+			handles[i] = sm.insert(TEST_NUMBERS[i], TEST_STRINGS[i]);
+
+		sm.erase(handles[1]);
+		sm.erase(handles[3]);
+		REQUIRE(sm.size() == 3);
+		REQUIRE(sm.contains(handles[1]) == false);
+		REQUIRE(sm.contains(handles[3]) == false);
+
+		for (unsigned i = 0; i < 5; i += 2)
+		{
+			REQUIRE(sm.contains(handles[i]));
+			REQUIRE(sm.get<uint8_t>(handles[i]) == TEST_NUMBERS[i]);
+			REQUIRE(sm.get<1>(handles[i]) == TEST_STRINGS[i]);
+			REQUIRE(sm.get_handle(sm.get_index(handles[i])) == handles[i]);
+		}
+	}
+
+	TEST_CASE("Stale handle")
+	{
+		slot_map sm;
+		const uint16_t old_handle = sm.insert(TEST_NUMBERS[0], TEST_STRINGS[0]);
+		sm.erase(old_handle);
+		const uint16_t new_handle = sm.insert(TEST_NUMBERS[1], TEST_STRINGS[1]);
+		REQUIRE(sm.contains(old_handle) == false);
+		REQUIRE(sm.contains(new_handle) == true);
+		REQUIRE(sm.get<std::string>(new_handle) == TEST_STRINGS[1]);
+	}
+
+	TEST_CASE("Columns")
+	{
+		slot_map sm;
+		for (unsigned i = 0; i < 5; ++i)
+			sm.insert(TEST_NUMBERS[i], TEST_STRINGS[i]);
+		sm.erase(sm.get_handle(0));
+
+		REQUIRE(sm.column<0>().size() == 4);
+		REQUIRE(sm.column<std::string>().size() == 4);
+		REQUIRE(sm.handles().size() == 4);
+
+		unsigned sum = 0;
+		for (uint8_t number : sm.column<uint8_t>())
+			sum += number;
+		REQUIRE(sum == TEST_NUMBERS[1] + TEST_NUMBERS[2] + TEST_NUMBERS[3] + TEST_NUMBERS[4]);
+
+		for (uint16_t i = 0; i < sm.size(); ++i)
+			REQUIRE(sm.column<1>()[i] == sm.get<std::string>(sm.get_handle(i)));
+	}
+
+	TEST_CASE("Clear")
+	{
+		slot_map sm;
+		uint16_t handles[5];
+		for (unsigned i = 0; i < 5; ++i)
+			handles[i] = sm.insert(TEST_NUMBERS[i], TEST_STRINGS[i]);
+
+		sm.clear();
+		REQUIRE(sm.empty());
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(sm.contains(handles[i]) == false);
+	}
+
+	TEST_CASE("Generation wrap")
+	{
+		A3D::slot_map<uint32_t, uint8_t> sm;
+		const uint32_t stale_handle = sm.insert(TEST_NUMBERS[0]);
+		uint32_t handle = stale_handle;
+		for (unsigned i = 0; i < 255; ++i)
+		{
+			sm.erase(handle);
+			handle = sm.insert(TEST_NUMBERS[0]);
+			REQUIRE(sm.contains(stale_handle) == false);
+		}
+		sm.erase(handle);
+		REQUIRE(sm.insert(TEST_NUMBERS[0]) == stale_handle);
+	}
+
+	TEST_CASE("Capacity limit")
+	{
+		A3D::slot_map<uint16_t, uint8_t> sm;
+		REQUIRE(decltype(sm)::MAX_SIZE == 4095);
+		for (unsigned i = 0; i < decltype(sm)::MAX_SIZE; ++i)
+			REQUIRE(sm.insert(TEST_NUMBERS[i % 5]) != decltype(sm)::INVALID_HANDLE);
+		REQUIRE(sm.insert(TEST_NUMBERS[0]) == decltype(sm)::INVALID_HANDLE);
+		REQUIRE(sm.size() == decltype(sm)::MAX_SIZE);
+		REQUIRE(A3D::slot_map<uint32_t, uint8_t>::MAX_SIZE == 0xFFFFFF);
+	}
+}
@@ -0,0 +1,394 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <string>
+#include <doctest/doctest.h>
+#include "Container/small_vector.h"
+#include "DebugAllocator.inl"
+
+static constexpr uint8_t TEST_NUMBERS[] = { 0x55, 0x33, 0x77, 0xF, 0x66 };
+static constexpr const char* TEST_STRINGS[] = { "Alpha", "Betha", "Gamma", "Delta", "Etha" };
+
+using no_pod_type = std::basic_string<char, std::char_traits<char>, DebugAllocator<char>>;
+using small_vector = A3D::small_vector<uint8_t, no_pod_type, 3, DebugAllocator<no_pod_type>>;
+using small_vector_pod = A3D::small_vector<uint8_t, uint8_t, 3, DebugAllocator<uint8_t>>;
+
+TEST_SUITE("Small Vector (POD)")
+{
+	TEST_CASE("Idle")
+	{{
+		small_vector_pod vec;
+		REQUIRE(vec.empty() == true);
+		REQUIRE(vec.size() == 0);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+		REQUIRE(vec.memory_size() == 0);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Push back inline")
+	{{
+		small_vector_pod vec;
+		for (unsigned i = 0; i < 3; ++i)
+			vec.push_back(TEST_NUMBERS[i]);
+		REQUIRE(vec.empty() == false);
+		REQUIRE(vec.size() == 3);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+		REQUIRE(vec.memory_size() == 0);
+
+		for (unsigned i = 0; i < 3; ++i)
+			REQUIRE(vec[i] == TEST_NUMBERS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Push back spill")
+	{{
+		small_vector_pod vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_NUMBERS[i]);
+		REQUIRE(vec.size() == 5);
+		REQUIRE(vec.capacity() >= 5);
+		REQUIRE(vec.is_inline() == false);
+		REQUIRE(vec.memory_size() > 0);
+		REQUIRE(vec.back() == TEST_NUMBERS[4]);
+
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(vec[i] == TEST_NUMBERS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Pop back")
+	{{
+		small_vector_pod vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_NUMBERS[i]);
+
+		for (unsigned i = 5; i > 0; --i)
+		{
+			REQUIRE(vec.back() == TEST_NUMBERS[i - 1]);
+			vec.pop_back();
+			REQUIRE(vec.size() == i - 1);
+		}
+		REQUIRE(vec.empty() == true);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Clear")
+	{{
+		small_vector_pod vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_NUMBERS[i]);
+		REQUIRE(vec.is_inline() == false);
+
+		vec.clear();
+		REQUIRE(vec.empty() == true);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit")
+	{{
+		small_vector_pod vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_NUMBERS[i]);
+
+		vec.pop_back();
+		REQUIRE(vec.shrink_to_fit() == true);
+		REQUIRE(vec.size() == 4);
+		REQUIRE(vec.capacity() == 4);
+		REQUIRE(vec.is_inline() == false);
+
+		vec.pop_back();
+		REQUIRE(vec.shrink_to_fit() == true);
+		REQUIRE(vec.size() == 3);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+
+		for (unsigned i = 0; i < 3; ++i)
+			REQUIRE(vec[i] == TEST_NUMBERS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy constructor")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector_pod vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_NUMBERS[i]);
+
+			small_vector_pod vec2(vec1);
+			REQUIRE(vec1.size() == count);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec1.data() != vec2.data());
+			REQUIRE(vec2.is_inline() == (count <= 3));
+
+			for (unsigned i = 0; i < count; ++i)
+			{
+				REQUIRE(vec1[i] == TEST_NUMBERS[i]);
+				REQUIRE(vec2[i] == TEST_NUMBERS[i]);
+			}
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Move constructor")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector_pod vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_NUMBERS[i]);
+
+			small_vector_pod vec2(std::move(vec1));
+			REQUIRE(vec1.empty() == true);
+			REQUIRE(vec1.capacity() == 3);
+			REQUIRE(vec1.is_inline() == true);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec2.is_inline() == (count <= 3));
+
+			for (unsigned i = 0; i < count; ++i)
+				REQUIRE(vec2[i] == TEST_NUMBERS[i]);
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy assignment")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector_pod vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_NUMBERS[i]);
+
+			small_vector_pod vec2;
+			for (unsigned i = 0; i < 5; ++i)
+				vec2.push_back(TEST_NUMBERS[4 - i]);
+
+			vec2 = vec1;
+			REQUIRE(vec1.size() == count);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec1.data() != vec2.data());
+
+			for (unsigned i = 0; i < count; ++i)
+			{
+				REQUIRE(vec1[i] == TEST_NUMBERS[i]);
+				REQUIRE(vec2[i] == TEST_NUMBERS[i]);
+			}
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Move assignment")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector_pod vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_NUMBERS[i]);
+
+			small_vector_pod vec2;
+			for (unsigned i = 0; i < 5; ++i)
+				vec2.push_back(TEST_NUMBERS[4 - i]);
+
+			vec2 = std::move(vec1);
+			REQUIRE(vec1.empty() == true);
+			REQUIRE(vec1.is_inline() == true);
+			REQUIRE(vec2.size() == count);
+
+			for (unsigned i = 0; i < count; ++i)
+				REQUIRE(vec2[i] == TEST_NUMBERS[i]);
+		}
+	} CheckMemoryLeaks(); }
+}
+
+TEST_SUITE("Small Vector (Non-POD)")
+{
+	TEST_CASE("Idle")
+	{{
+		small_vector vec;
+		REQUIRE(vec.empty() == true);
+		REQUIRE(vec.size() == 0);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+		REQUIRE(vec.memory_size() == 0);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Push back inline")
+	{{
+		small_vector vec;
+		for (unsigned i = 0; i < 3; ++i)
+			vec.push_back(TEST_STRINGS[i]);
+		REQUIRE(vec.empty() == false);
+		REQUIRE(vec.size() == 3);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+		REQUIRE(vec.memory_size() == 0);
+
+		for (unsigned i = 0; i < 3; ++i)
+			REQUIRE(vec[i] == TEST_STRINGS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Push back spill")
+	{{
+		small_vector vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_STRINGS[i]);
+		REQUIRE(vec.size() == 5);
+		REQUIRE(vec.capacity() >= 5);
+		REQUIRE(vec.is_inline() == false);
+		REQUIRE(vec.memory_size() > 0);
+		REQUIRE(vec.back() == TEST_STRINGS[4]);
+
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(vec[i] == TEST_STRINGS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Pop back")
+	{{
+		small_vector vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_STRINGS[i]);
+
+		for (unsigned i = 5; i > 0; --i)
+		{
+			REQUIRE(vec.back() == TEST_STRINGS[i - 1]);
+			vec.pop_back();
+			REQUIRE(vec.size() == i - 1);
+		}
+		REQUIRE(vec.empty() == true);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Clear")
+	{{
+		small_vector vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_STRINGS[i]);
+		REQUIRE(vec.is_inline() == false);
+
+		vec.clear();
+		REQUIRE(vec.empty() == true);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit")
+	{{
+		small_vector vec;
+		for (unsigned i = 0; i < 5; ++i)
+			vec.push_back(TEST_STRINGS[i]);
+
+		vec.pop_back();
+		REQUIRE(vec.shrink_to_fit() == true);
+		REQUIRE(vec.size() == 4);
+		REQUIRE(vec.capacity() == 4);
+		REQUIRE(vec.is_inline() == false);
+
+		vec.pop_back();
+		REQUIRE(vec.shrink_to_fit() == true);
+		REQUIRE(vec.size() == 3);
+		REQUIRE(vec.capacity() == 3);
+		REQUIRE(vec.is_inline() == true);
+
+		for (unsigned i = 0; i < 3; ++i)
+			REQUIRE(vec[i] == TEST_STRINGS[i]);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy constructor")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_STRINGS[i]);
+
+			small_vector vec2(vec1);
+			REQUIRE(vec1.size() == count);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec1.data() != vec2.data());
+			REQUIRE(vec2.is_inline() == (count <= 3));
+
+			for (unsigned i = 0; i < count; ++i)
+			{
+				REQUIRE(vec1[i] == TEST_STRINGS[i]);
+				REQUIRE(vec2[i] == TEST_STRINGS[i]);
+			}
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Move constructor")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_STRINGS[i]);
+
+			small_vector vec2(std::move(vec1));
+			REQUIRE(vec1.empty() == true);
+			REQUIRE(vec1.capacity() == 3);
+			REQUIRE(vec1.is_inline() == true);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec2.is_inline() == (count <= 3));
+
+			for (unsigned i = 0; i < count; ++i)
+				REQUIRE(vec2[i] == TEST_STRINGS[i]);
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy assignment")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_STRINGS[i]);
+
+			small_vector vec2;
+			for (unsigned i = 0; i < 5; ++i)
+				vec2.push_back(TEST_STRINGS[4 - i]);
+
+			vec2 = vec1;
+			REQUIRE(vec1.size() == count);
+			REQUIRE(vec2.size() == count);
+			REQUIRE(vec1.data() != vec2.data());
+
+			for (unsigned i = 0; i < count; ++i)
+			{
+				REQUIRE(vec1[i] == TEST_STRINGS[i]);
+				REQUIRE(vec2[i] == TEST_STRINGS[i]);
+			}
+		}
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Move assignment")
+	{{
+		for (unsigned count = 2; count <= 5; count += 3)
+		{
+			small_vector vec1;
+			for (unsigned i = 0; i < count; ++i)
+				vec1.push_back(TEST_STRINGS[i]);
+
+			small_vector vec2;
+			for (unsigned i = 0; i < 5; ++i)
+				vec2.push_back(TEST_STRINGS[4 - i]);
+
+			vec2 = std::move(vec1);
+			REQUIRE(vec1.empty() == true);
+			REQUIRE(vec1.is_inline() == true);
+			REQUIRE(vec2.size() == count);
+
+			for (unsigned i = 0; i < count; ++i)
+				REQUIRE(vec2[i] == TEST_STRINGS[i]);
+		}
+	} CheckMemoryLeaks(); }
+}
@@ -296,3 +296,202 @@ TEST_SUITE("Sparse Map")
 			REQUIRE(sm2[keys[i]] == TEST_NUMBERS[i]);
 	} CheckMemoryLeaks(); }
 }
+
+TEST_SUITE("Sparse Map (relocation)")
+{
+	using sparse_map_realloc = A3D::sparse_map<uint16_t, uint16_t, uint32_t, DebugReallocator<uint16_t>>;
+
+	TEST_CASE("Grow in place")
+	{{
+		sparse_map_realloc sm;
+		DebugReallocatorBase::s_reallocs = 0;
+		for (uint16_t i = 0; i < 1000; ++i)
+			REQUIRE(sm.insert(i) == i);
+		REQUIRE(DebugReallocatorBase::s_reallocs > 0);
+		for (uint16_t i = 0; i < 1000; ++i)
+		{
+			REQUIRE(sm.contains(i));
+			REQUIRE(sm[i] == i);
+		}
+		for (uint16_t i = 1000; i < sm.capacity(); ++i)
+			REQUIRE(!sm.contains(i));
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit")
+	{{
+		sparse_map_realloc sm;
+		for (uint16_t i = 0; i < 100; ++i)
+			sm.insert(i);
+		for (uint16_t i = 40; i < 100; ++i)
+			sm.erase(i);
+		REQUIRE(sm.shrink_to_fit());
+		REQUIRE(sm.capacity() == 64);
+		for (uint16_t i = 0; i < 40; ++i)
+			REQUIRE(sm[i] == i);
+		for (uint16_t i = 40; i < 64; ++i)
+			REQUIRE(!sm.contains(i));
+	} CheckMemoryLeaks(); }
+}
+
+TEST_SUITE("Sparse Map (summary)")
+{
+	using sparse_map_large = A3D::sparse_map<uint32_t, uint32_t, uint32_t, DebugAllocator<uint32_t>>;
+
+	TEST_CASE("Reuse lowest erased")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 10000; ++i)
+			REQUIRE(sm.insert(i) == i);
+
+		sm.erase(7000);
+		sm.erase(130);
+		sm.erase(5000);
+		REQUIRE(sm.insert(1) == 130);
+		REQUIRE(sm.insert(2) == 5000);
+		REQUIRE(sm.insert(3) == 7000);
+		REQUIRE(sm.insert(4) == 10000);
+		REQUIRE(sm[130] == 1);
+		REQUIRE(sm[5000] == 2);
+		REQUIRE(sm[7000] == 3);
+		REQUIRE(sm[10000] == 4);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Reuse across top words")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 300000; ++i)
+			REQUIRE(sm.insert(i) == i);
+
+		// Erase and insert are interleaved, so that free cells sit under different top summary words.
+		sm.erase(290000);
+		sm.erase(5);
+		REQUIRE(sm.insert(1) == 5);
+		sm.erase(140000);
+		REQUIRE(sm.insert(2) == 140000);
+		REQUIRE(sm.insert(3) == 290000);
+		REQUIRE(sm.insert(4) == 300000);
+		REQUIRE(sm[5] == 1);
+		REQUIRE(sm[140000] == 2);
+		REQUIRE(sm[290000] == 3);
+		REQUIRE(sm.size() == 300001);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Refill whole segments")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 4096; ++i)
+			sm.insert(i);
+		for (uint32_t i = 2048; i < 2048 + 96; ++i)
+			sm.erase(i);
+		for (uint32_t i = 2048; i < 2048 + 96; ++i)
+			REQUIRE(sm.insert(i) == i);
+		REQUIRE(sm.size() == 4096);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 5000; ++i)
+			sm.insert(i);
+		for (uint32_t i = 100; i < 5000; ++i)
+			sm.erase(i);
+		sm.erase(10);
+		REQUIRE(sm.shrink_to_fit());
+		REQUIRE(sm.capacity() == 128);
+		REQUIRE(!sm.contains(10));
+		REQUIRE(sm.insert(0) == 10);
+		REQUIRE(sm.insert(0) == 100);
+
+		for (uint32_t i = 0; i < 128; ++i)
+			if (sm.contains(i))
+				sm.erase(i);
+		REQUIRE(sm.shrink_to_fit());
+		REQUIRE(sm.capacity() == 0);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Copy keeps summary")
+	{{
+		sparse_map_large sm1;
+		for (uint32_t i = 0; i < 3000; ++i)
+			sm1.insert(i);
+		sm1.erase(2500);
+
+		sparse_map_large sm2(sm1);
+		REQUIRE(sm2.insert(1) == 2500);
+		REQUIRE(sm2.insert(2) == 3000);
+		REQUIRE(sm1.insert(3) == 2500);
+	} CheckMemoryLeaks(); }
+}
+
+TEST_SUITE("Sparse Map (iteration)")
+{
+	using sparse_map_large = A3D::sparse_map<uint32_t, uint32_t, uint32_t, DebugAllocator<uint32_t>>;
+
+	TEST_CASE("Empty")
+	{{
+		sparse_map_large sm;
+		REQUIRE(sm.begin() == sm.end());
+
+		unsigned count = 0;
+		sm.for_each_occupied([&count](uint32_t, uint32_t&) { ++count; });
+		REQUIRE(count == 0);
+
+		sm.insert(1);
+		sm.erase(0);
+		REQUIRE(sm.begin() == sm.end());
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Iterator")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 10000; ++i)
+			sm.insert(i);
+		for (uint32_t i = 0; i < 10000; ++i)
+			if (i % 7 != 0 && !(i >= 3000 && i < 9000 && i != 5000))
+				sm.erase(i);
+
+		uint32_t expected = 0;
+		unsigned count = 0;
+		for (auto it = sm.begin(); it != sm.end(); ++it)
+		{
+			while (!sm.contains(expected))
+				++expected;
+			REQUIRE(it.key() == expected);
+			REQUIRE(*it == expected);
+			++expected;
+			++count;
+		}
+		REQUIRE(count == sm.size());
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("For each occupied")
+	{{
+		sparse_map_large sm;
+		for (uint32_t i = 0; i < 5000; ++i)
+			sm.insert(i);
+		for (uint32_t i = 0; i < 5000; ++i)
+			if (i % 3 != 0)
+				sm.erase(i);
+
+		uint32_t last = 0;
+		unsigned count = 0;
+		bool ordered = true;
+		const sparse_map_large& csm = sm;
+		csm.for_each_occupied([&](uint32_t key, const uint32_t& value)
+		{
+			ordered = ordered && key % 3 == 0 && value == key && (count == 0 || key > last);
+			last = key;
+			++count;
+		});
+		REQUIRE(ordered);
+		REQUIRE(count == sm.size());
+
+		sm.for_each_occupied([&sm](uint32_t key, uint32_t&)
+		{
+			if (key % 2 == 0)
+				sm.erase(key);
+		});
+		for (const uint32_t& value : sm)
+			REQUIRE(value % 2 == 1);
+	} CheckMemoryLeaks(); }
+}
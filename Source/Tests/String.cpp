@@ -26,6 +26,7 @@ static constexpr const char TEST_STRING[] = "Hello, World!";
 static constexpr const char TEST_STRING_JUNK[] = "One Two Three Four Five";
 static constexpr const char TEST_PART_1[] = "Hello, ";
 static constexpr const char TEST_PART_2[] = "World!";
+static constexpr const char TEST_STRING_LONG[] = "Long string, that does not fit into inline storage";
 
 TEST_SUITE("String View")
 {
@@ -57,7 +58,8 @@ TEST_SUITE("String View")
 		A3D::basic_string<char, DebugAllocator<char>> s1(TEST_STRING);
 		A3D::basic_string<char, DebugAllocator<char>> s2(std::move(s1));
 		REQUIRE(!strcmp(s2.c_str(), TEST_STRING));
-		REQUIRE(s1.c_str() == nullptr);
+		REQUIRE(s1.empty());
+		REQUIRE(!strcmp(s1.c_str(), ""));
 	}
 	CheckMemoryLeaks(); }
 
@@ -85,7 +87,8 @@ TEST_SUITE("String View")
 		A3D::basic_string<char, DebugAllocator<char>> s2;
 		s2 = std::move(s1);
 		REQUIRE(!strcmp(s2.c_str(), TEST_STRING));
-		REQUIRE(s1.c_str() == nullptr);
+		REQUIRE(s1.empty());
+		REQUIRE(!strcmp(s1.c_str(), ""));
 	}
 	CheckMemoryLeaks(); }
 
@@ -114,7 +117,8 @@ TEST_SUITE("String View")
 		A3D::basic_string<char, DebugAllocator<char>> s2(TEST_STRING_JUNK);
 		s2 = std::move(s1);
 		REQUIRE(!strcmp(s2.c_str(), TEST_STRING));
-		REQUIRE(s1.c_str() == nullptr);
+		REQUIRE(s1.empty());
+		REQUIRE(!strcmp(s1.c_str(), ""));
 	}
 	CheckMemoryLeaks(); }
 
@@ -202,20 +206,72 @@ TEST_SUITE("String View")
 
 	TEST_CASE("Copy-on-write")
 	{{
-		A3D::basic_string<char, DebugAllocator<char>> a(TEST_STRING);
+		A3D::basic_string<char, DebugAllocator<char>> a(TEST_STRING_LONG);
+		REQUIRE(a.is_inline() == false);
 		REQUIRE(a.refs() == 1);
 		A3D::basic_string<char, DebugAllocator<char>> b(a);
-		REQUIRE(!strcmp(a.c_str(), TEST_STRING));
-		REQUIRE(!strcmp(b.c_str(), TEST_STRING));
+		REQUIRE(!strcmp(a.c_str(), TEST_STRING_LONG));
+		REQUIRE(!strcmp(b.c_str(), TEST_STRING_LONG));
 		REQUIRE(a.c_str() == b.c_str());
 		REQUIRE(a.refs() == 2);
 		REQUIRE(b.refs() == 2);
 		b = TEST_PART_2;
-		REQUIRE(!strcmp(a.c_str(), TEST_STRING));
+		REQUIRE(!strcmp(a.c_str(), TEST_STRING_LONG));
 		REQUIRE(!strcmp(b.c_str(), TEST_PART_2));
 		REQUIRE(a.c_str() != b.c_str());
 		REQUIRE(a.refs() == 1);
 		REQUIRE(b.refs() == 1);
 	}
 	CheckMemoryLeaks(); }
+
+	TEST_CASE("Small string")
+	{{
+		A3D::basic_string<char, DebugAllocator<char>> a(TEST_STRING);
+		REQUIRE(a.is_inline() == true);
+		REQUIRE(DebugAllocatorBase::s_allocs.empty());
+		A3D::basic_string<char, DebugAllocator<char>> b(a);
+		REQUIRE(!strcmp(a.c_str(), TEST_STRING));
+		REQUIRE(!strcmp(b.c_str(), TEST_STRING));
+		REQUIRE(a.c_str() != b.c_str());
+		REQUIRE(a.refs() == 1);
+		REQUIRE(b.refs() == 1);
+		REQUIRE(DebugAllocatorBase::s_allocs.empty());
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Inline boundary")
+	{{
+		using string = A3D::basic_string<char, DebugAllocator<char>>;
+		char buffer[string::INLINE_CAPACITY + 2];
+		memset(buffer, 'x', sizeof(buffer));
+		buffer[string::INLINE_CAPACITY] = '\0';
+		string a(buffer);
+		REQUIRE(a.is_inline() == true);
+		REQUIRE(a.size() == string::INLINE_CAPACITY);
+
+		a += "y";
+		REQUIRE(a.is_inline() == false);
+		REQUIRE(a.size() == string::INLINE_CAPACITY + 1);
+		REQUIRE(a[string::INLINE_CAPACITY] == 'y');
+
+		string b(a);
+		b = b.c_str() + 1;
+		REQUIRE(b.is_inline() == true);
+		REQUIRE(b.size() == string::INLINE_CAPACITY);
+		REQUIRE(a.refs() == 1);
+	}
+	CheckMemoryLeaks(); }
+
+	TEST_CASE("Compare")
+	{{
+		A3D::basic_string<char, DebugAllocator<char>> a(TEST_STRING);
+		A3D::basic_string<char, DebugAllocator<char>> b(TEST_PART_1);
+		REQUIRE(a == TEST_STRING);
+		REQUIRE(!(a == TEST_PART_1));
+		REQUIRE(!(b == TEST_STRING));
+		REQUIRE(!(a == b));
+		b += TEST_PART_2;
+		REQUIRE(a == b);
+	}
+	CheckMemoryLeaks(); }
 }
@@ -0,0 +1,139 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdio.h>
+#include <string.h>
+#include <bit>
+#include <unordered_set>
+#include <doctest/doctest.h>
+#include "Container/string_hash.h"
+
+static constexpr const char TEST_STRING[] = "Hello, World!";
+static constexpr const char TEST_STRING_LONG[] = "Data/Materials/Long path to material file, that takes several hash rounds.mat";
+
+// Hashing of literals must be evaluable at compile time.
+static_assert(A3D::string_hash(TEST_STRING).hash() == A3D::hash_bytes(TEST_STRING, sizeof(TEST_STRING) - 1));
+static_assert(A3D::string_hash(TEST_STRING) != A3D::string_hash(TEST_STRING_LONG));
+static_assert(A3D::hash_string("") != A3D::hash_string("a"));
+
+TEST_SUITE("String Hash")
+{
+	TEST_CASE("Runtime matches compile time")
+	{
+		constexpr uint64_t short_hash = A3D::hash_string(TEST_STRING);
+		constexpr uint64_t long_hash = A3D::hash_string(TEST_STRING_LONG);
+
+		char buffer[sizeof(TEST_STRING_LONG)];
+		strcpy(buffer, TEST_STRING);
+		REQUIRE(A3D::hash_string(buffer) == short_hash);
+		strcpy(buffer, TEST_STRING_LONG);
+		REQUIRE(A3D::hash_string(buffer) == long_hash);
+	}
+
+	TEST_CASE("String matches const char")
+	{
+		for (size_t length = 0; length < sizeof(TEST_STRING_LONG); ++length)
+		{
+			char buffer[sizeof(TEST_STRING_LONG)];
+			memcpy(buffer, TEST_STRING_LONG, length);
+			buffer[length] = '\0';
+
+			const A3D::string str(buffer);
+			REQUIRE(A3D::string_hash(str) == A3D::string_hash(buffer));
+			REQUIRE(std::hash<A3D::string>{}(str) == std::hash<const char*>{}(buffer));
+		}
+	}
+
+	TEST_CASE("Every length differs")
+	{
+		char buffer[256];
+		memset(buffer, 'a', sizeof(buffer));
+
+		std::unordered_set<uint64_t> hashes;
+		for (size_t length = 0; length <= sizeof(buffer); ++length)
+			REQUIRE(hashes.insert(A3D::hash_bytes(buffer, length)).second);
+	}
+
+	TEST_CASE("No collisions")
+	{
+		constexpr unsigned COUNT = 100000;
+
+		char buffer[64];
+		std::unordered_set<uint64_t> hashes;
+		for (unsigned i = 0; i < COUNT; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "Data/Textures/texture_%u.dds", i);
+			hashes.insert(A3D::hash_string(buffer));
+		}
+		REQUIRE(hashes.size() == COUNT);
+	}
+
+	TEST_CASE("Distribution")
+	{
+		constexpr unsigned COUNT = 65536;
+		constexpr unsigned BUCKETS = 256;
+		constexpr unsigned EXPECTED = COUNT / BUCKETS;
+
+		unsigned low_buckets[BUCKETS] = {};
+		unsigned high_buckets[BUCKETS] = {};
+
+		char buffer[64];
+		for (unsigned i = 0; i < COUNT; ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "u_param%u", i);
+			const uint64_t hash = A3D::hash_string(buffer);
+			++low_buckets[hash % BUCKETS];
+			++high_buckets[hash >> 56];
+		}
+
+		// Chi-squared with 255 degrees of freedom stays far below 400 for uniform hash.
+		double low_chi = 0.0;
+		double high_chi = 0.0;
+		for (unsigned i = 0; i < BUCKETS; ++i)
+		{
+			const double low_delta = double(low_buckets[i]) - EXPECTED;
+			const double high_delta = double(high_buckets[i]) - EXPECTED;
+			low_chi += low_delta * low_delta / EXPECTED;
+			high_chi += high_delta * high_delta / EXPECTED;
+		}
+		REQUIRE(low_chi < 400.0);
+		REQUIRE(high_chi < 400.0);
+	}
+
+	TEST_CASE("Single bit avalanche")
+	{
+		char buffer[] = "Data/Shaders/vs_mesh.bin";
+		const uint64_t hash = A3D::hash_string(buffer);
+
+		unsigned total_changed = 0;
+		unsigned flips = 0;
+		for (size_t i = 0; i < sizeof(buffer) - 1; ++i)
+			for (unsigned bit = 0; bit < 7; ++bit)
+			{
+				buffer[i] ^= static_cast<char>(1 << bit);
+				total_changed += std::popcount(hash ^ A3D::hash_string(buffer));
+				buffer[i] ^= static_cast<char>(1 << bit);
+				++flips;
+			}
+
+		// Half of output bits must change on average.
+		const double average = double(total_changed) / flips;
+		REQUIRE(average > 28.0);
+		REQUIRE(average < 36.0);
+	}
+}
@@ -0,0 +1,275 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <doctest/doctest.h>
+#include "Core/DefaultAllocator.h"
+#include "Core/ThreadCacheAllocator.h"
+
+using A3D::ThreadCacheAllocator;
+
+// Counts blocks taken from default allocator, so that tests see everything is returned.
+struct CountingAllocator : public A3D::DefaultAllocator
+{
+	void* Allocate(size_t size) override
+	{
+		++allocated;
+		return DefaultAllocator::Allocate(size);
+	}
+
+	void* Allocate(size_t size, size_t align) override
+	{
+		++allocated;
+		return DefaultAllocator::Allocate(size, align);
+	}
+
+	void Deallocate(void* ptr) override
+	{
+		--allocated;
+		DefaultAllocator::Deallocate(ptr);
+	}
+
+	std::atomic<int> allocated{ 0 };
+};
+
+TEST_SUITE("Thread Cache Allocator")
+{
+	TEST_CASE("Size classes")
+	{
+		REQUIRE(ThreadCacheAllocator::GetSizeClass(ThreadCacheAllocator::MAX_BLOCK_SIZE) == ThreadCacheAllocator::SIZE_CLASSES_COUNT - 1);
+		REQUIRE(ThreadCacheAllocator::GetClassSize(ThreadCacheAllocator::SIZE_CLASSES_COUNT - 1) == ThreadCacheAllocator::MAX_BLOCK_SIZE);
+	}
+
+	TEST_CASE("Reuse")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			void* first = alloc.Allocate(24);
+			void* second = alloc.Allocate(24);
+			REQUIRE(first != nullptr);
+			REQUIRE(second != nullptr);
+			REQUIRE(first != second);
+			REQUIRE(reinterpret_cast<uintptr_t>(first) % A3D::IAllocator::DEFAULT_ALIGNMENT == 0);
+
+			// Refill takes whole batch at once.
+			REQUIRE(alloc.GetStats().parent_blocks == ThreadCacheAllocator::BATCH_SIZE);
+			REQUIRE(alloc.GetStats().caches_count == 1);
+
+			alloc.Deallocate(first);
+			REQUIRE(alloc.Allocate(20) == first);
+
+			alloc.Deallocate(first);
+			alloc.Deallocate(second);
+			alloc.ReleaseThreadCache();
+			REQUIRE(alloc.GetStats().depot_blocks == ThreadCacheAllocator::BATCH_SIZE);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Batched returns")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			constexpr uint32_t COUNT = ThreadCacheAllocator::BIN_CAPACITY * 4;
+
+			void* blocks[COUNT];
+			for (void*& block : blocks)
+			{
+				block = alloc.Allocate(100);
+				REQUIRE(block != nullptr);
+				memset(block, 1, 100);
+			}
+			REQUIRE(alloc.GetStats().depot_blocks == 0);
+
+			for (void* block : blocks)
+				alloc.Deallocate(block);
+
+			// Bin keeps at most BIN_CAPACITY blocks, the rest went to depot.
+			const ThreadCacheAllocator::Stats stats = alloc.GetStats();
+			REQUIRE(stats.parent_blocks == COUNT);
+			REQUIRE(stats.depot_blocks >= COUNT - ThreadCacheAllocator::BIN_CAPACITY);
+			REQUIRE(stats.depot_blocks < COUNT);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Depot capacity")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			constexpr uint32_t COUNT = ThreadCacheAllocator::DEPOT_CAPACITY * 2;
+
+			static void* blocks[COUNT];
+			for (void*& block : blocks)
+				block = alloc.Allocate(16);
+			for (void* block : blocks)
+				alloc.Deallocate(block);
+			alloc.ReleaseThreadCache();
+
+			const ThreadCacheAllocator::Stats stats = alloc.GetStats();
+			REQUIRE(stats.depot_blocks == ThreadCacheAllocator::DEPOT_CAPACITY);
+			REQUIRE(stats.parent_blocks == ThreadCacheAllocator::DEPOT_CAPACITY);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Large and aligned blocks")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			for (size_t align : { 16, 32, 64, 4096 })
+				for (size_t size : { 1, 40, 1000, 10000 })
+				{
+					void* block = alloc.Allocate(size, align);
+					REQUIRE(block != nullptr);
+					REQUIRE(reinterpret_cast<uintptr_t>(block) % align == 0);
+					memset(block, 0, size);
+					alloc.Deallocate(block, size);
+				}
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Reallocate")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			uint8_t* block = static_cast<uint8_t*>(alloc.Reallocate(nullptr, 0, 20, 16));
+			REQUIRE(block != nullptr);
+			memset(block, 7, 20);
+
+			// Grows within size class in place.
+			REQUIRE(alloc.Reallocate(block, 20, 32, 16) == block);
+
+			uint8_t* moved = static_cast<uint8_t*>(alloc.Reallocate(block, 32, 20000, 16));
+			REQUIRE(moved != nullptr);
+			REQUIRE(moved[19] == 7);
+			memset(moved, 8, 20000);
+
+			uint8_t* grown = static_cast<uint8_t*>(alloc.Reallocate(moved, 20000, 40000, 16));
+			REQUIRE(grown != nullptr);
+			REQUIRE(grown[19999] == 8);
+
+			uint8_t* aligned = static_cast<uint8_t*>(alloc.Reallocate(grown, 40000, 50000, 64));
+			REQUIRE(aligned != nullptr);
+			REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+			REQUIRE(aligned[19999] == 8);
+
+			uint8_t* shrunk = static_cast<uint8_t*>(alloc.Reallocate(aligned, 50000, 100, 16));
+			REQUIRE(shrunk != nullptr);
+			REQUIRE(shrunk[99] == 8);
+
+			REQUIRE(alloc.Reallocate(shrunk, 100, 0, 16) == nullptr);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Cross thread free")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			constexpr unsigned BLOCKS = 1000;
+
+			void* blocks[BLOCKS];
+			for (unsigned i = 0; i < BLOCKS; ++i)
+			{
+				blocks[i] = alloc.Allocate(8 + i % 500);
+				REQUIRE(blocks[i] != nullptr);
+			}
+
+			std::thread consumer(
+				[&alloc, &blocks]
+				{
+					for (void* block : blocks)
+						alloc.Deallocate(block);
+				});
+			consumer.join();
+
+			// Released blocks wait in queue of producer, until it runs out of cached ones.
+			REQUIRE(alloc.GetStats().remote_frees == BLOCKS);
+			const size_t parent_blocks = alloc.GetStats().parent_blocks;
+			for (unsigned i = 0; i < BLOCKS; ++i)
+				blocks[i] = alloc.Allocate(8 + i % 500);
+			REQUIRE(alloc.GetStats().parent_blocks == parent_blocks);
+
+			for (void* block : blocks)
+				alloc.Deallocate(block);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+
+	TEST_CASE("Multiple threads")
+	{
+		CountingAllocator parent;
+		{
+			ThreadCacheAllocator alloc(&parent);
+			constexpr unsigned THREADS = 4;
+			constexpr unsigned BLOCKS = 1000;
+
+			// Every thread releases blocks of its neighbour, so that remote queues are used concurrently.
+			static void* blocks[THREADS][BLOCKS];
+			std::atomic<unsigned> ready = 0;
+
+			std::thread threads[THREADS];
+			for (unsigned t = 0; t < THREADS; ++t)
+				threads[t] = std::thread(
+					[&alloc, &ready, t]
+					{
+						for (unsigned round = 0; round < 10; ++round)
+						{
+							for (unsigned i = 0; i < BLOCKS; ++i)
+							{
+								const size_t size = 8 + (i * 37 + t) % 2000;
+								blocks[t][i] = alloc.Allocate(size);
+								memset(blocks[t][i], static_cast<int>(t), size);
+							}
+
+							ready.fetch_add(1);
+							while (ready.load() < THREADS * (round * 2 + 1))
+								std::this_thread::yield();
+
+							for (unsigned i = 0; i < BLOCKS; ++i)
+								alloc.Deallocate(blocks[(t + 1) % THREADS][i]);
+
+							ready.fetch_add(1);
+							while (ready.load() < THREADS * (round * 2 + 2))
+								std::this_thread::yield();
+						}
+					});
+
+			for (std::thread& thread : threads)
+				thread.join();
+
+			// Caches of finished threads are reused by new ones.
+			REQUIRE(alloc.GetStats().caches_count == THREADS);
+			std::thread([&alloc] { alloc.Deallocate(alloc.Allocate(32)); }).join();
+			REQUIRE(alloc.GetStats().caches_count == THREADS);
+		}
+		REQUIRE(parent.allocated == 0);
+	}
+}
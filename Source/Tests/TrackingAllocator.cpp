@@ -0,0 +1,194 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <doctest/doctest.h>
+#include "Core/DefaultAllocator.h"
+#include "Core/ILog.h"
+#include "Core/TrackingAllocator.h"
+
+// Log counting messages instead of writing them.
+class CountingLog : public A3D::ILog
+{
+public:
+	CountingLog() : ILog(Level::TRACE) {}
+
+	int infos = 0;
+	int errors = 0;
+
+protected:
+	void Write(const char*, Level level) override
+	{
+		if (level == Level::ERROR)
+			++errors;
+		else if (level == Level::INFO)
+			++infos;
+	}
+};
+
+TEST_SUITE("Tracking Allocator")
+{
+	TEST_CASE("Tags")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+		A3D::IAllocator* renderer = tracker.GetAllocator(A3D::MemoryTag::RENDERER);
+
+		void* first = renderer->Allocate(100);
+		void* second = renderer->Allocate(1000);
+		void* general = tracker.Allocate(10);
+		REQUIRE(first != nullptr);
+		REQUIRE(second != nullptr);
+		REQUIRE(general != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(first) % A3D::IAllocator::DEFAULT_ALIGNMENT == 0);
+
+		A3D::TrackingAllocator::TagStats stats = tracker.GetStats(A3D::MemoryTag::RENDERER);
+		REQUIRE(stats.live_bytes == 1100);
+		REQUIRE(stats.live_blocks == 2);
+		REQUIRE(stats.allocations == 2);
+		REQUIRE(stats.size_histogram[3] == 1);
+		REQUIRE(stats.size_histogram[6] == 1);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::GENERAL).live_bytes == 10);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::SCENE).allocations == 0);
+
+		// Block may be released through any allocator.
+		tracker.Deallocate(second);
+		stats = tracker.GetStats(A3D::MemoryTag::RENDERER);
+		REQUIRE(stats.live_bytes == 100);
+		REQUIRE(stats.peak_bytes == 1100);
+		REQUIRE(stats.live_blocks == 1);
+
+		renderer->Deallocate(first, 100);
+		tracker.Deallocate(general);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::RENDERER).live_bytes == 0);
+	}
+
+	TEST_CASE("Aligned")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+		A3D::IAllocator* scene = tracker.GetAllocator(A3D::MemoryTag::SCENE);
+
+		uint8_t* block = static_cast<uint8_t*>(scene->Allocate(100, 256));
+		REQUIRE(block != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(block) % 256 == 0);
+		memset(block, 5, 100);
+
+		block = static_cast<uint8_t*>(scene->Reallocate(block, 100, 5000, 256));
+		REQUIRE(block != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(block) % 256 == 0);
+		REQUIRE(block[99] == 5);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::SCENE).live_bytes == 5000);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::SCENE).live_blocks == 1);
+
+		REQUIRE(scene->Reallocate(block, 5000, 0, 256) == nullptr);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::SCENE).live_blocks == 0);
+		REQUIRE(tracker.GetStats(A3D::MemoryTag::SCENE).peak_bytes == 5000);
+	}
+
+	TEST_CASE("Leak report")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+		CountingLog log;
+
+		void* block = tracker.GetAllocator(A3D::MemoryTag::PLUGINS)->Allocate(64);
+		REQUIRE(!tracker.ReportLeaks(&log));
+		REQUIRE(log.errors == 1);
+
+		tracker.Report(&log);
+		REQUIRE(log.infos > 0);
+
+		tracker.Deallocate(block);
+		REQUIRE(tracker.ReportLeaks(&log));
+		REQUIRE(log.errors == 1);
+	}
+
+	TEST_CASE("Allocations rate")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+
+		tracker.NextFrame();
+		REQUIRE(tracker.GetRateHistogram(0) == 1);
+
+		for (int i = 0; i < 5; ++i)
+			tracker.Deallocate(tracker.Allocate(8));
+		tracker.NextFrame();
+		REQUIRE(tracker.GetRateHistogram(3) == 1);
+	}
+
+	TEST_CASE("Multiple threads")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+		constexpr unsigned THREADS = 4;
+		constexpr unsigned BLOCKS = 1000;
+
+		std::thread threads[THREADS];
+		for (std::thread& thread : threads)
+			thread = std::thread(
+				[&tracker]
+				{
+					A3D::IAllocator* alloc = tracker.GetAllocator(A3D::MemoryTag::RESOURCES);
+					void* blocks[BLOCKS];
+					for (void*& block : blocks)
+						block = alloc->Allocate(32);
+					for (void* block : blocks)
+						alloc->Deallocate(block);
+				});
+		for (std::thread& thread : threads)
+			thread.join();
+
+		const A3D::TrackingAllocator::TagStats stats = tracker.GetStats(A3D::MemoryTag::RESOURCES);
+		REQUIRE(stats.allocations == THREADS * BLOCKS);
+		REQUIRE(stats.live_blocks == 0);
+		REQUIRE(stats.live_bytes == 0);
+		REQUIRE(stats.peak_bytes >= BLOCKS * 32);
+	}
+
+	TEST_CASE("Peak across threads")
+	{
+		A3D::DefaultAllocator parent;
+		A3D::TrackingAllocator tracker(&parent);
+		A3D::IAllocator* alloc = tracker.GetAllocator(A3D::MemoryTag::RESOURCES);
+		constexpr unsigned BLOCKS = 1000;
+
+		// Blocks are loaded by worker and released by main thread every frame, so that peak must not pile up.
+		void* blocks[BLOCKS];
+		for (unsigned frame = 0; frame < 3; ++frame)
+		{
+			std::thread worker([&]
+			{
+				for (void*& block : blocks)
+					block = alloc->Allocate(32);
+			});
+			worker.join();
+			for (void* block : blocks)
+				alloc->Deallocate(block);
+			tracker.NextFrame();
+		}
+
+		const A3D::TrackingAllocator::TagStats stats = tracker.GetStats(A3D::MemoryTag::RESOURCES);
+		REQUIRE(stats.live_bytes == 0);
+		REQUIRE(stats.peak_bytes == BLOCKS * 32);
+	}
+}
+
@@ -146,6 +146,15 @@ TEST_SUITE("Types List")
 		static_assert(A3D::meta::types_list_sizeof<tl_t>::value == sizeof(int) + sizeof(float) + sizeof(char));
 	}
 
+	TEST_CASE("Contains")
+	{
+		using tl_t = A3D::meta::types_list<int, float>;
+		static_assert(A3D::meta::list_contains<int, tl_t>::value);
+		static_assert(A3D::meta::list_contains<float, tl_t>::value);
+		static_assert(!A3D::meta::list_contains<char, tl_t>::value);
+		static_assert(!A3D::meta::list_contains<int, A3D::meta::types_list<>>::value);
+	}
+
 	TEST_CASE("Type by tag size 1")
 	{
 		using tl_t = A3D::meta::types_list<int>;
@@ -452,3 +452,44 @@ TEST_SUITE("Vector (Non-POD)")
 			REQUIRE(vec2[i] == TEST_STRINGS[i]);
 	} CheckMemoryLeaks(); }
 }
+
+TEST_SUITE("Vector (relocation)")
+{
+	TEST_CASE("Reserve in place")
+	{{
+		A3D::vector<uint16_t, uint32_t, DebugReallocator<uint32_t>> vec;
+		DebugReallocator<uint32_t>::s_reallocs = 0;
+		for (uint32_t i = 0; i < 1000; ++i)
+			vec.push_back(i);
+		REQUIRE(DebugReallocator<uint32_t>::s_reallocs > 0);
+		for (uint32_t i = 0; i < 1000; ++i)
+			REQUIRE(vec[i] == i);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Shrink to fit in place")
+	{{
+		A3D::vector<uint16_t, uint32_t, DebugReallocator<uint32_t>> vec;
+		for (uint32_t i = 0; i < 100; ++i)
+			vec.push_back(i);
+		vec.shrink(10);
+		REQUIRE(vec.shrink_to_fit());
+		REQUIRE(vec.capacity() == 10);
+		for (uint32_t i = 0; i < 10; ++i)
+			REQUIRE(vec[i] == i);
+		vec.shrink(0);
+		REQUIRE(vec.shrink_to_fit());
+		REQUIRE(vec.capacity() == 0);
+	} CheckMemoryLeaks(); }
+
+	TEST_CASE("Non-relocatable items")
+	{{
+		vector vec;
+		for (unsigned i = 0; i < 40; ++i)
+			vec.push_back(TEST_STRINGS[i % 5]);
+		vec.shrink(5);
+		REQUIRE(vec.shrink_to_fit());
+		REQUIRE(vec.capacity() == 5);
+		for (unsigned i = 0; i < 5; ++i)
+			REQUIRE(vec[i] == TEST_STRINGS[i]);
+	} CheckMemoryLeaks(); }
+}
@@ -0,0 +1,110 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <string>
+#include <doctest/doctest.h>
+#include "Container/virtual_vector.h"
+#include "DebugAllocator.inl"
+
+using no_pod_type = std::basic_string<char, std::char_traits<char>, DebugAllocator<char>>;
+using vector = A3D::virtual_vector<uint32_t, no_pod_type>;
+using vector_pod = A3D::virtual_vector<uint32_t, uint64_t>;
+
+TEST_SUITE("Virtual Vector")
+{
+	TEST_CASE("Idle")
+	{
+		vector_pod vec;
+		REQUIRE(vec.empty() == true);
+		REQUIRE(vec.capacity() == 0);
+		REQUIRE(vec.data() == nullptr);
+		REQUIRE(vec.memory_size() == 0);
+	}
+
+	TEST_CASE("Stable addresses")
+	{
+		vector_pod vec;
+		REQUIRE(vec.push_back(0));
+		const uint64_t* first = &vec.front();
+
+		for (uint64_t i = 1; i < 1000000; ++i)
+			REQUIRE(vec.push_back(i));
+
+		REQUIRE(&vec.front() == first);
+		REQUIRE(vec.size() == 1000000);
+		REQUIRE(vec[999999] == 999999);
+		REQUIRE(vec.memory_size() % A3D::virtual_memory::page_size() == 0);
+		REQUIRE(vec.memory_size() >= 1000000 * sizeof(uint64_t));
+	}
+
+	TEST_CASE("Max capacity")
+	{
+		vector_pod vec(100);
+		for (uint64_t i = 0; i < 100; ++i)
+			REQUIRE(vec.push_back(i));
+		REQUIRE(vec.capacity() == 100);
+		REQUIRE(vec.push_back(100) == false);
+		REQUIRE(vec.size() == 100);
+	}
+
+	TEST_CASE("Shrink to fit")
+	{
+		vector_pod vec;
+		REQUIRE(vec.reserve(100000));
+		const size_t reserved = vec.memory_size();
+		const uint64_t* data = vec.data();
+		vec.push_back(1);
+
+		REQUIRE(vec.shrink_to_fit());
+		REQUIRE(vec.memory_size() == A3D::virtual_memory::page_size());
+		REQUIRE(vec.memory_size() < reserved);
+		REQUIRE(vec.data() == data);
+		REQUIRE(vec.front() == 1);
+
+		// Decommitted pages are committed back on demand.
+		for (uint64_t i = 0; i < 100000; ++i)
+			REQUIRE(vec.push_back(i));
+		REQUIRE(vec.data() == data);
+
+		vec.clear();
+		REQUIRE(vec.memory_size() == 0);
+		REQUIRE(vec.push_back(2));
+		REQUIRE(vec.data() == data);
+	}
+
+	TEST_CASE("Non-POD items")
+	{{
+		vector vec;
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(vec.emplace_back(std::to_string(i).c_str()));
+
+		vector copy(vec);
+		REQUIRE(copy.size() == 100);
+		REQUIRE(copy[42] == "42");
+		REQUIRE(copy.data() != vec.data());
+
+		vector moved(std::move(vec));
+		REQUIRE(vec.data() == nullptr);
+		REQUIRE(moved[99] == "99");
+
+		moved.pop_back();
+		REQUIRE(moved.size() == 99);
+		copy.clear();
+	} CheckMemoryLeaks(); }
+}
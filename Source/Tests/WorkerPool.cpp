@@ -0,0 +1,72 @@
+/*
+	Apokalypse3D - Fast and cache-friendly 3D game engine
+	Copyright (C) 2022-2024 Yuriy Zinchenko
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdint.h>
+#include <atomic>
+#include <doctest/doctest.h>
+#include "Core/WorkerPool.h"
+
+using A3D::WorkerPool;
+
+struct Counters
+{
+	std::atomic<uint32_t> calls[1000];
+};
+
+static void CountTask(void* data, uint32_t task)
+{
+	static_cast<Counters*>(data)->calls[task].fetch_add(1, std::memory_order_relaxed);
+}
+
+TEST_SUITE("Worker Pool")
+{
+	TEST_CASE("Every task once")
+	{
+		WorkerPool pool(3);
+		REQUIRE(pool.GetThreadsCount() == 4);
+
+		Counters counters = {};
+		for (uint32_t run = 0; run < 50; ++run)
+			pool.Run(1000, &CountTask, &counters);
+
+		for (uint32_t i = 0; i < 1000; ++i)
+			REQUIRE(counters.calls[i].load() == 50);
+	}
+
+	TEST_CASE("Few tasks")
+	{
+		WorkerPool pool(3);
+		Counters counters = {};
+		pool.Run(0, &CountTask, &counters);
+		pool.Run(1, &CountTask, &counters);
+		pool.Run(2, &CountTask, &counters);
+		REQUIRE(counters.calls[0].load() == 2);
+		REQUIRE(counters.calls[1].load() == 1);
+		REQUIRE(counters.calls[2].load() == 0);
+	}
+
+	TEST_CASE("Single worker")
+	{
+		WorkerPool pool(1);
+		Counters counters = {};
+		pool.Run(100, &CountTask, &counters);
+		for (uint32_t i = 0; i < 100; ++i)
+			REQUIRE(counters.calls[i].load() == 1);
+	}
+}